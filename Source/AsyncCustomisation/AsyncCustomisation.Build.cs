@@ -29,6 +29,17 @@ public class AsyncCustomisation : ModuleRules
 			"SlateCore",
 			"ModelViewViewModel"
 		});
+
+		if (Target.bBuildEditor)
+		{
+			// Pre-bake commandlet saves merged meshes as regular assets
+			PrivateDependencyModuleNames.AddRange(new string[]
+			{
+				"AnimationCore",
+				"MeshDescription",
+				"SkeletalMeshDescription"
+			});
+		}
 		//PrivateDependencyModuleNames.AddRange(new string[] {"UMG", "CommonUI", "ModelViewViewModelPreview", "ModelViewViewModel" });
 		// Uncomment if you are using Slate UI 
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
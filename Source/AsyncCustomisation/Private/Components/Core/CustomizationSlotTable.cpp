@@ -0,0 +1,278 @@
+#include "Components/Core/CustomizationSlotTable.h"
+
+#include "GameplayTagsManager.h"
+#include "Algo/BinarySearch.h"
+#include "Components/Core/CustomizationTypes.h"
+#include "Components/Core/Assets/SlotMappingAsset.h"
+
+namespace CustomizationSlots
+{
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_Slot, "Slot", "Root tag for all customization slots.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_Slot_Item_BodySkin, "Slot.Item.BodySkin", "Reserved technical slot for the main body skin mesh.");
+
+	namespace Private
+	{
+		// Game thread only, like the contexts stamped with it
+		uint32 NextBaseStamp = 1;
+
+		FSlotMask GetSlotBit(int32 SlotIndex)
+		{
+			return FSlotMask(1) << SlotIndex;
+		}
+
+		template <typename ValueType>
+		FSlotMask DiffSlots(const TStaticArray<ValueType, MaxSlots>& Values, FSlotMask Mask, const TStaticArray<ValueType, MaxSlots>& OtherValues, FSlotMask OtherMask,
+			FSlotMask CandidateSlots)
+		{
+			FSlotMask Changed = (Mask ^ OtherMask) & CandidateSlots;
+			ForEachSlot(Mask & OtherMask & CandidateSlots, [&](int32 SlotIndex)
+			{
+				if (Values[SlotIndex] != OtherValues[SlotIndex])
+				{
+					Changed |= GetSlotBit(SlotIndex);
+				}
+			});
+			return Changed;
+		}
+	}
+
+	const FSlotTable& FSlotTable::Get()
+	{
+		static const FSlotTable SlotTable = []()
+		{
+			FSlotTable Table;
+			Table.Build();
+			return Table;
+		}();
+		return SlotTable;
+	}
+
+	void FSlotTable::Build()
+	{
+		const FGameplayTagContainer Children = UGameplayTagsManager::Get().RequestGameplayTagChildren(TAG_Slot);
+		for (const FGameplayTag& SlotTag : Children)
+		{
+			if (SlotTags.Num() == MaxSlots)
+			{
+				UE_LOG(LogTemp, Error, TEXT("FSlotTable::Build - More than %d slot tags, %s and the rest are cleared through slot mappings."), MaxSlots, *SlotTag.ToString());
+				break;
+			}
+			SlotTagToIndex.Add(SlotTag, SlotTags.Add(SlotTag));
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("FSlotTable::Build - Compiled %d slot tags."), SlotTags.Num());
+	}
+
+	int32 FSlotTable::GetSlotIndex(const FGameplayTag& SlotTag) const
+	{
+		const int32* SlotIndex = SlotTagToIndex.Find(SlotTag);
+		return SlotIndex ? *SlotIndex : INDEX_NONE;
+	}
+
+	FSlotMappingMasks FSlotTable::CompileSlotMapping(const USlotMappingAsset* SlotMapping, FSlotMask& OutIncompleteUISlots) const
+	{
+		FSlotMappingMasks Masks(InPlace, 0);
+		OutIncompleteUISlots = 0;
+		if (!SlotMapping)
+		{
+			return Masks;
+		}
+
+		for (const auto& Pair : SlotMapping->UISlotToTechnicalSlots)
+		{
+			const int32 UISlotIndex = GetSlotIndex(Pair.Key);
+			if (UISlotIndex == INDEX_NONE)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FSlotTable::CompileSlotMapping - UI slot %s is not in the slot table."), *Pair.Key.ToString());
+				continue;
+			}
+
+			for (const FGameplayTag& TechnicalSlot : Pair.Value)
+			{
+				const int32 TechnicalSlotIndex = GetSlotIndex(TechnicalSlot);
+				if (TechnicalSlotIndex != INDEX_NONE)
+				{
+					Masks[UISlotIndex] |= FSlotMask(1) << TechnicalSlotIndex;
+				}
+				else
+				{
+					UE_LOG(LogTemp, Warning, TEXT("FSlotTable::CompileSlotMapping - Technical slot %s of UI slot %s is not in the slot table, the UI slot clears through the mapping."),
+						*TechnicalSlot.ToString(), *Pair.Key.ToString());
+					OutIncompleteUISlots |= FSlotMask(1) << UISlotIndex;
+				}
+			}
+		}
+		return Masks;
+	}
+
+	void FSlotState::Compile(const FCustomizationContextData& Context)
+	{
+		*this = FSlotState();
+		for (const auto& Pair : Context.EquippedBodyPartsItems)
+		{
+			SetBodyPart(Pair.Key, Pair.Value);
+		}
+		for (const auto& Pair : Context.EquippedMaterialsMap)
+		{
+			SetMaterial(Pair.Key, Pair.Value);
+		}
+		for (const auto& Pair : Context.EquippedCustomizationItemActors)
+		{
+			AddActorSlot(Pair.Key);
+			for (const FEquippedItemActorsInfo& ActorInfo : Pair.Value.EquippedItemActors)
+			{
+				AddActorItem(Pair.Key, ActorInfo.Item);
+			}
+		}
+		DirtyMask = 0;
+		bSynced = true;
+	}
+
+	void FSlotState::ClearDirty()
+	{
+		DirtyMask = 0;
+		BaseStamp = Private::NextBaseStamp++;
+	}
+
+	int32 FSlotState::IndexSlot(const FGameplayTag& SlotTag)
+	{
+		const int32 SlotIndex = FSlotTable::Get().GetSlotIndex(SlotTag);
+		bHasUnindexedSlots |= SlotIndex == INDEX_NONE;
+		if (SlotIndex != INDEX_NONE)
+		{
+			DirtyMask |= Private::GetSlotBit(SlotIndex);
+		}
+		return SlotIndex;
+	}
+
+	void FSlotState::SetBodyPart(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			BodyParts[SlotIndex] = Item;
+			BodyPartMask |= Private::GetSlotBit(SlotIndex);
+		}
+	}
+
+	void FSlotState::SetMaterial(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			Materials[SlotIndex] = Item;
+			MaterialMask |= Private::GetSlotBit(SlotIndex);
+		}
+	}
+
+	void FSlotState::AddActorItem(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex == INDEX_NONE)
+		{
+			return;
+		}
+
+		TArray<FCustomizationItemHandle, TInlineAllocator<2>>& Items = ActorItems[SlotIndex];
+		const int32 InsertIndex = Algo::LowerBound(Items, Item);
+		if (!Items.IsValidIndex(InsertIndex) || Items[InsertIndex] != Item)
+		{
+			Items.Insert(Item, InsertIndex);
+		}
+		ActorMask |= Private::GetSlotBit(SlotIndex);
+	}
+
+	void FSlotState::RemoveActorItem(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			ActorItems[SlotIndex].Remove(Item);
+		}
+	}
+
+	void FSlotState::AddActorSlot(const FGameplayTag& SlotTag)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			ActorMask |= Private::GetSlotBit(SlotIndex);
+		}
+	}
+
+	void FSlotState::RemoveBodyPart(const FGameplayTag& SlotTag)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			BodyParts[SlotIndex] = FCustomizationItemHandle();
+			BodyPartMask &= ~Private::GetSlotBit(SlotIndex);
+		}
+	}
+
+	void FSlotState::RemoveMaterial(const FGameplayTag& SlotTag)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			Materials[SlotIndex] = FCustomizationItemHandle();
+			MaterialMask &= ~Private::GetSlotBit(SlotIndex);
+		}
+	}
+
+	void FSlotState::RemoveActorSlot(const FGameplayTag& SlotTag)
+	{
+		const int32 SlotIndex = IndexSlot(SlotTag);
+		if (SlotIndex != INDEX_NONE)
+		{
+			ActorItems[SlotIndex].Reset();
+			ActorMask &= ~Private::GetSlotBit(SlotIndex);
+		}
+	}
+
+	void FSlotState::RemoveAllActorSlots()
+	{
+		ForEachSlot(ActorMask, [this](int32 SlotIndex) { ActorItems[SlotIndex].Reset(); });
+		DirtyMask |= ActorMask;
+		ActorMask = 0;
+	}
+
+	void FSlotState::RemoveAllBodyParts()
+	{
+		ForEachSlot(BodyPartMask, [this](int32 SlotIndex) { BodyParts[SlotIndex] = FCustomizationItemHandle(); });
+		DirtyMask |= BodyPartMask;
+		BodyPartMask = 0;
+	}
+
+	void FSlotState::RemoveAllMaterials()
+	{
+		ForEachSlot(MaterialMask, [this](int32 SlotIndex) { Materials[SlotIndex] = FCustomizationItemHandle(); });
+		DirtyMask |= MaterialMask;
+		MaterialMask = 0;
+	}
+
+	FSlotMask FSlotState::GetCandidateSlots(const FSlotState& Other) const
+	{
+		return BaseStamp != 0 && BaseStamp == Other.BaseStamp ? DirtyMask | Other.DirtyMask : ~FSlotMask(0);
+	}
+
+	FSlotMask FSlotState::DiffBodyParts(const FSlotState& Other) const
+	{
+		return Private::DiffSlots(BodyParts, BodyPartMask, Other.BodyParts, Other.BodyPartMask, GetCandidateSlots(Other));
+	}
+
+	FSlotMask FSlotState::DiffMaterials(const FSlotState& Other) const
+	{
+		return Private::DiffSlots(Materials, MaterialMask, Other.Materials, Other.MaterialMask, GetCandidateSlots(Other));
+	}
+
+	FSlotMask FSlotState::DiffActors(const FSlotState& Other) const
+	{
+		return Private::DiffSlots(ActorItems, ActorMask, Other.ActorItems, Other.ActorMask, GetCandidateSlots(Other));
+	}
+
+	bool FSlotState::EqualSlots(const FSlotState& Other) const
+	{
+		return DiffBodyParts(Other) == 0 && DiffMaterials(Other) == 0 && DiffActors(Other) == 0;
+	}
+} // namespace CustomizationSlots
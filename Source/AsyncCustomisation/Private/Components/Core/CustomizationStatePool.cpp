@@ -0,0 +1,184 @@
+#include "Components/Core/CustomizationStatePool.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Components/Core/CustomizationTypes.h"
+
+DEFINE_LOG_CATEGORY(LogCustomizationStatePool);
+
+class FInternedCustomizationState
+{
+public:
+	FInternedCustomizationState(const FCustomizationContextData& InState, uint32 InHash)
+		: State(InState)
+		, Hash(InHash)
+	{
+		// Actors belong to the character that spawned them, the loadout only keeps their items
+		for (auto& SlotPair : State.EquippedCustomizationItemActors)
+		{
+			for (FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors)
+			{
+				ActorInfo.ItemRelatedActors.Empty();
+			}
+		}
+	}
+
+	const FCustomizationContextData& Get() const { return State; }
+	uint32 GetHash() const { return Hash; }
+
+private:
+	FCustomizationContextData State;
+	uint32 Hash = 0;
+};
+
+namespace CustomizationStatePool
+{
+	namespace Private
+	{
+		// Pairs are summed, map iteration order depends on insertion and equal loadouts must hash equal
+		uint32 HashPairs(const TMap<FGameplayTag, FCustomizationItemHandle>& Map)
+		{
+			uint32 PairsHash = 0;
+			for (const auto& Pair : Map)
+			{
+				PairsHash += HashCombineFast(GetTypeHash(Pair.Key), GetTypeHash(Pair.Value));
+			}
+			return PairsHash;
+		}
+
+		// Intern calls between sweeps of expired states
+		constexpr int32 CompactInterval = 256;
+	}
+}
+
+const FCustomizationContextData& FCustomizationStateHandle::Get() const
+{
+	static const FCustomizationContextData EmptyState;
+	return State.IsValid() ? State->Get() : EmptyState;
+}
+
+FCustomizationStatePool& FCustomizationStatePool::Get()
+{
+	static FCustomizationStatePool Pool;
+	return Pool;
+}
+
+FCustomizationStateHandle FCustomizationStatePool::Intern(const FCustomizationContextData& State)
+{
+	check(IsInGameThread());
+
+	if (++NumInternCalls % CustomizationStatePool::Private::CompactInterval == 0)
+	{
+		Compact();
+	}
+
+	FCustomizationStateHandle Handle;
+	Handle.Hash = HashLoadout(State);
+
+	// 1. Equal loadout already interned, hash collisions are settled by a full compare
+	TArray<TWeakPtr<const FInternedCustomizationState>*, TInlineAllocator<2>> Candidates;
+	States.MultiFindPointer(Handle.Hash, Candidates);
+	for (TWeakPtr<const FInternedCustomizationState>* Candidate : Candidates)
+	{
+		TSharedPtr<const FInternedCustomizationState> Interned = Candidate->Pin();
+		if (Interned.IsValid() && Interned->Get() == State)
+		{
+			++NumReused;
+			Handle.State = MoveTemp(Interned);
+			return Handle;
+		}
+	}
+
+	// 2. New loadout
+	TSharedRef<const FInternedCustomizationState> Interned = MakeShared<const FInternedCustomizationState>(State, Handle.Hash);
+	States.Add(Handle.Hash, Interned);
+	Handle.State = MoveTemp(Interned);
+	return Handle;
+}
+
+int32 FCustomizationStatePool::GetNumStates() const
+{
+	int32 NumStates = 0;
+	for (const auto& Pair : States)
+	{
+		NumStates += Pair.Value.IsValid() ? 1 : 0;
+	}
+	return NumStates;
+}
+
+void FCustomizationStatePool::Compact()
+{
+	for (auto It = States.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+uint32 FCustomizationStatePool::HashLoadout(const FCustomizationContextData& State)
+{
+	uint32 Hash = GetTypeHash(State.Somatotype);
+	Hash = HashCombineFast(Hash, CustomizationStatePool::Private::HashPairs(State.EquippedBodyPartsItems));
+	Hash = HashCombineFast(Hash, CustomizationStatePool::Private::HashPairs(State.EquippedMaterialsMap));
+
+	uint32 ActorsHash = 0;
+	for (const auto& SlotPair : State.EquippedCustomizationItemActors)
+	{
+		for (const FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors)
+		{
+			ActorsHash += HashCombineFast(GetTypeHash(SlotPair.Key), GetTypeHash(ActorInfo.Item));
+		}
+	}
+	Hash = HashCombineFast(Hash, ActorsHash);
+	Hash = HashCombineFast(Hash, GetTypeHash(State.SkinVisibilityFlags.FlagMask));
+	return HashCombineFast(Hash, GetTypeHash(State.VFXCustomization.CustomMaterial.ToSoftObjectPath()));
+}
+
+SIZE_T FCustomizationStatePool::GetAllocatedSize(const FCustomizationContextData& State)
+{
+	SIZE_T Size = State.EquippedBodyPartsItems.GetAllocatedSize() + State.EquippedMaterialsMap.GetAllocatedSize()
+		+ State.EquippedCustomizationItemActors.GetAllocatedSize() + State.SkinVisibilityFlags.FlagDescription.GetAllocatedSize();
+	for (const auto& SlotPair : State.EquippedCustomizationItemActors)
+	{
+		Size += SlotPair.Value.EquippedItemActors.GetAllocatedSize();
+		for (const FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors)
+		{
+			Size += ActorInfo.ItemRelatedActors.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
+
+void FCustomizationStatePool::LogStats() const
+{
+	int32 NumStates = 0;
+	int32 NumHolders = 0;
+	SIZE_T StatesBytes = 0;
+
+	for (const auto& Pair : States)
+	{
+		const TSharedPtr<const FInternedCustomizationState> Interned = Pair.Value.Pin();
+		if (!Interned.IsValid())
+		{
+			continue;
+		}
+
+		// Pin above holds one reference
+		NumHolders += Interned.GetSharedReferenceCount() - 1;
+		StatesBytes += sizeof(FInternedCustomizationState) + GetAllocatedSize(Interned->Get());
+		++NumStates;
+	}
+
+	UE_LOG(LogCustomizationStatePool, Display, TEXT("FCustomizationStatePool::LogStats - %d states held by %d handles, %d of %d interns reused a state, %llu B in live states."),
+		NumStates, NumHolders, NumReused, NumInternCalls, static_cast<uint64>(StatesBytes));
+}
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommand CustomizationStateStatsCommand(
+	TEXT("Customization.StateStats"),
+	TEXT("Logs interned customization states: live states, their holders, reused interns and memory."),
+	FConsoleCommandDelegate::CreateLambda([]() { FCustomizationStatePool::Get().LogStats(); }));
+
+#endif
@@ -42,7 +42,7 @@ void CustomizationUtilities::SetSkeletalMesh(
 	}
 
 	const USkeletalMesh* CurrentTargetMesh = TargetSkeletalMeshComponent->GetSkeletalMeshAsset();
-	const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+	const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 
 	if (CurrentTargetMesh != SourceSkeletalMesh)
 	{
@@ -8,10 +8,15 @@
 #include "Components/Core/CustomizationItemBase.h"
 #include "Components/Core/Assets/SlotMappingAsset.h"
 #include "Components/Core/Assets/SomatotypeDataAsset.h"
+#include "Engine/StreamableManager.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Rendering/SkeletalMeshRenderData.h"
 #include "Utilities/CustomizationSettings.h"
 #include "Utilities/MetaGameLib.h"
+#include "Utilities/MeshMerger/MergedMeshLayoutUserData.h"
+#include "Utilities/MeshMerger/MeshMergeSpeculationSubsystem.h"
 #include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
 
 
 DEFINE_LOG_CATEGORY(LogCustomizationComponent);
@@ -31,91 +36,121 @@ void UCustomizationComponent::UpdateFromOwning()
 	}
 
 	CurrentCustomizationState.Somatotype = OwningCharacter->Somatotype;
+	InternCurrentLoadout();
 	// TODO:: think about it. Where we get info about somatotype? Maybe: recomend user to create meta data with it by himself
 
-	FCustomizationContextData TargetState = CurrentCustomizationState;
+	// Equips still being collapsed are part of the target, the immediate call takes their burst over
+	FCustomizationContextData TargetState = GetLatestTargetState();
+	TargetState.Somatotype = OwningCharacter->Somatotype;
 	Invalidate(TargetState, false, ECustomizationInvalidationReason::All);
 }
 
 void UCustomizationComponent::EquipItem(const FName& ItemSlug)
 {
 	if (ItemSlug == NAME_None) return;
+
+	EquipItem(FindItemHandle(ItemSlug));
+}
+
+void UCustomizationComponent::EquipItems(const TArray<FName>& Items)
+{
+	TArray<FCustomizationItemHandle> ItemHandles;
+	ItemHandles.Reserve(Items.Num());
+	for (const FName& ItemSlug : Items)
+	{
+		if (const FCustomizationItemHandle ItemHandle = FindItemHandle(ItemSlug); ItemHandle.IsValid())
+		{
+			ItemHandles.Add(ItemHandle);
+		}
+	}
+	EquipItems(ItemHandles);
+}
+
+void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
+{
+	if (ItemSlug == NAME_None) return;
+
+	UnequipItem(FindItemHandle(ItemSlug));
+}
+
+FCustomizationItemHandle UCustomizationComponent::FindItemHandle(const FName& ItemSlug) const
+{
+	const FCustomizationItemHandle ItemHandle = FCustomizationItemRegistry::Get().FindHandle(ItemSlug);
+	UE_CLOG(!ItemHandle.IsValid() && ItemSlug != NAME_None, LogCustomizationComponent, Warning, TEXT("FindItemHandle: Item %s is not registered."), *ItemSlug.ToString());
+	return ItemHandle;
+}
+
+void UCustomizationComponent::EquipItem(FCustomizationItemHandle ItemHandle)
+{
+	if (!ItemHandle.IsValid()) return;
 	
-	LoadSlotMappingAndExecute([this, ItemSlug]()
+	LoadSlotMappingAndExecute([this, ItemHandle]()
 	{
-		FCustomizationContextData TargetState = CurrentCustomizationState;
-		AddItemToTargetState(ItemSlug, TargetState);
-		Invalidate(TargetState, false);
+		FCustomizationContextData TargetState = GetLatestTargetState();
+		AddItemToTargetState(ItemHandle, TargetState);
+		Invalidate(TargetState);
 	});
 }
 
-void UCustomizationComponent::EquipItems(const TArray<FName>& Items)
+void UCustomizationComponent::EquipItems(const TArray<FCustomizationItemHandle>& ItemHandles)
 {
-	if (Items.IsEmpty()) return;
+	if (ItemHandles.IsEmpty()) return;
 
-	LoadSlotMappingAndExecute([this, Items]()
+	LoadSlotMappingAndExecute([this, ItemHandles]()
 	{
-		FCustomizationContextData TargetState = CurrentCustomizationState;
+		FCustomizationContextData TargetState = GetLatestTargetState();
 		bool bStateChanged = false;
 
-		for (const FName& ItemSlug : Items)
+		for (const FCustomizationItemHandle& ItemHandle : ItemHandles)
 		{
-			AddItemToTargetState(ItemSlug, TargetState);
+			AddItemToTargetState(ItemHandle, TargetState);
 			bStateChanged = true;
 		}
         
 		if (bStateChanged)
 		{
-			Invalidate(TargetState, false);
+			Invalidate(TargetState);
 		}
 	});
 }
 
-void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
+void UCustomizationComponent::UnequipItem(FCustomizationItemHandle ItemHandle)
 {
-	if (ItemSlug == NAME_None) return;
+	const FCustomizationItemInfo* ItemInfo = FCustomizationItemRegistry::Get().Find(ItemHandle);
+	if (!ItemInfo) return;
 
-	const FPrimaryAssetId ItemCustomizationAssetId = CommonUtilities::ItemSlugToCustomizationAssetId(ItemSlug);
+	const FPrimaryAssetId ItemCustomizationAssetId = CommonUtilities::ItemHandleToCustomizationAssetId(ItemHandle);
 	if (!ItemCustomizationAssetId.IsValid()) return;
 	const auto CustomizationAssetClass = CustomizationUtilities::GetClassForCustomizationAsset(ItemCustomizationAssetId);
 	if (!CustomizationAssetClass) return;
 	
 	//	Copy and then modify TargetState and then Invalidate
-	// 1. Copy Current state
-	FCustomizationContextData TargetState = CurrentCustomizationState;
+	// 1. Copy latest state, a burst being collapsed builds on its deferred one
+	FCustomizationContextData TargetState = GetLatestTargetState();
 	bool bStateChanged = false;
 
 	// 2. 
 	if (CustomizationAssetClass->IsChildOf(UCustomizationDataAsset::StaticClass()))
 	{
-		const CustomizationSlots::FItemRegistryData ItemData = CustomizationSlots::GetItemDataFromRegistry(ItemSlug);
-		if (!ItemData.IsValid())
+		const FGameplayTag SlotTag = ItemInfo->UISlotCategoryTag;
+		if (!SlotTag.IsValid())
 		{
-			UE_LOG(LogCustomizationComponent, Warning, TEXT("UnequipItem: Could not get valid item data from registry for slug %s. Aborting actor unequip."), *ItemSlug.ToString());
+			UE_LOG(LogCustomizationComponent, Warning, TEXT("UnequipItem: Item %s has no UI slot in the registry. Aborting actor unequip."), *ItemInfo->Slug.ToString());
 			return;
 		}
-		const FGameplayTag SlotTag = ItemData.InUISlotCategoryTag;
 		if (OnlyOneItemInSlot)
 		{
 			if (const FEquippedItemsInSlotInfo* SlotInfo = TargetState.EquippedCustomizationItemActors.Find(SlotTag))
 			{
-				if (SlotInfo->EquippedItemActors.Num() > 0 && SlotInfo->EquippedItemActors[0].ItemSlug == ItemSlug)
+				if (SlotInfo->EquippedItemActors.Num() > 0 && SlotInfo->EquippedItemActors[0].Item == ItemHandle)
 				{
-					if (TargetState.EquippedCustomizationItemActors.Remove(SlotTag) > 0) bStateChanged = true;
+					if (TargetState.RemoveActorSlot(SlotTag)) bStateChanged = true;
 				}
 			}
 		}
-		else if (FEquippedItemsInSlotInfo* EquippedItemsInSlotInfo = TargetState.EquippedCustomizationItemActors.Find(SlotTag))
+		else if (TargetState.RemoveActorItem(SlotTag, ItemHandle))
 		{
-			int32 RemovedCount = EquippedItemsInSlotInfo->EquippedItemActors.RemoveAll(
-				[&ItemSlug](const FEquippedItemActorsInfo& EquippedItemActorsInfo) { return EquippedItemActorsInfo.ItemSlug == ItemSlug; });
-
-			if (RemovedCount > 0) bStateChanged = true;
-
-			if (EquippedItemsInSlotInfo->EquippedItemActors.IsEmpty())
-			{
-				if (TargetState.EquippedCustomizationItemActors.Remove(SlotTag) > 0) bStateChanged = true;
-			}
+			bStateChanged = true;
 		}
 	}
 	else if (CustomizationAssetClass->IsChildOf(UMaterialCustomizationDataAsset::StaticClass()) || CustomizationAssetClass->IsChildOf(UMaterialPackCustomizationDA::StaticClass()))
@@ -123,7 +158,7 @@ void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
 		FGameplayTag SlotForMaterial;
 		for (auto& Elem : TargetState.EquippedMaterialsMap)
 		{
-			if (Elem.Value == ItemSlug)
+			if (Elem.Value == ItemHandle)
 			{
 				SlotForMaterial = Elem.Key;
 				break;
@@ -132,7 +167,7 @@ void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
 
 		if (SlotForMaterial.IsValid())
 		{
-			TargetState.EquippedMaterialsMap.Remove(SlotForMaterial);
+			TargetState.RemoveMaterial(SlotForMaterial);
 			bStateChanged = true;
 		}
 	}
@@ -141,7 +176,7 @@ void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
 		FGameplayTag SlotTagOfItemToRemove;
 
 		// Find the slot tag of the item being unequipped
-		const FGameplayTag* FoundTag = CurrentCustomizationState.EquippedBodyPartsItems.FindKey(ItemSlug);
+		const FGameplayTag* FoundTag = TargetState.EquippedBodyPartsItems.FindKey(ItemHandle);
 		if (FoundTag)
 		{
 			SlotTagOfItemToRemove = *FoundTag;
@@ -149,15 +184,15 @@ void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
 		
 		if (SlotTagOfItemToRemove.IsValid())
 		{
-			TargetState.EquippedBodyPartsItems.Remove(SlotTagOfItemToRemove);
+			TargetState.RemoveBodyPart(SlotTagOfItemToRemove);
 			bStateChanged = true;
-			UE_LOG(LogCustomizationComponent, Log, TEXT("UnequipItem: Removed BodyPart item '%s' from slot '%s'."), *ItemSlug.ToString(), *SlotTagOfItemToRemove.ToString());
+			UE_LOG(LogCustomizationComponent, Log, TEXT("UnequipItem: Removed BodyPart item '%s' from slot '%s'."), *ItemInfo->Slug.ToString(), *SlotTagOfItemToRemove.ToString());
 
 			// If a material is applied to the same slot, it's a skin for our item. Remove it.
-			if (TargetState.EquippedMaterialsMap.Contains(SlotTagOfItemToRemove))
+			FCustomizationItemHandle MaterialItem;
+			if (TargetState.RemoveMaterial(SlotTagOfItemToRemove, &MaterialItem))
 			{
-				FName MaterialSlug = TargetState.EquippedMaterialsMap.FindAndRemoveChecked(SlotTagOfItemToRemove);
-				UE_LOG(LogCustomizationComponent, Log, TEXT("UnequipItem: Automatically removing associated skin '%s' from slot %s."), *MaterialSlug.ToString(), *SlotTagOfItemToRemove.ToString());
+				UE_LOG(LogCustomizationComponent, Log, TEXT("UnequipItem: Automatically removing associated skin '%s' from slot %s."), *MaterialItem.ToString(), *SlotTagOfItemToRemove.ToString());
 				bStateChanged = true;
 			}
 		}
@@ -166,7 +201,7 @@ void UCustomizationComponent::UnequipItem(const FName& ItemSlug)
 	// 3.
 	if (bStateChanged)
 	{
-		Invalidate(TargetState, false);
+		Invalidate(TargetState);
 	}
 }
 
@@ -185,6 +220,7 @@ void UCustomizationComponent::ResetAll()
 	{
 		CurrentCustomizationState.Somatotype = OwningCharacter->Somatotype;
 	}
+	InternCurrentLoadout();
 
 	InvalidationContext.ClearAll();
 	Invalidate(CurrentCustomizationState, false, ECustomizationInvalidationReason::All);
@@ -194,12 +230,16 @@ void UCustomizationComponent::HardRefreshAll()
 {
 	switch (UCustomizationSettings::Get()->GetMeshMergeMethod())
 	{
+	case EMeshMergeMethod::AsyncMeshMerge:
 	case EMeshMergeMethod::SyncMeshMerge:
 		{
-			// Only reset the main mesh, do not touch SpawnedMeshComponents
+			// Only reset the main mesh and followers bridging a pending merge, do not touch other SpawnedMeshComponents
+			TearDownMergeBridge();
+			ShownMeshesToMergeData.Empty();
+			ShownMaterialMap.Empty();
 			if (OwningCharacter.IsValid() && OwningCharacter->GetMesh())
 			{
-				OwningCharacter->GetMesh()->SetSkeletalMeshAsset(nullptr);
+				SetShownMergedMesh(nullptr);
 				// Optionally clear materials if needed
 				for (int32 i = 0; i < OwningCharacter->GetMesh()->GetNumMaterials(); ++i)
 				{
@@ -267,12 +307,19 @@ void UCustomizationComponent::Invalidate(const FCustomizationContextData& Target
                                          const bool bDeffer,
                                          ECustomizationInvalidationReason ExplicitReason)
 {
+	++NumInvalidationRequests;
+
 	/*
 	 * In deffer variant we should call invalidate only once on next tick
 	 * This can help avoid multiple invalidation calls while change many properties
 	 */
 	if (bDeffer)
 	{
+		if (TryInvalidateLeadingEdge(TargetState, ExplicitReason))
+		{
+			return;
+		}
+
 		if (DeferredTargetState.IsSet() && DeferredTargetState.GetValue() == TargetState)
 		{
 			ECustomizationInvalidationReason OldDefferReason = DeferredReason;
@@ -316,7 +363,41 @@ void UCustomizationComponent::Invalidate(const FCustomizationContextData& Target
 		return;
 	}
 
+	// Immediate request replaces a burst being collapsed
+	if (InvalidationTimer.IsValid())
+	{
+		InvalidationTimer->Stop();
+	}
+	if (DeferredTargetState.IsSet())
+	{
+		EnumAddFlags(ExplicitReason, DeferredReason);
+		DeferredTargetState.Reset();
+		DeferredReason = ECustomizationInvalidationReason::None;
+	}
+	InvalidateImmediate(TargetState, ExplicitReason);
+}
+
+const FCustomizationContextData& UCustomizationComponent::GetLatestTargetState() const
+{
+	return DeferredTargetState.IsSet() ? DeferredTargetState.GetValue() : CurrentCustomizationState;
+}
+
+void UCustomizationComponent::InvalidateImmediate(const FCustomizationContextData& TargetState, ECustomizationInvalidationReason ExplicitReason)
+{
 	UE_LOG(LogCustomizationComponent, Log, TEXT("Invalidate: Starting IMMEDIATE invalidation (called with bDeffer=false)."));
+
+	// 0. Supersede the pipeline in flight, only the newest state is loaded and applied
+	ECustomizationInvalidationReason SupersededReason = ECustomizationInvalidationReason::None;
+	if (PendingInvalidationCounter.IsPending())
+	{
+		SupersededReason = InFlightInvalidationReason;
+		UE_LOG(LogCustomizationComponent, Log, TEXT("Invalidate: Superseding pipeline %u in flight (Reason: %s)."), InvalidationGeneration,
+		       *StaticEnum<ECustomizationInvalidationReason>()->GetNameStringByValue(static_cast<int64>(SupersededReason)));
+		CancelInFlightInvalidation();
+		DestroySupersededActors();
+	}
+	++InvalidationGeneration;
+
 	ProcessingTargetState = TargetState;
 
 	// 1. Get diff (CurrentCustomizationState) and (TargetState)
@@ -336,6 +417,7 @@ void UCustomizationComponent::Invalidate(const FCustomizationContextData& Target
 
 	ECustomizationInvalidationReason CombinedReason = ExplicitReason;
 	EnumAddFlags(CombinedReason, CalculatedReasonFromDiff);
+	EnumAddFlags(CombinedReason, SupersededReason);
 
 	// 2. Calculate final reason
 	// if (CombinedReason == ECustomizationInvalidationReason::None)
@@ -346,8 +428,7 @@ void UCustomizationComponent::Invalidate(const FCustomizationContextData& Target
 		if (CurrentCustomizationState != ProcessingTargetState)
 		{
 			UE_LOG(LogCustomizationComponent, Verbose, TEXT("Invalidate: Updating CurrentCustomizationState to ProcessingTargetState as CombinedReason is None, but states differ."));
-			CurrentCustomizationState = ProcessingTargetState;
-			OnEquippedItemsChanged.Broadcast(CurrentCustomizationState);
+			CommitProcessingTargetState();
 		}
 		else
 		{
@@ -385,8 +466,7 @@ void UCustomizationComponent::Invalidate(const FCustomizationContextData& Target
 
         if (CurrentCustomizationState != ProcessingTargetState)
         {
-            CurrentCustomizationState = ProcessingTargetState;
-            OnEquippedItemsChanged.Broadcast(CurrentCustomizationState);
+            CommitProcessingTargetState();
         }
         if (OwningCharacter.IsValid())
         {
@@ -402,6 +482,14 @@ void UCustomizationComponent::Invalidate(const FCustomizationContextData& Target
     {
         PendingInvalidationCounter.Push();
     }
+    InFlightInvalidationReason = CombinedReason;
+    ++NumInvalidationPipelinesRun;
+    if (EnumHasAnyFlags(CombinedReason, ECustomizationInvalidationReason::Body))
+    {
+        // Queued merge of an older body state won't be shown, a running one is dropped on completion
+        ++MergeGeneration;
+        UMeshMergeSubsystem::CancelMergeRequest(GetWorld(), this);
+    }
     UE_LOG(LogCustomizationComponent, Log, TEXT("Invalidate: Pushed main counter %d times for active invalidation steps."), InvalidationStepsLaunched);
 	
 	// 3. Execute invalidation steps.
@@ -443,7 +531,7 @@ void UCustomizationComponent::LoadAndCacheBodySkinMaterial(const FPrimaryAssetId
 	FPrimaryAssetType AssetType = SkinMaterialAssetId.PrimaryAssetType;
     UE_LOG(LogCustomizationComponent, Log, TEXT("LoadAndCacheBodySkinMaterial: Attempting to load %s for Somatotype %s."), *SkinMaterialAssetId.ToString(), *UEnum::GetValueAsString(ForSomatotype));
 
-    const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+    const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 
     if (AssetType.GetName() == GLOBAL_CONSTANTS::PrimaryMaterialCustomizationAssetType)
     {
@@ -541,7 +629,7 @@ void UCustomizationComponent::LoadAndCacheBodySkinMaterial(const FPrimaryAssetId
 
 void UCustomizationComponent::ApplyCachedMaterialToBodySkinMesh()
 {
-	const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+	const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 	TObjectPtr<USkeletalMeshComponent> BodySkinMeshCompPtr = SpawnedMeshComponents.FindRef(BodySkinSlotTag);
 	
 	if (USkeletalMeshComponent* BodySkinMeshComp = BodySkinMeshCompPtr.Get())
@@ -568,7 +656,7 @@ void UCustomizationComponent::ApplyCachedMaterialToBodySkinMesh()
 
 void UCustomizationComponent::ApplyFallbackMaterialToBodySkinMesh()
 {
-	const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+	const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 	TObjectPtr<USkeletalMeshComponent> BodySkinMeshCompPtr = SpawnedMeshComponents.FindRef(BodySkinSlotTag);
 
 	if (USkeletalMeshComponent* BodySkinMeshComp = BodySkinMeshCompPtr.Get())
@@ -598,7 +686,8 @@ void UCustomizationComponent::ApplyFallbackMaterialToBodySkinMesh()
 
 void UCustomizationComponent::OnDefferInvalidationTimerExpired()
 {
-	UE_LOG(LogCustomizationComponent, Log, TEXT("Deferred invalidation timer expired."));
+	UE_LOG(LogCustomizationComponent, Log, TEXT("Deferred invalidation timer expired. %d invalidations requested, %d pipelines run so far."),
+	       NumInvalidationRequests, NumInvalidationPipelinesRun);
 	if (DeferredTargetState.IsSet())
 	{
 		FCustomizationContextData StateToInvalidate = DeferredTargetState.GetValue();
@@ -606,8 +695,7 @@ void UCustomizationComponent::OnDefferInvalidationTimerExpired()
 
 		DeferredTargetState.Reset();
 		DeferredReason = ECustomizationInvalidationReason::None;
-		Invalidate(StateToInvalidate, false, ReasonForInvalidation);
-		// Invalidate(DeferredTargetState.GetValue(), false, DefferReason);
+		InvalidateImmediate(StateToInvalidate, ReasonForInvalidation);
 	}
 	else
 	{
@@ -621,7 +709,7 @@ void UCustomizationComponent::InvalidateColoration(FCustomizationContextData& Ta
 	TArray<FPrimaryAssetId> MaterialAssetIdsToLoad;
 	for (const auto& Pair : TargetState.EquippedMaterialsMap)
 	{
-		FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(Pair.Value);
+		FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(Pair.Value);
 		if (AssetId.IsValid())
 		{
 			MaterialAssetIdsToLoad.AddUnique(AssetId);
@@ -636,6 +724,7 @@ void UCustomizationComponent::InvalidateColoration(FCustomizationContextData& Ta
 		return;
 	}
 
+	const uint32 Generation = InvalidationGeneration;
 	TSharedPtr<bool> bHasPoppedForThisStep = MakeShared<bool>(false);
 	auto FinalizeAndPopOnce = [this, bHasPoppedForThisStep](const FString& ReasonMessage) {
 		if (bHasPoppedForThisStep.IsValid() && !(*bHasPoppedForThisStep))
@@ -646,10 +735,15 @@ void UCustomizationComponent::InvalidateColoration(FCustomizationContextData& Ta
 		}
 	};
 
-	UCustomizationAssetManager::StaticAsyncLoadAssetList<UMaterialCustomizationDataAsset>(
+	TrackInvalidationLoad(UCustomizationAssetManager::StaticAsyncLoadAssetList<UMaterialCustomizationDataAsset>(
 		MaterialAssetIdsToLoad,
-		[this, FinalizeAndPopOnce](TArray<UMaterialCustomizationDataAsset*> LoadedAssets) mutable
+		[this, FinalizeAndPopOnce, Generation](TArray<UMaterialCustomizationDataAsset*> LoadedAssets) mutable
 		{
+			if (!IsInvalidationCurrent(Generation))
+			{
+				UE_LOG(LogCustomizationComponent, Verbose, TEXT("InvalidateColoration: Pipeline %u was superseded, skipping."), Generation);
+				return;
+			}
 			UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateColoration: Async load completed. Loaded %d material assets."), LoadedAssets.Num());
 			
 			TArray<UObject*> LoadedObjects;
@@ -663,7 +757,7 @@ void UCustomizationComponent::InvalidateColoration(FCustomizationContextData& Ta
 
 			FinalizeAndPopOnce(TEXT("Finished processing coloration."));
 		}
-	);
+	));
 }
 
 void UCustomizationComponent::InvalidateBodyParts(FCustomizationContextData& TargetState)
@@ -680,6 +774,7 @@ void UCustomizationComponent::InvalidateBodyParts(FCustomizationContextData& Tar
 	}
 
 	FCustomizationContextData TargetStateAtInvalidationStart = TargetState;
+	const uint32 Generation = InvalidationGeneration;
 	
 	TSharedPtr<bool> bHasPoppedForThisStep = MakeShared<bool>(false);
 
@@ -696,9 +791,14 @@ void UCustomizationComponent::InvalidateBodyParts(FCustomizationContextData& Tar
 		}
 	};
 	
-	UCustomizationAssetManager::GetCustomizationAssetManager()->AsyncLoadAsset<USomatotypeDataAsset>(SomatotypeAssetId,
-                 [this, CapturedTargetState = TargetStateAtInvalidationStart, FinalizeAndPopOnce](USomatotypeDataAsset* LoadedSomatotypeDataAsset)
+	TrackInvalidationLoad(UCustomizationAssetManager::GetCustomizationAssetManager()->AsyncLoadAsset<USomatotypeDataAsset>(SomatotypeAssetId,
+                 [this, CapturedTargetState = TargetStateAtInvalidationStart, FinalizeAndPopOnce, Generation](USomatotypeDataAsset* LoadedSomatotypeDataAsset)
                  {
+	                 if (!IsInvalidationCurrent(Generation))
+	                 {
+		                 UE_LOG(LogCustomizationComponent, Verbose, TEXT("InvalidateBodyParts: Pipeline %u was superseded, skipping somatotype."), Generation);
+		                 return;
+	                 }
 	                 if (!LoadedSomatotypeDataAsset)
 	                 {
 		                 FinalizeAndPopOnce(FString::Printf(TEXT("Failed to load SomatotypeDataAsset for %s."), *UEnum::GetValueAsString(CapturedTargetState.Somatotype)));
@@ -739,16 +839,21 @@ void UCustomizationComponent::InvalidateBodyParts(FCustomizationContextData& Tar
                      }
 
                      UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateBodyParts: Requesting async load for %d BodyPartAssets."), AllRelevantItemAssetIds.Num());
-                     UCustomizationAssetManager::StaticAsyncLoadAssetList<UBodyPartAsset>(
+                     TrackInvalidationLoad(UCustomizationAssetManager::StaticAsyncLoadAssetList<UBodyPartAsset>(
                          AllRelevantItemAssetIds,
-                         [this, LoadedSomatotypeDataAsset, FinalizeAndPopOnce]
+                         [this, LoadedSomatotypeDataAsset, FinalizeAndPopOnce, Generation]
                      (TArray<UBodyPartAsset*> LoadedBodyPartAssets)
                          {
+                             if (!IsInvalidationCurrent(Generation))
+                             {
+                                 UE_LOG(LogCustomizationComponent, Verbose, TEXT("InvalidateBodyParts: Pipeline %u was superseded, skipping body parts."), Generation);
+                                 return;
+                             }
                              UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateBodyParts: Async load of %d BodyPartAssets completed."), LoadedBodyPartAssets.Num());
                              ProcessBodyParts(this->ProcessingTargetState, LoadedSomatotypeDataAsset, LoadedBodyPartAssets);
                              FinalizeAndPopOnce(TEXT("Finished (all body part assets processed)."));
-                         });
-                 });
+                         }));
+                 }));
 }
 
 void UCustomizationComponent::ProcessBodyParts(FCustomizationContextData& TargetStateToModify,
@@ -776,14 +881,14 @@ void UCustomizationComponent::ProcessBodyParts(FCustomizationContextData& Target
 	}
 
 	// 2. 
-	TArray<FName> BodyPartSlugsToResolve;
-	TargetStateToModify.EquippedBodyPartsItems.GenerateValueArray(BodyPartSlugsToResolve);
+	TArray<FCustomizationItemHandle> BodyPartsToResolve;
+	TargetStateToModify.EquippedBodyPartsItems.GenerateValueArray(BodyPartsToResolve);
 
 	// 3. Resolve variants for equipped body parts and determine slot assignments
 	// Pass the full TargetStateToModify as the context for variant matching.
 	FResolvedVariantInfo ResolvedVariantData = ResolveBodyPartVariantsAndInitialAssignments(
 		TargetStateToModify,
-		BodyPartSlugsToResolve, 
+		BodyPartsToResolve, 
 		SlugToAssetMap
 	);
 
@@ -815,6 +920,26 @@ void UCustomizationComponent::ProcessColoration(FCustomizationContextData& Targe
 	const EMeshMergeMethod MergeMethod = UCustomizationSettings::Get()->GetMeshMergeMethod();
 	if (MergeMethod != EMeshMergeMethod::MasterPose)
 	{
+		// Skin change can join or split consolidated sections, change atlas texels or read streams the memory optimizer stripped,
+		// that takes a new merge instead of a material swap. Body merge of the same pipeline already takes the target's skins.
+		if ((MeshMergeUtilities::ShouldConsolidateMaterials() || MeshMergeUtilities::ShouldAtlasMaterials() || MeshMergeUtilities::ShouldOptimizeMeshMemory())
+			&& !LastMeshesToMergeData.IsEmpty() && !IsBodyMergeInFlight())
+		{
+			// Without a body merge the part set is the target's, only its skins change
+			TArray<FMeshToMergeData> MeshesToMergeData = LastMeshesToMergeData;
+			FillMergeMaterialOverrides(TargetStateToModify, MeshesToMergeData);
+
+			TArray<FMeshToMergeData> NormalizedLast = LastMeshesToMergeData;
+			TArray<FMeshToMergeData> NormalizedNew = MeshesToMergeData;
+			MeshMergeUtilities::NormalizeMergeOrder(NormalizedLast);
+			MeshMergeUtilities::NormalizeMergeOrder(NormalizedNew);
+			if (!(MeshMergeUtilities::MakeMergeKey(NormalizedLast) == MeshMergeUtilities::MakeMergeKey(NormalizedNew)))
+			{
+				RequestInvalidationStepMerge(MeshesToMergeData);
+				return;
+			}
+		}
+
 		ApplyMergedMaterials();
 		return;
 	}
@@ -847,17 +972,17 @@ void UCustomizationComponent::ProcessColoration(FCustomizationContextData& Targe
 	}
 
 	// 2.
-	TMap<FGameplayTag, FName> FinalSlotAssignment;
+	const FCustomizationItemRegistry& ItemRegistry = FCustomizationItemRegistry::Get();
+	TMap<FGameplayTag, FCustomizationItemHandle> FinalSlotAssignment;
 	for (const auto& Pair : TargetStateToModify.EquippedMaterialsMap)
 	{
-		const FName& Slug = Pair.Value;
-		if (const FGameplayTag* FoundSlotTag = SlugToSlotTagMap.Find(Slug))
+		if (const FGameplayTag* FoundSlotTag = SlugToSlotTagMap.Find(ItemRegistry.GetSlug(Pair.Value)))
 		{
-			FinalSlotAssignment.Add(*FoundSlotTag, Slug);
+			FinalSlotAssignment.Add(*FoundSlotTag, Pair.Value);
 		}
 	}
 
-	TargetStateToModify.EquippedMaterialsMap = FinalSlotAssignment;
+	TargetStateToModify.SetMaterials(FinalSlotAssignment);
 
 	// 4. 
 	for (UObject* LoadedAsset : LoadedMaterialAssets)
@@ -865,9 +990,9 @@ void UCustomizationComponent::ProcessColoration(FCustomizationContextData& Targe
 		if (auto MaterialAsset = Cast<UMaterialCustomizationDataAsset>(LoadedAsset))
 		{
 			const FName Slug = MaterialAsset->GetPrimaryAssetId().PrimaryAssetName;
-			const FName* FoundSlug = TargetStateToModify.EquippedMaterialsMap.Find(MaterialAsset->TargetItemSlot);
+			const FCustomizationItemHandle* FoundItem = TargetStateToModify.EquippedMaterialsMap.Find(MaterialAsset->TargetItemSlot);
 
-			if (FoundSlug && *FoundSlug == Slug)
+			if (FoundItem && ItemRegistry.GetSlug(*FoundItem) == Slug)
 			{
 				if (MaterialAsset->bApplyOnBodyPart)
 				{
@@ -884,9 +1009,9 @@ void UCustomizationComponent::ProcessColoration(FCustomizationContextData& Targe
 			if (!MaterialPack->MaterialAsset.MaterialCustomizations.IsEmpty() && MaterialPack->MaterialAsset.MaterialCustomizations[0])
 			{
 				const FGameplayTag PackSlotTag = MaterialPack->MaterialAsset.MaterialCustomizations[0]->TargetItemSlot;
-				const FName* FoundSlug = TargetStateToModify.EquippedMaterialsMap.Find(PackSlotTag);
+				const FCustomizationItemHandle* FoundItem = TargetStateToModify.EquippedMaterialsMap.Find(PackSlotTag);
 
-				if (FoundSlug && *FoundSlug == Slug)
+				if (FoundItem && ItemRegistry.GetSlug(*FoundItem) == Slug)
 				{
 					for (UMaterialCustomizationDataAsset* MaterialInPack : MaterialPack->MaterialAsset.MaterialCustomizations)
 					{
@@ -906,20 +1031,20 @@ void UCustomizationComponent::ProcessColoration(FCustomizationContextData& Targe
 	for (const auto& BodyPartPair : TargetStateToModify.EquippedBodyPartsItems)
 	{
 		const FGameplayTag& SlotTag = BodyPartPair.Key;
-		const FName& BodyPartSlug = BodyPartPair.Value;
+		const FCustomizationItemHandle& BodyPartItem = BodyPartPair.Value;
 
 		if (!TargetStateToModify.EquippedMaterialsMap.Contains(SlotTag))
 		{
 			// This slot should have its default materials.
 			if (auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager())
 			{
-				FPrimaryAssetId BodyPartAssetId = CommonUtilities::ItemSlugToCustomizationAssetId(BodyPartSlug);
+				FPrimaryAssetId BodyPartAssetId = CommonUtilities::ItemHandleToCustomizationAssetId(BodyPartItem);
 				if (UBodyPartAsset* BodyPartAsset = AssetManager->LoadPrimaryAsset<UBodyPartAsset>(BodyPartAssetId))
 				{
 					TArray<FPrimaryAssetId> AllEquippedItemAssetIdsInContext;
-					for (const FName& Slug : TargetStateToModify.GetEquippedSlugs())
+					for (const FCustomizationItemHandle& Item : TargetStateToModify.GetEquippedItems())
 					{
-						if (FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(Slug); AssetId.IsValid())
+						if (FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(Item); AssetId.IsValid())
 						{
 							AllEquippedItemAssetIdsInContext.Add(AssetId);
 						}
@@ -965,14 +1090,14 @@ void UCustomizationComponent::ApplyMergedMaterials()
 	for (const auto& MaterialPair : ProcessingTargetState.EquippedMaterialsMap)
 	{
 		const FGameplayTag& SlotTag = MaterialPair.Key;
-		const FName& SkinSlug = MaterialPair.Value;
+		const FCustomizationItemHandle& SkinItem = MaterialPair.Value;
 
 		for (const auto& MapPair : MergedMaterialMap)
 		{
 			if (MapPair.Value == SlotTag)
 			{
 				const int32 MaterialIndex = MapPair.Key;
-				FPrimaryAssetId SkinAssetId = CommonUtilities::ItemSlugToCustomizationAssetId(SkinSlug);
+				FPrimaryAssetId SkinAssetId = CommonUtilities::ItemHandleToCustomizationAssetId(SkinItem);
 
 				if (auto* MaterialAsset = AssetManager->LoadPrimaryAsset<UMaterialCustomizationDataAsset>(SkinAssetId))
 				{
@@ -980,7 +1105,7 @@ void UCustomizationComponent::ApplyMergedMaterials()
 					{
 						UMaterialInterface* SkinMaterial = MaterialAsset->IndexWithApplyingMaterial[0];
 						TargetMeshComponent->SetMaterial(MaterialIndex, SkinMaterial);
-						UE_LOG(LogCustomizationComponent, Log, TEXT("Applied skin %s to merged mesh at index %d for slot %s"), *SkinSlug.ToString(), MaterialIndex, *SlotTag.ToString());
+						UE_LOG(LogCustomizationComponent, Log, TEXT("Applied skin %s to merged mesh at index %d for slot %s"), *SkinItem.ToString(), MaterialIndex, *SlotTag.ToString());
 					}
 				}
 			}
@@ -994,8 +1119,7 @@ void UCustomizationComponent::HandleInvalidationPipelineCompleted()
 	if (CurrentCustomizationState != ProcessingTargetState)
 	{
 		UE_LOG(LogCustomizationComponent, Log, TEXT("HandleInvalidationPipelineCompleted: Updating CurrentCustomizationState from final ProcessingTargetState."));
-		CurrentCustomizationState = ProcessingTargetState;
-		OnEquippedItemsChanged.Broadcast(CurrentCustomizationState);
+		CommitProcessingTargetState();
 	}
 	else
 	{
@@ -1008,6 +1132,19 @@ void UCustomizationComponent::HandleInvalidationPipelineCompleted()
 	}
 }
 
+void UCustomizationComponent::CommitProcessingTargetState()
+{
+	CurrentCustomizationState = ProcessingTargetState;
+	CurrentCustomizationState.MarkSlotStateBase();
+	InternCurrentLoadout();
+	OnEquippedItemsChanged.Broadcast(CurrentCustomizationState);
+}
+
+void UCustomizationComponent::InternCurrentLoadout()
+{
+	CurrentLoadout = FCustomizationStatePool::Get().Intern(CurrentCustomizationState);
+}
+
 void UCustomizationComponent::ApplyBodySkin(const FCustomizationContextData& TargetState,
 											const USomatotypeDataAsset* SomatotypeDataAsset,
 											TSet<FGameplayTag>& FinalUsedSlotTags,
@@ -1025,7 +1162,7 @@ void UCustomizationComponent::ApplyBodySkin(const FCustomizationContextData& Tar
 	}
 
 	auto SkinMeshVariant = SkinVisibilityFlags.GetMatch(SomatotypeDataAsset->SkinAssociation, SkinVisibilityFlags.FlagMask);
-	const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+	const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 
 	if (SkinMeshVariant)
 	{
@@ -1070,7 +1207,7 @@ void UCustomizationComponent::ResetUnusedBodyParts(const TSet<FGameplayTag>& Fin
 }
 
 void UCustomizationComponent::SpawnAndAttachActorsForItem(UCustomizationDataAsset* DataAsset,
-														  FName ItemSlug,
+														  FCustomizationItemHandle Item,
 														  ABaseCharacter* CharOwner,
 														  UWorld* WorldContext,
 														  TArray<TWeakObjectPtr<AActor>>& OutSpawnedActorPtrs,
@@ -1079,27 +1216,27 @@ void UCustomizationComponent::SpawnAndAttachActorsForItem(UCustomizationDataAsse
 	// 1. 
 	if (!IsValid(DataAsset))
 	{
-		UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: Invalid DataAsset for ItemSlug: %s."), *ItemSlug.ToString());
+		UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: Invalid DataAsset for ItemSlug: %s."), *Item.ToString());
 		return;
 	}
 	if (!CharOwner || !CharOwner->GetMesh())
 	{
-		UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: Invalid OwningCharacter or its Mesh for ItemSlug: %s."), *ItemSlug.ToString());
+		UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: Invalid OwningCharacter or its Mesh for ItemSlug: %s."), *Item.ToString());
 		return;
 	}
 	if (!WorldContext)
 	{
-		UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: WorldContext is null for ItemSlug: %s."), *ItemSlug.ToString());
+		UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: WorldContext is null for ItemSlug: %s."), *Item.ToString());
 		return;
 	}
 
-	UE_LOG(LogCustomizationComponent, Verbose, TEXT("SpawnAndAttachActorsForItem: Spawning actors for ItemSlug: %s (Asset: %s)"), *ItemSlug.ToString(), *DataAsset->GetPrimaryAssetId().ToString());
+	UE_LOG(LogCustomizationComponent, Verbose, TEXT("SpawnAndAttachActorsForItem: Spawning actors for ItemSlug: %s (Asset: %s)"), *Item.ToString(), *DataAsset->GetPrimaryAssetId().ToString());
 
 	const TArray<FCustomizationComplect>& SuitableComplects = DataAsset->CustomizationComplect;
 	if (SuitableComplects.IsEmpty())
 	{
 		UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: CustomizationComplect array is empty in asset %s for item %s."),
-		       *DataAsset->GetPrimaryAssetId().ToString(), *ItemSlug.ToString());
+		       *DataAsset->GetPrimaryAssetId().ToString(), *Item.ToString());
 		return;
 	}
 
@@ -1109,15 +1246,21 @@ void UCustomizationComponent::SpawnAndAttachActorsForItem(UCustomizationDataAsse
 	// 2. Iterate through complects and spawn actors
 	for (const FCustomizationComplect& Complect : SuitableComplects)
 	{
+		if (ShouldBakeComplect(Complect))
+		{
+			UE_LOG(LogCustomizationComponent, Verbose, TEXT("SpawnAndAttachActorsForItem: %s is baked into the merged mesh for item %s"), *GetNameSafe(Complect.RigidMesh), *Item.ToString());
+			continue;
+		}
+
 		if (!Complect.ActorClass)
 		{
-			UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: Invalid ActorClass in Complect for item %s"), *ItemSlug.ToString());
+			UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: Invalid ActorClass in Complect for item %s"), *Item.ToString());
 			continue;
 		}
 
 		// 3. Determine attach target
 		USkeletalMeshComponent* AttachTarget = nullptr;
-		const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+		const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 		if (TObjectPtr<USkeletalMeshComponent> BodySkinComp = SpawnedMeshComponents.FindRef(BodySkinSlotTag))
 		{
 			AttachTarget = BodySkinComp;
@@ -1127,18 +1270,18 @@ void UCustomizationComponent::SpawnAndAttachActorsForItem(UCustomizationDataAsse
 			AttachTarget = CharOwner->GetMesh();
 			if (AttachTarget)
 			{
-				UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: SpawnedMeshComponents does not contain a valid BodySkin mesh component for item %s. Using OwningCharacter->GetMesh() (%s)."), *ItemSlug.ToString(), *AttachTarget->GetName());
+				UE_LOG(LogCustomizationComponent, Warning, TEXT("SpawnAndAttachActorsForItem: SpawnedMeshComponents does not contain a valid BodySkin mesh component for item %s. Using OwningCharacter->GetMesh() (%s)."), *Item.ToString(), *AttachTarget->GetName());
 			}
 			else
 			{
-				UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: Fallback OwningCharacter->GetMesh() is also null for item %s."), *ItemSlug.ToString());
+				UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: Fallback OwningCharacter->GetMesh() is also null for item %s."), *Item.ToString());
 				continue;
 			}
 		}
 
 		if (!AttachTarget) // Should be redundant due to above checks, but as a safeguard
 		{
-			UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: No valid SkeletalMeshComponent found to attach actor for item %s. Cannot spawn."), *ItemSlug.ToString());
+			UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: No valid SkeletalMeshComponent found to attach actor for item %s. Cannot spawn."), *Item.ToString());
 			continue;
 		}
 
@@ -1156,7 +1299,7 @@ void UCustomizationComponent::SpawnAndAttachActorsForItem(UCustomizationDataAsse
 		
 		if (!IsValid(SpawnedActor))
 		{
-			UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: Failed to spawn actor of class %s for item %s"), *Complect.ActorClass->GetName(), *ItemSlug.ToString());
+			UE_LOG(LogCustomizationComponent, Error, TEXT("SpawnAndAttachActorsForItem: Failed to spawn actor of class %s for item %s"), *Complect.ActorClass->GetName(), *Item.ToString());
 			continue;
 		}
 
@@ -1169,7 +1312,7 @@ void UCustomizationComponent::SpawnAndAttachActorsForItem(UCustomizationDataAsse
 		SpawnedActor->SetActorRelativeTransform(Complect.RelativeTransform);
 
 		UE_LOG(LogCustomizationComponent, Verbose, TEXT("SpawnAndAttachActorsForItem: Spawned and attached actor %s to %s at socket %s for item %s"),
-		       *SpawnedActor->GetName(), *AttachTarget->GetName(), *Complect.SocketName.ToString(), *ItemSlug.ToString());
+		       *SpawnedActor->GetName(), *AttachTarget->GetName(), *Complect.SocketName.ToString(), *Item.ToString());
 	}
 }
 
@@ -1181,36 +1324,36 @@ TArray<FPrimaryAssetId> UCustomizationComponent::CollectRelevantBodyPartAssetIds
 	// 1. Add assets from newly equipped body parts in the diff
 	for (const auto& Pair : AddedItemsContext.EquippedBodyPartsItems)
 	{
-		const FName& Slug = Pair.Value; // Value is the slug
-		FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(Slug);
+		const FCustomizationItemHandle& Item = Pair.Value;
+		FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(Item);
 		if (AssetId.IsValid())
 		{
 			RelevantAssetIdsSet.Add(AssetId);
-			UE_LOG(LogCustomizationComponent, Verbose, TEXT("CollectRelevantBodyPartAssetIds: Added slug %s (AssetID: %s) from AddedItemsContext."), *Slug.ToString(), *AssetId.ToString());
+			UE_LOG(LogCustomizationComponent, Verbose, TEXT("CollectRelevantBodyPartAssetIds: Added slug %s (AssetID: %s) from AddedItemsContext."), *Item.ToString(), *AssetId.ToString());
 		}
 	}
 
 	// 2. Add assets from removed body parts in the diff
 	for (const auto& Pair : RemovedItemsContext.EquippedBodyPartsItems)
 	{
-		const FName& Slug = Pair.Value; // Value is the slug
-		FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(Slug);
+		const FCustomizationItemHandle& Item = Pair.Value;
+		FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(Item);
 		if (AssetId.IsValid())
 		{
 			RelevantAssetIdsSet.Add(AssetId);
-			UE_LOG(LogCustomizationComponent, Verbose, TEXT("CollectRelevantBodyPartAssetIds: Added slug %s (AssetID: %s) from RemovedItemsContext."), *Slug.ToString(), *AssetId.ToString());
+			UE_LOG(LogCustomizationComponent, Verbose, TEXT("CollectRelevantBodyPartAssetIds: Added slug %s (AssetID: %s) from RemovedItemsContext."), *Item.ToString(), *AssetId.ToString());
 		}
 	}
 
 	// 3. Add assets currently specified in the target state's body part items
 	for (const auto& Pair : TargetState.EquippedBodyPartsItems)
 	{
-		const FName& Slug = Pair.Value; // Value is the slug
-		FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(Slug);
+		const FCustomizationItemHandle& Item = Pair.Value;
+		FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(Item);
 		if (AssetId.IsValid())
 		{
 			RelevantAssetIdsSet.Add(AssetId);
-			UE_LOG(LogCustomizationComponent, Verbose, TEXT("CollectRelevantBodyPartAssetIds: Added slug %s (AssetID: %s) from TargetState itself."), *Slug.ToString(), *AssetId.ToString());
+			UE_LOG(LogCustomizationComponent, Verbose, TEXT("CollectRelevantBodyPartAssetIds: Added slug %s (AssetID: %s) from TargetState itself."), *Item.ToString(), *AssetId.ToString());
 		}
 	}
 
@@ -1225,7 +1368,7 @@ void UCustomizationComponent::RebuildEquippedBodyPartsState(FCustomizationContex
 															TArray<FName>& OutFinalActiveSlugs)
 {
 	// 1. Clear the current body part assignments in the target state
-	TargetStateToModify.EquippedBodyPartsItems.Empty();
+	TargetStateToModify.EmptyBodyParts();
 	UE_LOG(LogCustomizationComponent, Log, TEXT("RebuildEquippedBodyPartsState: Cleared TargetState.EquippedBodyPartsItems. Rebuilding..."));
 
 	OutFinalUsedSlotTags.Empty();
@@ -1233,16 +1376,18 @@ void UCustomizationComponent::RebuildEquippedBodyPartsState(FCustomizationContex
 	OutFinalActiveSlugs.Reserve(ResolvedVariantData.FinalSlotAssignment.Num());
 
 	// 2. Rebuild based on the final slot assignments from variant resolution
+	const FCustomizationItemRegistry& ItemRegistry = FCustomizationItemRegistry::Get();
 	for (const auto& Pair : ResolvedVariantData.FinalSlotAssignment)
 	{
 		FGameplayTag SlotTag = Pair.Key;
-		FName Slug = Pair.Value;
+		const FCustomizationItemHandle Item = Pair.Value;
+		const FName Slug = ItemRegistry.GetSlug(Item);
 
 		const FBodyPartVariant* const* FoundVariantPtr = ResolvedVariantData.SlugToResolvedVariantMap.Find(Slug);
 
 		if (FoundVariantPtr && (*FoundVariantPtr))
 		{
-			TargetStateToModify.EquippedBodyPartsItems.Add(SlotTag, Slug);
+			TargetStateToModify.SetBodyPart(SlotTag, Item);
 			OutFinalUsedSlotTags.Add(SlotTag);
 			OutFinalActiveSlugs.Add(Slug);
 			UE_LOG(LogCustomizationComponent, Verbose, TEXT("RebuildEquippedBodyPartsState: Final assignment for SlotTag %s is Slug %s."), *SlotTag.ToString(), *Slug.ToString());
@@ -1256,29 +1401,35 @@ void UCustomizationComponent::RebuildEquippedBodyPartsState(FCustomizationContex
 }
 
 FResolvedVariantInfo UCustomizationComponent::ResolveBodyPartVariantsAndInitialAssignments(const FCustomizationContextData& FullTargetContext,
-                                                                                           const TArray<FName>& BodyPartSlugsToResolve,
+                                                                                           const TArray<FCustomizationItemHandle>& BodyPartsToResolve,
                                                                                            const TMap<FName, UBodyPartAsset*>& SlugToAssetMap)
 {
+	const FCustomizationItemRegistry& ItemRegistry = FCustomizationItemRegistry::Get();
 	FResolvedVariantInfo Result;
-	Result.InitialSlugsInTargetState = BodyPartSlugsToResolve;
+	Result.InitialSlugsInTargetState.Reserve(BodyPartsToResolve.Num());
 
-	// 1. Get all slugs from any equipped item type in FullTargetContext for variant context
+	// 1. Get all items from any equipped item type in FullTargetContext for variant context
+	const TArray<FCustomizationItemHandle> EquippedItems = FullTargetContext.GetEquippedItems();
 	TArray<FPrimaryAssetId> AllEquippedItemAssetIdsInContext;
-	AllEquippedItemAssetIdsInContext.Reserve(FullTargetContext.GetEquippedSlugs().Num());
-	for (const FName& Slug : FullTargetContext.GetEquippedSlugs())
+	AllEquippedItemAssetIdsInContext.Reserve(EquippedItems.Num());
+	for (const FCustomizationItemHandle& Item : EquippedItems)
 	{
-		FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(Slug);
+		FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(Item);
 		if (AssetId.IsValid())
 		{
 			AllEquippedItemAssetIdsInContext.Add(AssetId);
 		}
 	}
 
-	UE_LOG(LogCustomizationComponent, Log, TEXT("ResolveBodyPartVariants: Resolving for %d body part slugs with %d items in full context."), BodyPartSlugsToResolve.Num(), AllEquippedItemAssetIdsInContext.Num());
+	UE_LOG(LogCustomizationComponent, Log, TEXT("ResolveBodyPartVariants: Resolving for %d body part slugs with %d items in full context."), BodyPartsToResolve.Num(), AllEquippedItemAssetIdsInContext.Num());
 
 	// 2. Resolve variants for each body part slug we're interested in
-	for (const FName& ItemSlug : BodyPartSlugsToResolve)
+	for (const FCustomizationItemHandle& Item : BodyPartsToResolve)
 	{
+		// Loaded assets are known by their slugs
+		const FName ItemSlug = ItemRegistry.GetSlug(Item);
+		Result.InitialSlugsInTargetState.Add(ItemSlug);
+
 		const UBodyPartAsset* const* FoundAssetPtr = SlugToAssetMap.Find(ItemSlug);
 		if (!FoundAssetPtr || !IsValid(*FoundAssetPtr))
 		{
@@ -1299,7 +1450,7 @@ FResolvedVariantInfo UCustomizationComponent::ResolveBodyPartVariantsAndInitialA
 			FGameplayTag ResolvedSlotTag = BodyPartAsset->TargetItemSlot; // Get the slot from the asset itself.
 			if (ResolvedSlotTag.IsValid())
 			{
-				Result.FinalSlotAssignment.Add(ResolvedSlotTag, ItemSlug); 
+				Result.FinalSlotAssignment.Add(ResolvedSlotTag, Item); 
 				Result.SlugToResolvedVariantMap.Add(ItemSlug, MatchedVariant);
 				UE_LOG(LogCustomizationComponent, Verbose, TEXT("ResolveBodyPartVariants: Slug '%s' (Asset: %s) resolved to SlotTag: %s."), *ItemSlug.ToString(), *BodyPartAsset->GetPrimaryAssetId().ToString(), *ResolvedSlotTag.ToString());
 			}
@@ -1328,7 +1479,7 @@ void UCustomizationComponent::ApplyBodyPartsMasterPose(USomatotypeDataAsset* Loa
 		}
 	}
 	auto SkinMeshVariant = SkinVisibilityFlags.GetMatch(LoadedSomatotypeDataAsset->SkinAssociation, SkinVisibilityFlags.FlagMask);
-	const FGameplayTag BodySkinSlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
+	const FGameplayTag BodySkinSlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
 
 	if (SkinMeshVariant)
 	{
@@ -1343,10 +1494,11 @@ void UCustomizationComponent::ApplyBodyPartsMasterPose(USomatotypeDataAsset* Loa
 	}
     
 	// 2. Apply Body Part Meshes
+	const FCustomizationItemRegistry& ItemRegistry = FCustomizationItemRegistry::Get();
 	for (const auto& Pair : TargetStateContext.EquippedBodyPartsItems)
 	{
 		const FGameplayTag& SlotTag = Pair.Key;
-		const FName& Slug = Pair.Value;
+		const FName Slug = ItemRegistry.GetSlug(Pair.Value);
         
 		if (const FBodyPartVariant* const* FoundVariantPtr = SlugToResolvedVariantMap.Find(Slug))
 		{
@@ -1367,7 +1519,36 @@ void UCustomizationComponent::ApplyBodyPartsMasterPose(USomatotypeDataAsset* Loa
 
 void UCustomizationComponent::ApplyBodyPartsMeshMerge(FCustomizationContextData& TargetStateContext, USomatotypeDataAsset* LoadedSomatotypeDataAsset, const TArray<FName>& FinalActiveSlugs, const TMap<FName, const FBodyPartVariant*>& SlugToResolvedVariantMap)
 {
+	// A request still pending is superseded, its followers and hidden sections go with it
+	if (bMergeRequestPending)
+	{
+		bMergeRequestPending = false;
+		TearDownMergeBridge();
+	}
+
 	TArray<FMeshToMergeData> MeshesToMergeData;
+	if (!BuildMeshesToMergeData(TargetStateContext, LoadedSomatotypeDataAsset, FinalActiveSlugs, SlugToResolvedVariantMap, MeshesToMergeData))
+	{
+		UE_LOG(LogCustomizationComponent, Error, TEXT("[MESH MERGE] No valid skin mesh found for current somatotype and flags! Aborting merge."));
+		// Superseded request must not show up once it completes either
+		++MergeGeneration;
+		HandleInvalidationPipelineCompleted();
+		return;
+	}
+
+	// Cache hits and unbudgeted sync merges complete inside the request, only a merge still pending needs the bridge
+	bMergeRequestPending = true;
+	RequestBodyPartsMerge(MeshesToMergeData);
+	if (bMergeRequestPending && UCustomizationSettings::Get()->GetBridgePendingMergeWithMasterPose())
+	{
+		ShowMergeBridge(TargetStateContext, MeshesToMergeData);
+	}
+}
+
+bool UCustomizationComponent::BuildMeshesToMergeData(const FCustomizationContextData& TargetStateContext, USomatotypeDataAsset* LoadedSomatotypeDataAsset, const TArray<FName>& FinalActiveSlugs,
+	const TMap<FName, const FBodyPartVariant*>& SlugToResolvedVariantMap, TArray<FMeshToMergeData>& OutMeshesToMergeData) const
+{
+	OutMeshesToMergeData.Reset();
 
     // Main skin mesh (required)
     USkeletalMesh* SkinMesh = nullptr;
@@ -1381,20 +1562,17 @@ void UCustomizationComponent::ApplyBodyPartsMeshMerge(FCustomizationContextData&
             }
         }
         auto SkinMeshVariant = SkinVisibilityFlags.GetMatch(LoadedSomatotypeDataAsset->SkinAssociation, SkinVisibilityFlags.FlagMask);
-        if (SkinMeshVariant && SkinMeshVariant->BodyPartSkeletalMesh)
+        if (!SkinMeshVariant || !SkinMeshVariant->BodyPartSkeletalMesh)
         {
-        	SkinMesh = SkinMeshVariant->BodyPartSkeletalMesh;
-        	FMeshToMergeData SkinData;
-        	SkinData.SkeletalMesh = SkinMesh;
-        	SkinData.SlotTag = FGameplayTag::RequestGameplayTag(GLOBAL_CONSTANTS::BodySkinSlotTagName);
-        	MeshesToMergeData.Add(SkinData);
-        }
-        else
-        {
-            UE_LOG(LogCustomizationComponent, Error, TEXT("[MESH MERGE] No valid skin mesh found for current somatotype and flags! Aborting merge."));
-            HandleInvalidationPipelineCompleted();
-            return;
+            return false;
         }
+
+        SkinMesh = SkinMeshVariant->BodyPartSkeletalMesh;
+        FMeshToMergeData SkinData;
+        SkinData.SkeletalMesh = SkinMesh;
+        SkinData.SlotTag = CustomizationSlots::TAG_Slot_Item_BodySkin;
+        SkinData.CoveredSkinMask = SkinVisibilityFlags.FlagMask;
+        OutMeshesToMergeData.Add(SkinData);
     }
 
     // Body parts (attachments)
@@ -1404,41 +1582,427 @@ void UCustomizationComponent::ApplyBodyPartsMeshMerge(FCustomizationContextData&
         if (FoundVariantPtr && (*FoundVariantPtr) && (*FoundVariantPtr)->BodyPartSkeletalMesh)
         {
             USkeletalMesh* PartMesh = (*FoundVariantPtr)->BodyPartSkeletalMesh;
-            FGameplayTag SlotTag = TargetStateContext.EquippedBodyPartsItems.FindKey(Slug) ? *TargetStateContext.EquippedBodyPartsItems.FindKey(Slug) : FGameplayTag();
             if (PartMesh && PartMesh != SkinMesh)
             {
             	FMeshToMergeData PartData;
             	PartData.SkeletalMesh = PartMesh;
-            	if (const FGameplayTag* SlotTagPtr = TargetStateContext.EquippedBodyPartsItems.FindKey(Slug))
+            	if (const FGameplayTag* SlotTagPtr = TargetStateContext.EquippedBodyPartsItems.FindKey(FCustomizationItemRegistry::Get().FindHandle(Slug)))
             	{
             		PartData.SlotTag = *SlotTagPtr;
             	}
-            	MeshesToMergeData.Add(PartData);
+            	OutMeshesToMergeData.Add(PartData);
             }
         }
     }
-    
-    if (!SkinMesh)
-    {
-        if (OwningCharacter.IsValid() && OwningCharacter->GetMesh())
-        {
-            OwningCharacter->GetMesh()->SetSkeletalMeshAsset(nullptr);
-        }
-        HandleInvalidationPipelineCompleted();
-        return;
-    }
-    
-	if (MeshesToMergeData.IsEmpty())
+
+	// Memory optimizer keeps only the streams skins read, it needs them as much as consolidation does
+	if (MeshMergeUtilities::ShouldConsolidateMaterials() || MeshMergeUtilities::ShouldAtlasMaterials() || MeshMergeUtilities::ShouldOptimizeMeshMemory())
+	{
+		FillMergeMaterialOverrides(TargetStateContext, OutMeshesToMergeData);
+	}
+	if (MeshMergeUtilities::ShouldPruneBones())
+	{
+		FillMergeKeptSockets(TargetStateContext, OutMeshesToMergeData);
+	}
+	if (MeshMergeUtilities::ShouldBakeRigidAccessories())
+	{
+		FillMergeRigidMeshes(TargetStateContext, OutMeshesToMergeData);
+	}
+	return true;
+}
+
+void UCustomizationComponent::RequestInvalidationStepMerge(const TArray<FMeshToMergeData>& MeshesToMergeData)
+{
+	if (!bStepMergeHoldsPipeline)
+	{
+		PendingInvalidationCounter.Push();
+		bStepMergeHoldsPipeline = true;
+	}
+	RequestBodyPartsMerge(MeshesToMergeData, InvalidationGeneration);
+}
+
+void UCustomizationComponent::RequestBodyPartsMerge(const TArray<FMeshToMergeData>& MeshesToMergeData, TOptional<uint32> HeldInvalidationGeneration)
+{
+	LastMeshesToMergeData = MeshesToMergeData;
+
+	// Newer merge of this component supersedes the queued one, local player goes first
+	FMeshMergeRequestParams MergeRequestParams;
+	MergeRequestParams.Requester = this;
+	MergeRequestParams.Priority = OwningCharacter.IsValid() && OwningCharacter->IsLocallyControlled() && OwningCharacter->IsPlayerControlled()
+		? EMeshMergePriority::High
+		: EMeshMergePriority::Normal;
+
+	// Only the swapped parts are rebuilt, the rest is copied from the mesh shown now
+	if (OwningCharacter.IsValid() && OwningCharacter->GetMesh())
+	{
+		MergeRequestParams.PreviousMergedMesh = OwningCharacter->GetMesh()->GetSkeletalMeshAsset();
+	}
+
+	UMeshMergeSubsystem::MergeMeshesWithSettings(GetWorld(), MeshesToMergeData, &MergedMaterialMap,
+		FOnMeshMergeCompleteDelegate::CreateUObject(this, &UCustomizationComponent::OnMergeCompleted, ++MergeGeneration, HeldInvalidationGeneration), MergeRequestParams);
+}
+
+void UCustomizationComponent::RequestSpeculativeMerge(const FName& ItemSlug)
+{
+	if (ItemSlug == NAME_None || !UMeshMergeSpeculationSubsystem::Get(GetWorld()) || UCustomizationSettings::Get()->GetMeshMergeMethod() == EMeshMergeMethod::MasterPose)
+	{
+		return;
+	}
+
+	const FCustomizationItemHandle ItemHandle = FindItemHandle(ItemSlug);
+	if (!ItemHandle.IsValid())
 	{
-		if (OwningCharacter.IsValid() && OwningCharacter->GetMesh())
+		return;
+	}
+
+	LoadSlotMappingAndExecute([this, ItemHandle]()
+	{
+		// 1. State equipping the item would result in
+		FCustomizationContextData PredictedState = GetLatestTargetState();
+		AddItemToTargetState(ItemHandle, PredictedState);
+
+		const FPrimaryAssetId SomatotypeAssetId = CustomizationUtilities::GetSomatotypeAssetId(PredictedState.Somatotype);
+		if (!SomatotypeAssetId.IsValid())
 		{
-			OwningCharacter->GetMesh()->SetSkeletalMeshAsset(nullptr);
+			return;
 		}
-		HandleInvalidationPipelineCompleted();
+
+		// 2. Assets of the current outfit are loaded already, usually only the hovered part is
+		UCustomizationAssetManager::GetCustomizationAssetManager()->AsyncLoadAsset<USomatotypeDataAsset>(SomatotypeAssetId,
+			[WeakThis = MakeWeakObjectPtr(this), PredictedState](USomatotypeDataAsset* LoadedSomatotypeDataAsset)
+			{
+				if (!WeakThis.IsValid() || !LoadedSomatotypeDataAsset)
+				{
+					return;
+				}
+
+				const TArray<FPrimaryAssetId> BodyPartAssetIds = WeakThis->CollectRelevantBodyPartAssetIds(PredictedState, FCustomizationContextData(), FCustomizationContextData());
+				UCustomizationAssetManager::StaticAsyncLoadAssetList<UBodyPartAsset>(BodyPartAssetIds,
+					[WeakThis, PredictedState, LoadedSomatotypeDataAsset](TArray<UBodyPartAsset*> LoadedBodyPartAssets) mutable
+					{
+						if (WeakThis.IsValid())
+						{
+							WeakThis->RequestPredictedMerge(PredictedState, LoadedSomatotypeDataAsset, LoadedBodyPartAssets);
+						}
+					});
+			});
+	});
+}
+
+void UCustomizationComponent::DiscardSpeculativeMerges()
+{
+	if (UMeshMergeSpeculationSubsystem* MeshMergeSpeculation = GetWorld() ? GetWorld()->GetSubsystem<UMeshMergeSpeculationSubsystem>() : nullptr)
+	{
+		MeshMergeSpeculation->DiscardSpeculations(this);
+	}
+}
+
+void UCustomizationComponent::RequestPredictedMerge(FCustomizationContextData& PredictedState, USomatotypeDataAsset* LoadedSomatotypeDataAsset, const TArray<UBodyPartAsset*>& LoadedBodyPartAssets)
+{
+	UMeshMergeSpeculationSubsystem* MeshMergeSpeculation = UMeshMergeSpeculationSubsystem::Get(GetWorld());
+	if (!MeshMergeSpeculation)
+	{
 		return;
 	}
-	
-	UMeshMergeSubsystem::MergeMeshesWithSettings(GetWorld(), MeshesToMergeData, &MergedMaterialMap, FOnMeshMergeCompleteDelegate::CreateUObject(this, &UCustomizationComponent::OnMergeCompleted));
+
+	// 1. Same variant resolution as ProcessBodyParts, materials are left as they are
+	TMap<FName, UBodyPartAsset*> SlugToAssetMap;
+	for (UBodyPartAsset* BodyPartAsset : LoadedBodyPartAssets)
+	{
+		if (BodyPartAsset)
+		{
+			SlugToAssetMap.Add(BodyPartAsset->GetPrimaryAssetId().PrimaryAssetName, BodyPartAsset);
+		}
+	}
+
+	TArray<FCustomizationItemHandle> BodyPartsToResolve;
+	PredictedState.EquippedBodyPartsItems.GenerateValueArray(BodyPartsToResolve);
+	const FResolvedVariantInfo ResolvedVariantData = ResolveBodyPartVariantsAndInitialAssignments(PredictedState, BodyPartsToResolve, SlugToAssetMap);
+
+	TSet<FGameplayTag> FinalUsedSlotTags;
+	TArray<FName> FinalActiveSlugs;
+	RebuildEquippedBodyPartsState(PredictedState, ResolvedVariantData, FinalUsedSlotTags, FinalActiveSlugs);
+
+	TArray<FMeshToMergeData> MeshesToMergeData;
+	if (!BuildMeshesToMergeData(PredictedState, LoadedSomatotypeDataAsset, FinalActiveSlugs, ResolvedVariantData.SlugToResolvedVariantMap, MeshesToMergeData))
+	{
+		return;
+	}
+
+	// 2. Items that don't change the merged part set, e.g. spawned actors, have nothing to speculate
+	TArray<FMeshToMergeData> PredictedMeshesToMergeData = MeshesToMergeData;
+	TArray<FMeshToMergeData> CurrentMeshesToMergeData = LastMeshesToMergeData;
+	MeshMergeUtilities::NormalizeMergeOrder(PredictedMeshesToMergeData);
+	MeshMergeUtilities::NormalizeMergeOrder(CurrentMeshesToMergeData);
+	if (MeshMergeUtilities::MakeMergeKey(PredictedMeshesToMergeData) == MeshMergeUtilities::MakeMergeKey(CurrentMeshesToMergeData))
+	{
+		return;
+	}
+
+	MeshMergeSpeculation->RequestSpeculativeMerge(this, MeshesToMergeData);
+}
+
+void UCustomizationComponent::FillMergeMaterialOverrides(const FCustomizationContextData& TargetState, TArray<FMeshToMergeData>& InOutMeshesToMergeData) const
+{
+	// Same rule as ApplyMergedMaterials: skin replaces every material of its slot
+	for (FMeshToMergeData& Data : InOutMeshesToMergeData)
+	{
+		Data.MaterialOverrides.Reset();
+
+		UMaterialInterface* SkinMaterial = ResolveSlotSkinMaterial(TargetState, Data.SlotTag);
+		if (SkinMaterial && Data.SkeletalMesh)
+		{
+			Data.MaterialOverrides.Init(SkinMaterial, Data.SkeletalMesh->GetMaterials().Num());
+		}
+	}
+}
+
+void UCustomizationComponent::FillMergeKeptSockets(const FCustomizationContextData& TargetState, TArray<FMeshToMergeData>& InOutMeshesToMergeData) const
+{
+	auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
+	if (!AssetManager || InOutMeshesToMergeData.IsEmpty())
+	{
+		return;
+	}
+
+	// Actors attach to the main mesh, sockets go with the skin part which is always merged
+	TArray<FName>& KeptSocketNames = InOutMeshesToMergeData[0].KeptSocketNames;
+	KeptSocketNames.Reset();
+	for (const auto& Pair : TargetState.EquippedCustomizationItemActors)
+	{
+		for (const FEquippedItemActorsInfo& ActorInfo : Pair.Value.EquippedItemActors)
+		{
+			const FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(ActorInfo.Item);
+			if (const auto* DataAsset = AssetManager->LoadPrimaryAsset<UCustomizationDataAsset>(AssetId))
+			{
+				for (const FCustomizationComplect& Complect : DataAsset->CustomizationComplect)
+				{
+					KeptSocketNames.AddUnique(Complect.SocketName);
+				}
+			}
+		}
+	}
+}
+
+bool UCustomizationComponent::ShouldBakeComplect(const FCustomizationComplect& Complect) const
+{
+	// Master Pose has no merged mesh to bake into
+	return UCustomizationSettings::Get()->GetMeshMergeMethod() != EMeshMergeMethod::MasterPose
+		&& MeshMergeUtilities::CanBakeRigidMesh(Complect.RigidMesh);
+}
+
+void UCustomizationComponent::FillMergeRigidMeshes(const FCustomizationContextData& TargetState, TArray<FMeshToMergeData>& InOutMeshesToMergeData) const
+{
+	auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
+	if (!AssetManager || InOutMeshesToMergeData.IsEmpty())
+	{
+		return;
+	}
+
+	// Same as kept sockets, accessories go with the skin part which is always merged
+	TArray<FRigidMeshToMergeData>& RigidMeshes = InOutMeshesToMergeData[0].RigidMeshes;
+	RigidMeshes.Reset();
+	for (const auto& Pair : TargetState.EquippedCustomizationItemActors)
+	{
+		for (const FEquippedItemActorsInfo& ActorInfo : Pair.Value.EquippedItemActors)
+		{
+			const FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(ActorInfo.Item);
+			if (const auto* DataAsset = AssetManager->LoadPrimaryAsset<UCustomizationDataAsset>(AssetId))
+			{
+				for (const FCustomizationComplect& Complect : DataAsset->CustomizationComplect)
+				{
+					if (ShouldBakeComplect(Complect))
+					{
+						FRigidMeshToMergeData& RigidData = RigidMeshes.AddDefaulted_GetRef();
+						RigidData.StaticMesh = Complect.RigidMesh;
+						RigidData.SocketName = Complect.SocketName;
+						RigidData.RelativeTransform = Complect.RelativeTransform;
+					}
+				}
+			}
+		}
+	}
+}
+
+void UCustomizationComponent::RefreshMergeItemAttachments(const FCustomizationContextData& TargetState)
+{
+	const EMeshMergeMethod MergeMethod = UCustomizationSettings::Get()->GetMeshMergeMethod();
+	const bool bPruneBones = MeshMergeUtilities::ShouldPruneBones();
+	const bool bBakeRigidAccessories = MeshMergeUtilities::ShouldBakeRigidAccessories();
+	// Body merge of the same pipeline keeps sockets and bakes accessories of the whole target state, superseding it would show stale parts
+	if (MergeMethod == EMeshMergeMethod::MasterPose || (!bPruneBones && !bBakeRigidAccessories) || LastMeshesToMergeData.IsEmpty() || IsBodyMergeInFlight())
+	{
+		return;
+	}
+
+	TArray<FMeshToMergeData> MeshesToMergeData = LastMeshesToMergeData;
+	if (bPruneBones)
+	{
+		FillMergeKeptSockets(TargetState, MeshesToMergeData);
+	}
+	if (bBakeRigidAccessories)
+	{
+		FillMergeRigidMeshes(TargetState, MeshesToMergeData);
+	}
+
+	if (MeshMergeUtilities::CollectKeptSocketNames(MeshesToMergeData) != MeshMergeUtilities::CollectKeptSocketNames(LastMeshesToMergeData)
+		|| MeshMergeUtilities::CollectRigidMeshes(MeshesToMergeData) != MeshMergeUtilities::CollectRigidMeshes(LastMeshesToMergeData))
+	{
+		RequestInvalidationStepMerge(MeshesToMergeData);
+	}
+}
+
+UMaterialInterface* UCustomizationComponent::ResolveSlotSkinMaterial(const FCustomizationContextData& TargetState, const FGameplayTag& SlotTag) const
+{
+	auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
+	const FCustomizationItemHandle* SkinItem = TargetState.EquippedMaterialsMap.Find(SlotTag);
+	if (!SkinItem || !AssetManager)
+	{
+		return nullptr;
+	}
+
+	const FPrimaryAssetId SkinAssetId = CommonUtilities::ItemHandleToCustomizationAssetId(*SkinItem);
+	const auto* MaterialAsset = AssetManager->LoadPrimaryAsset<UMaterialCustomizationDataAsset>(SkinAssetId);
+	return MaterialAsset && MaterialAsset->IndexWithApplyingMaterial.Contains(0) ? MaterialAsset->IndexWithApplyingMaterial[0] : nullptr;
+}
+
+void UCustomizationComponent::ShowMergeBridge(const FCustomizationContextData& TargetState, const TArray<FMeshToMergeData>& MeshesToMergeData)
+{
+	USkeletalMeshComponent* MainMesh = OwningCharacter.IsValid() ? OwningCharacter->GetMesh() : nullptr;
+	if (!MainMesh)
+	{
+		return;
+	}
+
+	// 1. Slots whose part differs from the merged mesh on display, removed parts included
+	TSet<FGameplayTag> ChangedSlots;
+	for (const FMeshToMergeData& Data : MeshesToMergeData)
+	{
+		const bool bShown = ShownMeshesToMergeData.ContainsByPredicate([&Data](const FMeshToMergeData& Shown)
+		{
+			return Shown.SlotTag == Data.SlotTag && Shown.SkeletalMesh == Data.SkeletalMesh;
+		});
+		if (!bShown)
+		{
+			ChangedSlots.Add(Data.SlotTag);
+		}
+	}
+	for (const FMeshToMergeData& Shown : ShownMeshesToMergeData)
+	{
+		if (!MeshesToMergeData.ContainsByPredicate([&Shown](const FMeshToMergeData& Data) { return Data.SlotTag == Shown.SlotTag; }))
+		{
+			ChangedSlots.Add(Shown.SlotTag);
+		}
+	}
+
+	// 2. Sections of the merged mesh on display that hold old parts of changed slots.
+	// Sections 1:1 to parts are found by part range; without a layout only material slots tell the owner, and the atlas material has none.
+	const USkeletalMesh* ShownMesh = MainMesh->GetSkeletalMeshAsset();
+	const FSkeletalMeshRenderData* RenderData = ShownMesh ? ShownMesh->GetResourceForRendering() : nullptr;
+	if (!RenderData)
+	{
+		return;
+	}
+
+	struct FHiddenSection
+	{
+		int32 LODIndex;
+		int32 SectionIndex;
+		int32 MaterialIndex;
+	};
+	TArray<FHiddenSection> HiddenSections;
+	const UMergedMeshLayoutUserData* LayoutUserData = UMergedMeshLayoutUserData::Find(ShownMesh);
+	for (int32 LODIndex = 0; LODIndex < RenderData->LODRenderData.Num(); ++LODIndex)
+	{
+		const TArray<FSkelMeshRenderSection>& Sections = RenderData->LODRenderData[LODIndex].RenderSections;
+		for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+		{
+			const FSkelMeshRenderSection& Section = Sections[SectionIndex];
+			bool bChanged = false;
+			if (LayoutUserData && LayoutUserData->Layout.IsValid())
+			{
+				for (const FMergedMeshLayout::FPart& Part : LayoutUserData->Layout->Parts)
+				{
+					if (Part.LODs.IsValidIndex(LODIndex) && ChangedSlots.Contains(Part.SlotTag))
+					{
+						const FMergedPartRange& Range = Part.LODs[LODIndex];
+						if (Section.BaseIndex >= Range.FirstIndex && Section.BaseIndex < Range.FirstIndex + Range.NumIndices)
+						{
+							bChanged = true;
+							break;
+						}
+					}
+				}
+			}
+			else
+			{
+				const FGameplayTag* SectionSlot = ShownMaterialMap.Find(Section.MaterialIndex);
+				if (!SectionSlot)
+				{
+					UE_LOG(LogCustomizationComponent, Verbose, TEXT("[MESH MERGE] Atlased merged mesh on display, skipping the Master Pose bridge"));
+					return;
+				}
+				bChanged = ChangedSlots.Contains(*SectionSlot);
+			}
+
+			if (bChanged)
+			{
+				HiddenSections.Add({LODIndex, SectionIndex, Section.MaterialIndex});
+			}
+		}
+	}
+
+	// 3. New parts go through the Master Pose path, following the main mesh
+	for (const FMeshToMergeData& Data : MeshesToMergeData)
+	{
+		if (!ChangedSlots.Contains(Data.SlotTag) || !Data.SkeletalMesh)
+		{
+			continue;
+		}
+
+		CustomizationUtilities::SetBodyPartSkeletalMesh(this, Data.SkeletalMesh, nullptr, Data.SlotTag);
+		MergeBridgeSlots.Add(Data.SlotTag);
+
+		const TObjectPtr<USkeletalMeshComponent>* FollowerPtr = SpawnedMeshComponents.Find(Data.SlotTag);
+		UMaterialInterface* SkinMaterial = ResolveSlotSkinMaterial(TargetState, Data.SlotTag);
+		if (FollowerPtr && *FollowerPtr && SkinMaterial)
+		{
+			for (int32 MaterialIndex = 0; MaterialIndex < Data.SkeletalMesh->GetMaterials().Num(); ++MaterialIndex)
+			{
+				(*FollowerPtr)->SetMaterial(MaterialIndex, SkinMaterial);
+			}
+		}
+	}
+
+	// 4. Old parts of changed slots are hidden in the merged mesh. Consolidated sections follow the slot of their first part.
+	for (const FHiddenSection& Hidden : HiddenSections)
+	{
+		MainMesh->ShowMaterialSection(Hidden.MaterialIndex, Hidden.SectionIndex, false, Hidden.LODIndex);
+	}
+
+	UE_LOG(LogCustomizationComponent, Verbose, TEXT("[MESH MERGE] Bridging %d changed slots with Master Pose until merge completes"), ChangedSlots.Num());
+}
+
+void UCustomizationComponent::TearDownMergeBridge()
+{
+	for (const FGameplayTag& SlotTag : MergeBridgeSlots)
+	{
+		TObjectPtr<USkeletalMeshComponent> Follower;
+		if (SpawnedMeshComponents.RemoveAndCopyValue(SlotTag, Follower) && IsValid(Follower))
+		{
+			Follower->DestroyComponent();
+		}
+	}
+	MergeBridgeSlots.Empty();
+
+	if (OwningCharacter.IsValid() && OwningCharacter->GetMesh())
+	{
+		USkeletalMeshComponent* MainMesh = OwningCharacter->GetMesh();
+		for (int32 LODIndex = 0; LODIndex < MainMesh->GetNumLODs(); ++LODIndex)
+		{
+			MainMesh->ShowAllMaterialSections(LODIndex);
+		}
+	}
 }
 
 void UCustomizationComponent::ApplyBodyPartMeshesAndSkin(FCustomizationContextData& TargetStateContext,
@@ -1483,10 +2047,10 @@ void UCustomizationComponent::UpdateMaterialsForBodyPartChanges(FCustomizationCo
 		const FGameplayTag& SlotTag = OriginalPair.Key;
 		const FName& OriginalSlug = OriginalPair.Value;
 		
-		const FName* FinalSlugInSlot = ResolvedVariantData.FinalSlotAssignment.Find(SlotTag);
+		const FCustomizationItemHandle* FinalItemInSlot = ResolvedVariantData.FinalSlotAssignment.Find(SlotTag);
 
 		// If the slot is now empty OR is occupied by a different item, it's affected.
-		if (!FinalSlugInSlot || *FinalSlugInSlot != OriginalSlug)
+		if (!FinalItemInSlot || FCustomizationItemRegistry::Get().GetSlug(*FinalItemInSlot) != OriginalSlug)
 		{
 			AffectedSlotTagsForMaterialReset.Add(SlotTag);
 		}
@@ -1523,8 +2087,9 @@ void UCustomizationComponent::UpdateMaterialsForBodyPartChanges(FCustomizationCo
 			UE_LOG(LogCustomizationComponent, Log, TEXT("UpdateMaterialsForBodyPartChanges: Removing %d materials from EquippedMaterialsMap."), MaterialSlotsToRemove.Num());
 			for (const FGameplayTag& SlotToRemove : MaterialSlotsToRemove)
 			{
-				FName RemovedSlug = TargetStateToModify.EquippedMaterialsMap.FindAndRemoveChecked(SlotToRemove);
-				UE_LOG(LogCustomizationComponent, Log, TEXT("UpdateMaterialsForBodyPartChanges: Removed material %s from slot %s."), *RemovedSlug.ToString(), *SlotToRemove.ToString());
+				FCustomizationItemHandle RemovedItem;
+				TargetStateToModify.RemoveMaterial(SlotToRemove, &RemovedItem);
+				UE_LOG(LogCustomizationComponent, Log, TEXT("UpdateMaterialsForBodyPartChanges: Removed material %s from slot %s."), *RemovedItem.ToString(), *SlotToRemove.ToString());
 			}
 		}
 	}
@@ -1541,6 +2106,8 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 	if (ActorChanges.AssetIdsToLoad.IsEmpty() && ActorChanges.ActorsToDestroy.IsEmpty())
 	{
 		UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateAttachedActors: No actors to destroy and no new assets to load. Invalidation complete."));
+		// Items with baked accessories only have no actors to diff
+		RefreshMergeItemAttachments(TargetState);
 		PendingInvalidationCounter.Pop();
 		return;
 	}
@@ -1550,6 +2117,7 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 	{
 		UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateAttachedActors: Only destroying actors, no new assets to load."));
 		DestroyAttachedActors(ActorChanges.ActorsToDestroy);
+		RefreshMergeItemAttachments(TargetState);
 		DebugInfo.ActorInfo = TargetState.GetActorsList();
 		PendingInvalidationCounter.Pop();
 		UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateAttachedActors: Finished (only destroyed actors)."));
@@ -1574,11 +2142,18 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 	// 4. Request loading of CustomizationDataAssets if there are assets to load
 	UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateAttachedActors: Requesting async load for %d CustomizationDataAssets."), ActorChanges.AssetIdsToLoad.Num());
 
-	UCustomizationAssetManager::StaticAsyncLoadAssetList<UCustomizationDataAsset>(
+	const uint32 Generation = InvalidationGeneration;
+	TrackInvalidationLoad(UCustomizationAssetManager::StaticAsyncLoadAssetList<UCustomizationDataAsset>(
 		ActorChanges.AssetIdsToLoad,
-		[this, &TargetStateRef = TargetState, LocalActorChanges = ActorChanges, FinalizeAndPopOnce]
+		[this, &TargetStateRef = TargetState, LocalActorChanges = ActorChanges, FinalizeAndPopOnce, Generation]
 	(TArray<UCustomizationDataAsset*> LoadedAssets) mutable
 		{
+			// Target state was replaced by a newer pipeline, its actors are spawned from that one
+			if (!IsInvalidationCurrent(Generation))
+			{
+				UE_LOG(LogCustomizationComponent, Verbose, TEXT("InvalidateAttachedActors: Pipeline %u was superseded, skipping."), Generation);
+				return;
+			}
 			UE_LOG(LogCustomizationComponent, Log, TEXT("InvalidateAttachedActors: Async load completed. Loaded %d CustomizationDataAssets."), LoadedAssets.Num());
 
 			// 5. Destroy old actors (if any were marked for destruction)
@@ -1589,7 +2164,7 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 
 			// 6. Spawn new actors based on loaded assets
 			// Collect all spawned actors for a single broadcast
-			TMap<FName, TArray<TWeakObjectPtr<AActor>>> NewSpawnedActorsMap;
+			TMap<FCustomizationItemHandle, TArray<TWeakObjectPtr<AActor>>> NewSpawnedActorsMap;
 			TArray<AActor*> AllRawSpawnedActorsForEvent; 
 
 			for (UCustomizationDataAsset* DataAsset : LoadedAssets)
@@ -1601,22 +2176,22 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 				}
 
 				const FPrimaryAssetId LoadedAssetId = DataAsset->GetPrimaryAssetId();
-				const FName* ItemSlugPtr = LocalActorChanges.AssetIdToSlugMapForLoad.Find(LoadedAssetId);
+				const FCustomizationItemHandle* ItemPtr = LocalActorChanges.AssetIdToItemMapForLoad.Find(LoadedAssetId);
 
-				if (!ItemSlugPtr)
+				if (!ItemPtr)
 				{
-					UE_LOG(LogCustomizationComponent, Warning, TEXT("InvalidateAttachedActors: Loaded asset %s not found in AssetIdToSlugMapForLoad. Skipping spawn."), *LoadedAssetId.ToString());
+					UE_LOG(LogCustomizationComponent, Warning, TEXT("InvalidateAttachedActors: Loaded asset %s not found in AssetIdToItemMapForLoad. Skipping spawn."), *LoadedAssetId.ToString());
 					continue;
 				}
-				const FName ItemSlug = *ItemSlugPtr;
-				// const ECustomizationSlotType* SlotTypePtr = LocalActorChanges.SlugToSlotMapForLoad.Find(ItemSlug); // If needed later
+				const FCustomizationItemHandle Item = *ItemPtr;
+				// const ECustomizationSlotType* SlotTypePtr = LocalActorChanges.ItemToSlotMapForLoad.Find(Item); // If needed later
 
 				TArray<TWeakObjectPtr<AActor>> SpawnedActorPtrsForItem;
 				TArray<AActor*> RawSpawnedActorsForItemEvent;
 
 				SpawnAndAttachActorsForItem(
 					DataAsset,
-					ItemSlug,
+					Item,
 					OwningCharacter.Get(),
 					GetWorld(),
 					SpawnedActorPtrsForItem,
@@ -1625,7 +2200,7 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 
 				if (!SpawnedActorPtrsForItem.IsEmpty())
 				{
-					NewSpawnedActorsMap.Add(ItemSlug, SpawnedActorPtrsForItem);
+					NewSpawnedActorsMap.Add(Item, SpawnedActorPtrsForItem);
 				}
 				if (!RawSpawnedActorsForItemEvent.IsEmpty())
 				{
@@ -1660,24 +2235,79 @@ void UCustomizationComponent::InvalidateAttachedActors(FCustomizationContextData
 				FEquippedItemsInSlotInfo& ItemsInSlot = Pair.Value;
 				for (FEquippedItemActorsInfo& ActorInfo : ItemsInSlot.EquippedItemActors)
 				{
-					if (TArray<TWeakObjectPtr<AActor>>* FoundSpawnedActors = NewSpawnedActorsMap.Find(ActorInfo.ItemSlug))
+					if (TArray<TWeakObjectPtr<AActor>>* FoundSpawnedActors = NewSpawnedActorsMap.Find(ActorInfo.Item))
 					{
 						ActorInfo.ItemRelatedActors = *FoundSpawnedActors;
-						UE_LOG(LogCustomizationComponent, Verbose, TEXT("InvalidateAttachedActors: Updated TargetStateRef.ItemRelatedActors for slug %s with %d actors."), *ActorInfo.ItemSlug.ToString(), FoundSpawnedActors->Num());
+						UE_LOG(LogCustomizationComponent, Verbose, TEXT("InvalidateAttachedActors: Updated TargetStateRef.ItemRelatedActors for slug %s with %d actors."), *ActorInfo.Item.ToString(), FoundSpawnedActors->Num());
 					}
 				}
 			}
 
 			// 9. Finalize and update debug information
+			RefreshMergeItemAttachments(TargetStateRef);
 			DebugInfo.ActorInfo = TargetStateRef.GetActorsList();
 			FinalizeAndPopOnce(TEXT("Finished processing attached actors."));
-		});
+		}));
 }
 
 void UCustomizationComponent::StartInvalidationTimer(const FCustomizationContextData& TargetState)
 {
 	CreateTimerIfNeeded();
-	InvalidationTimer->Start(3.0f, 1, UTimerComponent::ETimerMode::FrameDelay);
+
+	const double Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+	const double RequestGap = Now - LastInvalidationRequestTime;
+	const bool bSameFrame = LastInvalidationRequestFrame == GFrameCounter;
+	LastInvalidationRequestTime = Now;
+	LastInvalidationRequestFrame = GFrameCounter;
+
+	// 1. Requests of one frame share the flush already scheduled, bulk equips run one pipeline
+	if (bSameFrame && InvalidationTimer->IsRunning())
+	{
+		return;
+	}
+
+	// 2. No adaptive window, flush at the end of the frame
+	if (!CoalescingPolicy.bAdaptiveWindow || RequestGap >= CoalescingPolicy.MaxLatencySeconds)
+	{
+		SmoothedRequestGap = 0.f;
+		CoalescingDeadline = Now + CoalescingPolicy.MaxLatencySeconds;
+		InvalidationTimer->Start(0.f, 1, UTimerComponent::ETimerMode::TimeDelay);
+		return;
+	}
+
+	// 3. Burst, wait until requests go quiet for a few of their gaps but never past the deadline
+	if (!InvalidationTimer->IsRunning())
+	{
+		CoalescingDeadline = Now + CoalescingPolicy.MaxLatencySeconds;
+	}
+	SmoothedRequestGap = SmoothedRequestGap > 0.f ? FMath::Lerp(SmoothedRequestGap, static_cast<float>(RequestGap), 0.5f) : static_cast<float>(RequestGap);
+
+	const double QuietSeconds = FMath::Max<double>(CoalescingPolicy.MinQuietSeconds, SmoothedRequestGap * CoalescingPolicy.QuietGapMultiplier);
+	const double Delay = FMath::Max(FMath::Min(QuietSeconds, CoalescingDeadline - Now), 0.0);
+	UE_LOG(LogCustomizationComponent, Verbose, TEXT("StartInvalidationTimer: Collapsing burst, flushing in %.3f s (request gap %.3f s)."), Delay, SmoothedRequestGap);
+	InvalidationTimer->Start(static_cast<float>(Delay), 1, UTimerComponent::ETimerMode::TimeDelay);
+}
+
+bool UCustomizationComponent::TryInvalidateLeadingEdge(const FCustomizationContextData& TargetState, ECustomizationInvalidationReason ExplicitReason)
+{
+	if (!CoalescingPolicy.bAdaptiveWindow || DeferredTargetState.IsSet() || (InvalidationTimer.IsValid() && InvalidationTimer->IsRunning()))
+	{
+		return false;
+	}
+
+	const double Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+	if (Now - LastInvalidationRequestTime < CoalescingPolicy.MaxLatencySeconds)
+	{
+		return false;
+	}
+
+	// Requests following within the window measure their gap from this one and start a burst
+	LastInvalidationRequestTime = Now;
+	LastInvalidationRequestFrame = GFrameCounter;
+	SmoothedRequestGap = 0.f;
+	UE_LOG(LogCustomizationComponent, Verbose, TEXT("Invalidate: Isolated request, invalidating on the leading edge."));
+	InvalidateImmediate(TargetState, ExplicitReason);
+	return true;
 }
 
 void UCustomizationComponent::CreateTimerIfNeeded()
@@ -1744,7 +2374,7 @@ FAttachedActorChanges UCustomizationComponent::DetermineAttachedActorChanges(con
 			if (TargetItemsInSlot)
 			{
 				if (TargetItemsInSlot->EquippedItemActors.ContainsByPredicate(
-					[&CurrentActorInfo](const FEquippedItemActorsInfo& TargetActorInfo) { return TargetActorInfo.ItemSlug == CurrentActorInfo.ItemSlug; }))
+					[&CurrentActorInfo](const FEquippedItemActorsInfo& TargetActorInfo) { return TargetActorInfo.Item == CurrentActorInfo.Item; }))
 				{
 					bFoundInTarget = true;
 				}
@@ -1752,7 +2382,7 @@ FAttachedActorChanges UCustomizationComponent::DetermineAttachedActorChanges(con
 
 			if (!bFoundInTarget)
 			{
-				Changes.ActorsToDestroy.Add(CurrentActorInfo.ItemSlug, CurrentActorInfo.ItemRelatedActors); 
+				Changes.ActorsToDestroy.Add(CurrentActorInfo.Item, CurrentActorInfo.ItemRelatedActors); 
 			}
 		}
 	}
@@ -1770,7 +2400,7 @@ FAttachedActorChanges UCustomizationComponent::DetermineAttachedActorChanges(con
 			if (CurrentItemsInSlot)
 			{
 				if (CurrentItemsInSlot->EquippedItemActors.ContainsByPredicate(
-					[&TargetActorInfo](const FEquippedItemActorsInfo& CurrentActorInfo) { return CurrentActorInfo.ItemSlug == TargetActorInfo.ItemSlug; }))
+					[&TargetActorInfo](const FEquippedItemActorsInfo& CurrentActorInfo) { return CurrentActorInfo.Item == TargetActorInfo.Item; }))
 				{
 					bFoundInCurrent = true;
 				}
@@ -1779,16 +2409,16 @@ FAttachedActorChanges UCustomizationComponent::DetermineAttachedActorChanges(con
 			if (!bFoundInCurrent)
 			{
 				// This item is new in the target state for this slot, so we need to load its asset.
-				FPrimaryAssetId AssetId = CommonUtilities::ItemSlugToCustomizationAssetId(TargetActorInfo.ItemSlug);
+				FPrimaryAssetId AssetId = CommonUtilities::ItemHandleToCustomizationAssetId(TargetActorInfo.Item);
 				if (AssetId.IsValid())
 				{
 					Changes.AssetIdsToLoad.AddUnique(AssetId);
-					Changes.AssetIdToSlugMapForLoad.Add(AssetId, TargetActorInfo.ItemSlug);
-					Changes.SlugToSlotMapForLoad.Add(TargetActorInfo.ItemSlug, SlotTag);
+					Changes.AssetIdToItemMapForLoad.Add(AssetId, TargetActorInfo.Item);
+					Changes.ItemToSlotMapForLoad.Add(TargetActorInfo.Item, SlotTag);
 				}
 				else
 				{
-					UE_LOG(LogCustomizationComponent, Warning, TEXT("DetermineAttachedActorChanges: Invalid AssetId for ItemSlug: %s. Cannot load for spawning."), *TargetActorInfo.ItemSlug.ToString());
+					UE_LOG(LogCustomizationComponent, Warning, TEXT("DetermineAttachedActorChanges: Invalid AssetId for ItemSlug: %s. Cannot load for spawning."), *TargetActorInfo.Item.ToString());
 				}
 			}
 		}
@@ -1796,7 +2426,7 @@ FAttachedActorChanges UCustomizationComponent::DetermineAttachedActorChanges(con
 	return Changes;
 }
 
-void UCustomizationComponent::DestroyAttachedActors(const TMap<FName, TArray<TWeakObjectPtr<AActor>>>& ActorsToDestroy)
+void UCustomizationComponent::DestroyAttachedActors(const TMap<FCustomizationItemHandle, TArray<TWeakObjectPtr<AActor>>>& ActorsToDestroy)
 {
 	for (const auto& Pair : ActorsToDestroy)
 	{
@@ -1814,6 +2444,59 @@ void UCustomizationComponent::DestroyAttachedActors(const TMap<FName, TArray<TWe
 	}
 }
 
+void UCustomizationComponent::TrackInvalidationLoad(const TSharedPtr<FStreamableHandle>& LoadHandle)
+{
+	if (!LoadHandle.IsValid())
+	{
+		return;
+	}
+	InvalidationLoadHandles.RemoveAll([](const TSharedPtr<FStreamableHandle>& Handle) { return !Handle->IsLoadingInProgress(); });
+	InvalidationLoadHandles.Add(LoadHandle);
+}
+
+void UCustomizationComponent::CancelInFlightInvalidation()
+{
+	// Asset manager hands every requester of a loading asset the same handle, cancelling it would cancel the loads of other
+	// characters too. Handles are only released, generation check drops the callbacks of the superseded pipeline.
+	InvalidationLoadHandles.Reset();
+
+	// Steps of the cancelled pipeline never pop, the next one pushes its own
+	PendingInvalidationCounter.Reset();
+	bStepMergeHoldsPipeline = false;
+	InFlightInvalidationReason = ECustomizationInvalidationReason::None;
+}
+
+void UCustomizationComponent::DestroySupersededActors()
+{
+	TSet<const AActor*> ShownActors;
+	for (const auto& SlotPair : CurrentCustomizationState.EquippedCustomizationItemActors)
+	{
+		for (const FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors)
+		{
+			for (const TWeakObjectPtr<AActor>& Actor : ActorInfo.ItemRelatedActors)
+			{
+				ShownActors.Add(Actor.Get());
+			}
+		}
+	}
+
+	TMap<FCustomizationItemHandle, TArray<TWeakObjectPtr<AActor>>> ActorsToDestroy;
+	for (const auto& SlotPair : ProcessingTargetState.EquippedCustomizationItemActors)
+	{
+		for (const FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors)
+		{
+			for (const TWeakObjectPtr<AActor>& Actor : ActorInfo.ItemRelatedActors)
+			{
+				if (Actor.IsValid() && !ShownActors.Contains(Actor.Get()))
+				{
+					ActorsToDestroy.FindOrAdd(ActorInfo.Item).Add(Actor);
+				}
+			}
+		}
+	}
+	DestroyAttachedActors(ActorsToDestroy);
+}
+
 void UCustomizationComponent::BeginPlay()
 {
 	Super::BeginPlay();
@@ -1862,9 +2545,21 @@ void UCustomizationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	DeferredReason = ECustomizationInvalidationReason::None;
 
 	PendingInvalidationCounter.OnTriggered.RemoveAll(this);
+	CancelInFlightInvalidation();
+	// Completions still on their way belong to no pipeline or merge
+	++InvalidationGeneration;
+	++MergeGeneration;
+	UMeshMergeSubsystem::CancelMergeRequest(GetWorld(), this);
+	DiscardSpeculativeMerges();
+	// Merged mesh on display goes back to the pool with the character
+	if (UCustomizationSettings::Get()->GetMeshMergeMethod() != EMeshMergeMethod::MasterPose)
+	{
+		SetShownMergedMesh(nullptr);
+	}
 	
 	CachedBodySkinMaterialForCurrentSomatotype = nullptr;
 	CurrentCustomizationState.ClearAttachedActors();
+	CurrentLoadout.Reset();
 	ProcessingTargetState.ClearAttachedActors(); 
     
 	InvalidationContext.ClearAll();
@@ -1872,7 +2567,7 @@ void UCustomizationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 }
 
-void UCustomizationComponent::AddItemToTargetState(const FName& ItemSlug, FCustomizationContextData& InOutTargetState)
+void UCustomizationComponent::AddItemToTargetState(FCustomizationItemHandle ItemHandle, FCustomizationContextData& InOutTargetState)
 {
 	if (!LoadedSlotMapping)
 	{
@@ -1880,23 +2575,22 @@ void UCustomizationComponent::AddItemToTargetState(const FName& ItemSlug, FCusto
 		return;
 	}
 
-	const FPrimaryAssetId ItemCustomizationAssetId = CommonUtilities::ItemSlugToCustomizationAssetId(ItemSlug);
+	const FCustomizationItemInfo* ItemInfo = FCustomizationItemRegistry::Get().Find(ItemHandle);
+	if (!ItemInfo || ItemInfo->ItemType == EItemType::None || !ItemInfo->UISlotCategoryTag.IsValid())
+	{
+		UE_LOG(LogCustomizationComponent, Warning, TEXT("AddItemToTargetState: Could not get valid registry data for item %s."), *ItemHandle.ToString());
+		return;
+	}
+	const FName& ItemSlug = ItemInfo->Slug;
+
+	const FPrimaryAssetId ItemCustomizationAssetId = CommonUtilities::ItemHandleToCustomizationAssetId(ItemHandle);
 	if (!ItemCustomizationAssetId.IsValid()) return;
 	
 	const auto CustomizationAssetClass = CustomizationUtilities::GetClassForCustomizationAsset(ItemCustomizationAssetId);
 	if (!CustomizationAssetClass) return;
 
-	auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
-	ensure(AssetManager);
-	
-	const CustomizationSlots::FItemRegistryData ItemData = CustomizationSlots::GetItemDataFromRegistry(ItemSlug);
-	if (!ItemData.IsValid())
-	{
-		UE_LOG(LogCustomizationComponent, Warning, TEXT("AddItemToTargetState: Could not get valid registry data for item %s."), *ItemSlug.ToString());
-		return;
-	}
-	const FGameplayTag& UISlotTag = ItemData.InUISlotCategoryTag;
-	const EItemType ItemType = ItemData.ItemType;
+	const FGameplayTag& UISlotTag = ItemInfo->UISlotCategoryTag;
+	const EItemType ItemType = ItemInfo->ItemType;
 	
 	if (ItemType == EItemType::Skin)
 	{
@@ -1904,7 +2598,7 @@ void UCustomizationComponent::AddItemToTargetState(const FName& ItemSlug, FCusto
 		FGameplayTag ItemTechnicalSlot = CommonUtilities::GetItemSlotTagForSlug(ItemSlug, SlugToSlotTagCache);
 		if (ItemTechnicalSlot.IsValid())
         {
-            InOutTargetState.EquippedMaterialsMap.Add(ItemTechnicalSlot, ItemSlug);
+            InOutTargetState.SetMaterial(ItemTechnicalSlot, ItemHandle);
 			UE_LOG(LogCustomizationComponent, Log, TEXT("AddItemToTargetState: Applying skin '%s' to technical slot '%s'."), *ItemSlug.ToString(), *ItemTechnicalSlot.ToString());
         }
         else
@@ -1914,30 +2608,37 @@ void UCustomizationComponent::AddItemToTargetState(const FName& ItemSlug, FCusto
 	}
 	else // base item (BodyPart, Actor, etc.)
 	{
-		// 1. Clear all technical slots associated with this UI slot.
-		if (const FGameplayTagContainer* TechnicalSlotsToClear = LoadedSlotMapping->UISlotToTechnicalSlots.Find(UISlotTag))
+		// 1. Clear all technical slots associated with this UI slot. Mask only when it covers every one of them.
+		const CustomizationSlots::FSlotTable& SlotTable = CustomizationSlots::FSlotTable::Get();
+		const int32 UISlotIndex = SlotTable.GetSlotIndex(UISlotTag);
+		if (UISlotIndex != INDEX_NONE && (IncompleteSlotMappingUISlots & (CustomizationSlots::FSlotMask(1) << UISlotIndex)) == 0)
+		{
+			CustomizationSlots::ForEachSlot(LoadedSlotMappingMasks[UISlotIndex], [&](int32 TechSlotIndex)
+			{
+				InOutTargetState.RemoveSlot(SlotTable.GetSlotTag(TechSlotIndex));
+			});
+		}
+		else if (const FGameplayTagContainer* TechnicalSlotsToClear = LoadedSlotMapping->UISlotToTechnicalSlots.Find(UISlotTag))
 		{
 			for (const FGameplayTag& TechSlot : *TechnicalSlotsToClear)
 			{
-				InOutTargetState.EquippedBodyPartsItems.Remove(TechSlot);
-				InOutTargetState.EquippedMaterialsMap.Remove(TechSlot);
-				InOutTargetState.EquippedCustomizationItemActors.Remove(TechSlot);
+				InOutTargetState.RemoveSlot(TechSlot);
 			}
 		}
 
 		// 2. Add the new item to its correct map.
 		if (CustomizationAssetClass->IsChildOf(UCustomizationDataAsset::StaticClass()))
 		{
-			const FGameplayTag SlotTag = ItemData.InUISlotCategoryTag;
+			const FGameplayTag SlotTag = ItemInfo->UISlotCategoryTag;
 			if (OnlyOneItemInSlot)
 			{
-				const FEquippedItemActorsInfo EquippedItemActorsInfo = {ItemSlug, {}};
+				const FEquippedItemActorsInfo EquippedItemActorsInfo = {ItemHandle, {}};
 				const FEquippedItemsInSlotInfo EquippedItemsInSlotInfo = {{EquippedItemActorsInfo}};
-				InOutTargetState.EquippedCustomizationItemActors.Emplace(SlotTag, EquippedItemsInSlotInfo);
+				InOutTargetState.SetActorSlot(SlotTag, EquippedItemsInSlotInfo);
 			}
 			else
 			{
-				InOutTargetState.ReplaceOrAddSpawnedActors(ItemSlug, SlotTag, {});
+				InOutTargetState.ReplaceOrAddSpawnedActors(ItemHandle, SlotTag, {});
 			}
 		}
 		else
@@ -1947,7 +2648,7 @@ void UCustomizationComponent::AddItemToTargetState(const FName& ItemSlug, FCusto
 			{
 				if (CustomizationAssetClass->IsChildOf(UBodyPartAsset::StaticClass()))
 				{
-					InOutTargetState.EquippedBodyPartsItems.Add(ItemTechnicalSlot, ItemSlug);
+					InOutTargetState.SetBodyPart(ItemTechnicalSlot, ItemHandle);
 				}
 				// Note: Applying a material directly is now handled by the EItemType::Skin case above.
 				// This branch is now only for BodyParts and Actors.
@@ -1980,6 +2681,7 @@ void UCustomizationComponent::LoadSlotMappingAndExecute(TFunction<void()> OnComp
 		LoadedSlotMapping = SlotMappingAsset.Get();
 		if (LoadedSlotMapping)
 		{
+			LoadedSlotMappingMasks = CustomizationSlots::FSlotTable::Get().CompileSlotMapping(LoadedSlotMapping, IncompleteSlotMappingUISlots);
 			if(OnComplete) OnComplete();
 		}
 		else
@@ -2022,24 +2724,60 @@ void UCustomizationComponent::DrawDebugTextBlock(const FVector& Location, const
 	);
 }
 
-void UCustomizationComponent::OnMergeCompleted(USkeletalMesh* MergedMesh)
+void UCustomizationComponent::SetShownMergedMesh(USkeletalMesh* MergedMesh)
 {
+	USkeletalMeshComponent* MainMesh = OwningCharacter.IsValid() ? OwningCharacter->GetMesh() : nullptr;
+	if (!MainMesh)
+	{
+		return;
+	}
+
+	// Replaced merged mesh goes back to the pool once no other component shows it
+	USkeletalMesh* ReplacedMesh = MainMesh->GetSkeletalMeshAsset();
+	MainMesh->SetSkeletalMeshAsset(MergedMesh);
+	if (ReplacedMesh != MergedMesh)
+	{
+		UMeshMergeSubsystem::RetainMergedMesh(GetWorld(), MergedMesh);
+		UMeshMergeSubsystem::ReleaseMergedMesh(GetWorld(), ReplacedMesh);
+	}
+}
+
+void UCustomizationComponent::OnMergeCompleted(USkeletalMesh* MergedMesh, uint32 Generation, TOptional<uint32> HeldInvalidationGeneration)
+{
+	// Part set of a superseded state, a newer merge will be shown instead and releases any hold
+	if (Generation != MergeGeneration)
+	{
+		UE_LOG(LogCustomizationComponent, Verbose, TEXT("[MESH MERGE] Dropping merge %u, superseded by %u."), Generation, MergeGeneration);
+		UMeshMergeSubsystem::DiscardMergedMesh(GetWorld(), MergedMesh);
+		return;
+	}
 	if (!OwningCharacter.IsValid() || !OwningCharacter->GetMesh())
 	{
 		UE_LOG(LogCustomizationComponent, Error, TEXT("[MESH MERGE] OwningCharacter or its mesh is invalid!"));
-		HandleInvalidationPipelineCompleted();
+		UMeshMergeSubsystem::DiscardMergedMesh(GetWorld(), MergedMesh);
+		bMergeRequestPending = false;
+		TearDownMergeBridge();
+		FinishMerge(HeldInvalidationGeneration);
 		return;
 	}
 	if (!MergedMesh)
 	{
 		UE_LOG(LogCustomizationComponent, Error, TEXT("[MESH MERGE] Merge failed, merged mesh is nullptr!"));
 		// If merge fails, we might want to clear the mesh to indicate an error state
-		OwningCharacter->GetMesh()->SetSkeletalMeshAsset(nullptr);
-		HandleInvalidationPipelineCompleted();
+		SetShownMergedMesh(nullptr);
+		bMergeRequestPending = false;
+		ShownMeshesToMergeData.Empty();
+		ShownMaterialMap.Empty();
+		TearDownMergeBridge();
+		FinishMerge(HeldInvalidationGeneration);
 		return;
 	}
-	// Set merged mesh to main component
-	OwningCharacter->GetMesh()->SetSkeletalMeshAsset(MergedMesh);
+	// Set merged mesh to main component, followers bridging the merge go away in the same frame
+	SetShownMergedMesh(MergedMesh);
+	bMergeRequestPending = false;
+	ShownMeshesToMergeData = LastMeshesToMergeData;
+	ShownMaterialMap = MergedMaterialMap;
+	TearDownMergeBridge();
 	// Apply materials based on the map filled by the merge subsystem
 	USkeletalMeshComponent* TargetMeshComponent = OwningCharacter->GetMesh();
     
@@ -2047,21 +2785,21 @@ void UCustomizationComponent::OnMergeCompleted(USkeletalMesh* MergedMesh)
 	auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
 	if (!AssetManager)
 	{
-		HandleInvalidationPipelineCompleted();
+		FinishMerge(HeldInvalidationGeneration);
 		return;
 	}
     
 	for (const auto& MaterialPair : ProcessingTargetState.EquippedMaterialsMap)
 	{
 		const FGameplayTag& SlotTag = MaterialPair.Key;
-		const FName& SkinSlug = MaterialPair.Value;
+		const FCustomizationItemHandle& SkinItem = MaterialPair.Value;
 
 		for (const auto& MapPair : MergedMaterialMap)
 		{
 			if (MapPair.Value == SlotTag)
 			{
 				const int32 MaterialIndex = MapPair.Key;
-				FPrimaryAssetId SkinAssetId = CommonUtilities::ItemSlugToCustomizationAssetId(SkinSlug);
+				FPrimaryAssetId SkinAssetId = CommonUtilities::ItemHandleToCustomizationAssetId(SkinItem);
 
 				if (auto* MaterialAsset = AssetManager->LoadPrimaryAsset<UMaterialCustomizationDataAsset>(SkinAssetId))
 				{
@@ -2069,7 +2807,7 @@ void UCustomizationComponent::OnMergeCompleted(USkeletalMesh* MergedMesh)
 					{
 						UMaterialInterface* SkinMaterial = MaterialAsset->IndexWithApplyingMaterial[0];
 						TargetMeshComponent->SetMaterial(MaterialIndex, SkinMaterial);
-						UE_LOG(LogCustomizationComponent, Log, TEXT("Applied skin %s to merged mesh at index %d for slot %s"), *SkinSlug.ToString(), MaterialIndex, *SlotTag.ToString());
+						UE_LOG(LogCustomizationComponent, Log, TEXT("Applied skin %s to merged mesh at index %d for slot %s"), *SkinItem.ToString(), MaterialIndex, *SlotTag.ToString());
 					}
 				}
 			}
@@ -2078,5 +2816,21 @@ void UCustomizationComponent::OnMergeCompleted(USkeletalMesh* MergedMesh)
 	ApplyMergedMaterials();
 	
 	UE_LOG(LogCustomizationComponent, Log, TEXT("[MESH MERGE] Successfully applied merged mesh to main component."));
-	HandleInvalidationPipelineCompleted();
+	FinishMerge(HeldInvalidationGeneration);
+}
+
+void UCustomizationComponent::FinishMerge(TOptional<uint32> HeldInvalidationGeneration)
+{
+	if (!HeldInvalidationGeneration.IsSet())
+	{
+		HandleInvalidationPipelineCompleted();
+		return;
+	}
+
+	// Held pipeline completes through its counter, once. A superseded pipeline's counter was reset already.
+	if (bStepMergeHoldsPipeline && IsInvalidationCurrent(HeldInvalidationGeneration.GetValue()))
+	{
+		bStepMergeHoldsPipeline = false;
+		PendingInvalidationCounter.Pop();
+	}
 }
@@ -40,7 +40,8 @@ void UInventoryWidget::NativeOnActivated()
     ensureAlways(ItemsList);
     ItemsList->OnItemClicked().AddUObject(this, &ThisClass::OnListItemClicked);
     ItemsList->OnEntryWidgetGenerated().AddUObject(this, &ThisClass::OnMainListItemObjectSet);
-    //ItemsList->OnItemIsHoveredChanged().AddUObject(this, &ThisClass::OnItemIsHoveredChanged);
+    ItemsList->OnItemIsHoveredChanged().AddUObject(this, &ThisClass::OnItemIsHoveredChanged);
+    ItemsList->OnItemSelectionChanged().AddUObject(this, &ThisClass::OnListItemSelectionChanged);
     
     ensureAlways(InventorySlotsButtonGroup);
     OnRequestColorPalette.BindUObject(this, &ThisClass::UInventoryWidget::HandleRequestColorPalette);
@@ -56,6 +57,14 @@ void UInventoryWidget::NativeOnActivated()
 void UInventoryWidget::NativeOnDeactivated()
 {
     InventorySlotsButtonGroup->OnButtonBaseClicked.Clear();
+    ItemsList->OnItemIsHoveredChanged().RemoveAll(this);
+    ItemsList->OnItemSelectionChanged().RemoveAll(this);
+
+    // Outfits browsed but not equipped are of no use once inventory is closed
+    if (InventoryViewModel)
+    {
+        InventoryViewModel->ClearItemPreviews();
+    }
     
     Super::NativeOnDeactivated();
 }
@@ -134,6 +143,25 @@ void UInventoryWidget::OnListItemClicked(UObject* ItemObject)
     // }
 }
 
+void UInventoryWidget::OnItemIsHoveredChanged(UObject* ItemObject, bool bIsHovered)
+{
+    const auto* InventoryListItemObject = Cast<UInventoryListItemData>(ItemObject);
+    if (bIsHovered && InventoryListItemObject && InventoryViewModel)
+    {
+        InventoryViewModel->OnEntryItemPreviewed(InventoryListItemObject->ItemSlug);
+    }
+}
+
+void UInventoryWidget::OnListItemSelectionChanged(UObject* ItemObject)
+{
+    // Gamepad navigation selects entries instead of hovering them
+    const auto* InventoryListItemObject = Cast<UInventoryListItemData>(ItemObject);
+    if (InventoryListItemObject && InventoryViewModel)
+    {
+        InventoryViewModel->OnEntryItemPreviewed(InventoryListItemObject->ItemSlug);
+    }
+}
+
 void UInventoryWidget::OnBackButtonClicked()
 {
     // For correct implementation of BackButton logic we need UI framework which maintains multiple HUD states and manages layers for windows and popups
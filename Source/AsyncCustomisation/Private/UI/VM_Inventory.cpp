@@ -150,6 +150,23 @@ void UVM_Inventory::OnEntryItemClicked(const FName& InItemSlug)
 	}
 }
 
+void UVM_Inventory::OnEntryItemPreviewed(const FName& InItemSlug)
+{
+	// Clicking an equipped item unequips it, only equipping is worth merging ahead
+	if (CustomizationComponent.IsValid() && InItemSlug != NAME_None && !IsItemSlugEquipped(InItemSlug))
+	{
+		CustomizationComponent->RequestSpeculativeMerge(InItemSlug);
+	}
+}
+
+void UVM_Inventory::ClearItemPreviews()
+{
+	if (CustomizationComponent.IsValid())
+	{
+		CustomizationComponent->DiscardSpeculativeMerges();
+	}
+}
+
 void UVM_Inventory::RequestUnequipSlot(FGameplayTag SlotToUnequip)
 {
 	
@@ -253,6 +270,8 @@ void UVM_Inventory::HandleEquippedItemsUpdate(const FCustomizationContextData& N
 	// --- Step 1: Calculate new map ---
 	 TMap<FGameplayTag, FInventoryEquippedItemData> NewCalculatedEquippedMap;
 	TSet<FName> AllEquippedSlugsForState;
+	// The state holds item handles, the view model works with slugs
+	const FCustomizationItemRegistry& ItemRegistry = FCustomizationItemRegistry::Get();
 
 	auto FindMetaAssetBySlug = [this](const FName Slug) -> UItemMetaAsset* {
 		if (Slug.IsNone())
@@ -299,28 +318,28 @@ void UVM_Inventory::HandleEquippedItemsUpdate(const FCustomizationContextData& N
 	};
 	
 	// Collect ALL equipped slugs first, including materials, for 'IsEquipped' checks.
-	for (const auto& Pair : NewState.EquippedBodyPartsItems) { AllEquippedSlugsForState.Add(Pair.Value); }
-	for (const auto& Pair : NewState.EquippedMaterialsMap) { AllEquippedSlugsForState.Add(Pair.Value); }
+	for (const auto& Pair : NewState.EquippedBodyPartsItems) { AllEquippedSlugsForState.Add(ItemRegistry.GetSlug(Pair.Value)); }
+	for (const auto& Pair : NewState.EquippedMaterialsMap) { AllEquippedSlugsForState.Add(ItemRegistry.GetSlug(Pair.Value)); }
 	for (const auto& SlotPair : NewState.EquippedCustomizationItemActors)
 	{
 		for (const FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors)
 		{
-			AllEquippedSlugsForState.Add(ActorInfo.ItemSlug);
+			AllEquippedSlugsForState.Add(ItemRegistry.GetSlug(ActorInfo.Item));
 		}
 	}
 	// Now, populate the map for UI slots, IGNORING materials/skins.
-	// NewState.EquippedBodyPartsItems is now TMap<FGameplayTag, FName>
-	for (const auto& Pair : NewState.EquippedBodyPartsItems) { ProcessBaseEquippedItemSlugForMap(Pair.Value, NewCalculatedEquippedMap); }
+	// NewState.EquippedBodyPartsItems is now TMap<FGameplayTag, FCustomizationItemHandle>
+	for (const auto& Pair : NewState.EquippedBodyPartsItems) { ProcessBaseEquippedItemSlugForMap(ItemRegistry.GetSlug(Pair.Value), NewCalculatedEquippedMap); }
 	for (const auto& SlotPair : NewState.EquippedCustomizationItemActors) {
 		for (const FEquippedItemActorsInfo& ActorInfo : SlotPair.Value.EquippedItemActors) {
-			ProcessBaseEquippedItemSlugForMap(ActorInfo.ItemSlug, NewCalculatedEquippedMap);
+			ProcessBaseEquippedItemSlugForMap(ItemRegistry.GetSlug(ActorInfo.Item), NewCalculatedEquippedMap);
 		}
 	}
     
     // Step 2. Update info about skins ---
 	for (const auto& Pair : NewState.EquippedMaterialsMap)
 	{
-		const FName& SkinSlug = Pair.Value;
+		const FName SkinSlug = ItemRegistry.GetSlug(Pair.Value);
 		UItemMetaAsset* SkinMetaAsset = FindMetaAssetBySlug(SkinSlug);
 		if (SkinMetaAsset && SkinMetaAsset->ItemType == EItemType::Skin)
 		{
@@ -397,7 +416,8 @@ void UVM_Inventory::HandleEquippedItemsUpdate(const FCustomizationContextData& N
 		}
 	}
 	
-	LastKnownCustomizationState = NewState;
+	// The component interned NewState before broadcasting it
+	LastKnownCustomizationState = CustomizationComponent.IsValid() ? CustomizationComponent->GetCurrentLoadout() : FCustomizationStatePool::Get().Intern(NewState);
 }
 
 void UVM_Inventory::HandleInventoryDeltaUpdate(UItemMetaAsset* InItem, const int32 CountDelta)
@@ -764,10 +784,10 @@ void UVM_Inventory::RefreshAllViewModelData()
 	}
 	
 	const TMap<FPrimaryAssetId, int32> CurrentOwnedItems = InventoryComponent->GetOwnedItems();
-	const FCustomizationContextData CurrentCustomizationState = CustomizationComponent->GetCurrentCustomizationState();
+	const FCustomizationStateHandle& CurrentLoadout = CustomizationComponent->GetCurrentLoadout();
 	
 	bool bInventoryChanged = !(LastKnownOwnedItems == CurrentOwnedItems);
-	bool bEquipmentChanged = !(LastKnownCustomizationState == CurrentCustomizationState);
+	bool bEquipmentChanged = LastKnownCustomizationState != CurrentLoadout;
 
 	if (!bInventoryChanged && !bEquipmentChanged && !bIsLoading)
 	{
@@ -776,7 +796,7 @@ void UVM_Inventory::RefreshAllViewModelData()
 	}
 	
 	LastKnownOwnedItems = CurrentOwnedItems;
-	LastKnownCustomizationState = CurrentCustomizationState;
+	LastKnownCustomizationState = CurrentLoadout;
 	
 	TSet<FPrimaryAssetId> RequiredMetaAssetIdsSet;
 	for (const auto& Pair : LastKnownOwnedItems)
@@ -1389,8 +1409,7 @@ void UVM_Inventory::BeginDestroy()
 
 	LoadedMetaCache.Empty();
 	LastKnownOwnedItems.Empty();
-	LastKnownCustomizationState.ClearAttachedActors();
-	LastKnownCustomizationState = FCustomizationContextData();
+	LastKnownCustomizationState.Reset();
 
 	Super::BeginDestroy();
 }
@@ -4,8 +4,13 @@
 #include "Components/Core/Assets/CustomizationDataAsset.h"
 #include "Components/Core/Assets/MaterialCustomizationDataAsset.h"
 #include "Components/Core/Assets/MaterialPackCustomizationDA.h"
+#include "Constants/GlobalConstants.h"
 #include "Utilities/CommonUtilities.h"
 
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#endif
+
 UCustomizationAssetManager* UCustomizationAssetManager::GetCustomizationAssetManager()
 {
 	UCustomizationAssetManager* AssetManager = Cast<UCustomizationAssetManager>(GEngine->AssetManager);
@@ -13,6 +18,58 @@ UCustomizationAssetManager* UCustomizationAssetManager::GetCustomizationAssetMan
 	return AssetManager;
 }
 
+void UCustomizationAssetManager::PostInitialAssetScan()
+{
+	Super::PostInitialAssetScan();
+
+	ItemRegistry.Build(*this);
+
+#if WITH_EDITOR
+	// Editing an item's tags only reaches the registry through these, cooked builds never change it
+	IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+	AssetRegistry.OnAssetAdded().AddUObject(this, &ThisClass::OnItemAssetChanged);
+	AssetRegistry.OnAssetUpdated().AddUObject(this, &ThisClass::OnItemAssetChanged);
+	AssetRegistry.OnAssetRemoved().AddUObject(this, &ThisClass::OnItemAssetChanged);
+	AssetRegistry.OnAssetRenamed().AddUObject(this, &ThisClass::OnItemAssetRenamed);
+#endif
+}
+
+void UCustomizationAssetManager::BeginDestroy()
+{
+#if WITH_EDITOR
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetUpdated().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+	}
+#endif
+
+	Super::BeginDestroy();
+}
+
+const FCustomizationItemRegistry& UCustomizationAssetManager::GetItemRegistry() const
+{
+#if WITH_EDITOR
+	// Rebuilt lazily, the asset manager refreshes its primary asset data on the same events
+	if (bItemRegistryDirty)
+	{
+		bItemRegistryDirty = false;
+		ItemRegistry.Build(*this);
+	}
+#endif
+	return ItemRegistry;
+}
+
+#if WITH_EDITOR
+void UCustomizationAssetManager::OnItemAssetChanged(const FAssetData& AssetData)
+{
+	const FPrimaryAssetType AssetType = GetPrimaryAssetIdForData(AssetData).PrimaryAssetType;
+	bItemRegistryDirty |= AssetType == GLOBAL_CONSTANTS::PrimaryItemAssetType || AssetType == GLOBAL_CONSTANTS::PrimaryItemShaderAssetType;
+}
+#endif
+
 UBodyPartAsset* UCustomizationAssetManager::LoadBodyPartAssetSync(FPrimaryAssetId InBodyPartId)
 {
 	FPrimaryAssetTypeInfo TypeInfo;
@@ -0,0 +1,75 @@
+#include "Utilities/CustomizationItemRegistry.h"
+
+#include "Engine/AssetManager.h"
+#include "Components/Core/CustomizationSlotTypes.h"
+#include "Constants/GlobalConstants.h"
+#include "Utilities/CustomizationAssetManager.h"
+
+DEFINE_LOG_CATEGORY(LogCustomizationItemRegistry);
+
+FString FCustomizationItemHandle::ToString() const
+{
+	return FCustomizationItemRegistry::Get().GetSlug(*this).ToString();
+}
+
+const FCustomizationItemRegistry& FCustomizationItemRegistry::Get()
+{
+	return UCustomizationAssetManager::GetCustomizationAssetManager()->GetItemRegistry();
+}
+
+void FCustomizationItemRegistry::Build(const UAssetManager& AssetManager)
+{
+	// Known slugs keep their handle and get their info refreshed, items removed since stay resolvable by their old handle
+	TSet<FName> BuiltSlugs;
+	BuiltSlugs.Reserve(Items.Num());
+
+	// Base items first, a shader item with the same slug resolves like ItemSlugToCustomizationAssetId does
+	for (const FPrimaryAssetType& AssetType : {FPrimaryAssetType(GLOBAL_CONSTANTS::PrimaryItemAssetType), FPrimaryAssetType(GLOBAL_CONSTANTS::PrimaryItemShaderAssetType)})
+	{
+		TArray<FAssetData> AssetDataList;
+		AssetManager.GetPrimaryAssetDataList(AssetType, AssetDataList);
+		for (const FAssetData& AssetData : AssetDataList)
+		{
+			const FPrimaryAssetId MetaAssetId = AssetManager.GetPrimaryAssetIdForData(AssetData);
+			if (!MetaAssetId.IsValid())
+			{
+				continue;
+			}
+
+			bool bAlreadyBuilt = false;
+			BuiltSlugs.Add(MetaAssetId.PrimaryAssetName, &bAlreadyBuilt);
+			if (bAlreadyBuilt)
+			{
+				continue;
+			}
+
+			uint32& Handle = SlugToHandle.FindOrAdd(MetaAssetId.PrimaryAssetName, 0);
+			if (Handle == 0)
+			{
+				Items.AddDefaulted();
+				Handle = Items.Num();
+			}
+
+			FCustomizationItemInfo& Info = Items[Handle - 1];
+			Info = FCustomizationItemInfo();
+			Info.Slug = MetaAssetId.PrimaryAssetName;
+			Info.MetaAssetId = MetaAssetId;
+			Info.ItemType = CustomizationSlots::GetEnumValueFromAssetData(AssetData, "ItemType", EItemType::None);
+			Info.UISlotCategoryTag = CustomizationSlots::GetGameplayTagFromAssetData(AssetData, "UISlotCategoryTag");
+
+			FString CustomizationAssetIdString;
+			if (AssetData.GetTagValue("CustomizationAssetId", CustomizationAssetIdString))
+			{
+				Info.CustomizationAssetId = FPrimaryAssetId(CustomizationAssetIdString);
+			}
+		}
+	}
+
+	UE_LOG(LogCustomizationItemRegistry, Log, TEXT("FCustomizationItemRegistry::Build - Registered %d items, %d handles in total."), BuiltSlugs.Num(), Items.Num());
+}
+
+FCustomizationItemHandle FCustomizationItemRegistry::FindHandle(const FName& Slug) const
+{
+	const uint32* Handle = SlugToHandle.Find(Slug);
+	return FCustomizationItemHandle(Handle ? *Handle : 0);
+}
@@ -3,6 +3,9 @@
 
 #include "Utilities/CustomizationSettings.h"
 
+#include "Materials/MaterialInterface.h"
+#include "Utilities/MeshMerger/MeshMergePrebakeManifest.h"
+
 const UCustomizationSettings* UCustomizationSettings::Get()
 {
 	return GetDefault<UCustomizationSettings>();
@@ -23,6 +26,151 @@ EMeshMergeMethod UCustomizationSettings::GetMeshMergeMethod() const
 	return MeshMergeMethod;
 }
 
+float UCustomizationSettings::GetMeshMergeFrameBudgetMs() const
+{
+	return MeshMergeFrameBudgetMs;
+}
+
+bool UCustomizationSettings::GetBridgePendingMergeWithMasterPose() const
+{
+	return bBridgePendingMergeWithMasterPose;
+}
+
+bool UCustomizationSettings::GetConsolidateMergedMaterials() const
+{
+	return bConsolidateMergedMaterials;
+}
+
+bool UCustomizationSettings::GetCullCoveredSkin() const
+{
+	return bCullCoveredSkin;
+}
+
+bool UCustomizationSettings::GetAtlasMergedMaterials() const
+{
+	return bAtlasMergedMaterials && !AtlasParentMaterial.IsNull();
+}
+
+UMaterialInterface* UCustomizationSettings::GetAtlasParentMaterial() const
+{
+	return AtlasParentMaterial.LoadSynchronous();
+}
+
+FName UCustomizationSettings::GetAtlasTextureParameterName() const
+{
+	return AtlasTextureParameterName;
+}
+
+int32 UCustomizationSettings::GetMaxAtlasSize() const
+{
+	return MaxAtlasSize;
+}
+
+int32 UCustomizationSettings::GetMaxAtlasTileSize() const
+{
+	return MaxAtlasTileSize;
+}
+
+bool UCustomizationSettings::GetEnableIncrementalMeshMerge() const
+{
+	return bEnableIncrementalMeshMerge;
+}
+
+bool UCustomizationSettings::GetUseNativeMergeKernel() const
+{
+	return bUseNativeMergeKernel;
+}
+
+bool UCustomizationSettings::GetBuildMergedLODsInParallel() const
+{
+	return bBuildMergedLODsInParallel;
+}
+
+bool UCustomizationSettings::GetOptimizeMergedVertexCache() const
+{
+	return bOptimizeMergedVertexCache;
+}
+
+bool UCustomizationSettings::GetOptimizeMergedMeshMemory() const
+{
+	return bOptimizeMergedMeshMemory;
+}
+
+float UCustomizationSettings::GetMaxHalfPrecisionUVError() const
+{
+	return MaxHalfPrecisionUVError;
+}
+
+bool UCustomizationSettings::GetUseTransientSourceCopies() const
+{
+	return bUseTransientSourceCopies;
+}
+
+int32 UCustomizationSettings::GetSourceScratchPoolBudgetMB() const
+{
+	return SourceScratchPoolBudgetMB;
+}
+
+UMeshMergePrebakeManifest* UCustomizationSettings::GetPrebakeManifest() const
+{
+	return PrebakeManifest.LoadSynchronous();
+}
+
+bool UCustomizationSettings::GetPruneMergedBones() const
+{
+	return bPruneMergedBones;
+}
+
+bool UCustomizationSettings::GetBakeRigidAccessories() const
+{
+	return bBakeRigidAccessories;
+}
+
+int32 UCustomizationSettings::GetMeshMergePoolSize() const
+{
+	return MeshMergePoolSize;
+}
+
+int32 UCustomizationSettings::GetMaxCachedMergePlans() const
+{
+	return MaxCachedMergePlans;
+}
+
+bool UCustomizationSettings::GetEnableMeshMergeCache() const
+{
+	return bEnableMeshMergeCache;
+}
+
+int64 UCustomizationSettings::GetMeshMergeCacheBudgetBytes() const
+{
+	return static_cast<int64>(MeshMergeCacheBudgetMB) * 1024 * 1024;
+}
+
+bool UCustomizationSettings::GetEnableMeshMergeDiskCache() const
+{
+	return bEnableMeshMergeDiskCache;
+}
+
+int32 UCustomizationSettings::GetMeshMergeDiskCacheMaxEntries() const
+{
+	return MeshMergeDiskCacheMaxEntries;
+}
+
+bool UCustomizationSettings::GetEnableSpeculativeMerges() const
+{
+	return bEnableSpeculativeMerges;
+}
+
+int64 UCustomizationSettings::GetSpeculativeMergeBudgetBytes() const
+{
+	return static_cast<int64>(SpeculativeMergeBudgetMB) * 1024 * 1024;
+}
+
+float UCustomizationSettings::GetSpeculativeMergeLifetimeSeconds() const
+{
+	return SpeculativeMergeLifetimeSeconds;
+}
+
 void UCustomizationSettings::Clear()
 {
 	CategoryName = TEXT("Customization");
@@ -0,0 +1,110 @@
+#include "Utilities/MeshMerger/AsyncSkeletalMeshMerge.h"
+
+#include "Animation/Skeleton.h"
+#include "Utilities/MeshMerger/MeshMergeDiskCache.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+
+bool UAsyncSkeletalMeshMerge::Start(const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& InOnMeshMergeComplete, const USkeletalMesh* InPreviousMergedMesh,
+	const FMeshMergePlan* Plan)
+{
+	OnMeshMergeComplete = MoveTemp(InOnMeshMergeComplete);
+	StartTime = FPlatformTime::Seconds();
+
+	// 1. Gather on game thread
+	GatherData = MakeShared<FMeshMergeGatherData, ESPMode::ThreadSafe>();
+	if (!MeshMergeUtilities::GatherMergeData(MeshesToMergeData, *GatherData, InPreviousMergedMesh, Plan))
+	{
+		UE_LOG(LogMeshMerge, Error, TEXT("UAsyncSkeletalMeshMerge::Start - Gather phase failed"));
+		Complete(nullptr);
+		return false;
+	}
+
+	for (const FMeshMergeSource& Source : GatherData->Sources)
+	{
+		SourceMeshes.Add(const_cast<USkeletalMesh*>(Source.Mesh));
+	}
+	Skeleton = SourceMeshes[0]->GetSkeleton();
+	for (const FMeshMergeAtlasEntry& Entry : GatherData->AtlasPlan.Entries)
+	{
+		AtlasTextures.Add(const_cast<UTexture2D*>(Entry.Texture));
+	}
+	if (GatherData->PreviousLayout.IsValid())
+	{
+		PreviousMergedMesh = const_cast<USkeletalMesh*>(InPreviousMergedMesh);
+	}
+	GatherData->DiskCacheFingerprint = MeshMergeDiskCache::MakeFingerprint(*GatherData);
+
+	// Disk cache hits read no source buffers, everything else needs CPU readable sources before the worker starts
+	if (!MeshMergeDiskCache::Contains(GatherData->DiskCacheFingerprint) && !MeshMergeUtilities::AcquireSourceCopies(*GatherData))
+	{
+		UE_LOG(LogMeshMerge, Error, TEXT("UAsyncSkeletalMeshMerge::Start - Source read back failed"));
+		Complete(nullptr);
+		return false;
+	}
+
+	// 2. Read from disk cache or build buffers on worker. Task only captures plain data, never this object.
+	BuildData = MakeShared<FMergedMeshBuildData, ESPMode::ThreadSafe>();
+	BuildTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [GatherData = GatherData, BuildData = BuildData]()
+	{
+		if (MeshMergeDiskCache::Load(*GatherData, *BuildData))
+		{
+			return;
+		}
+
+		MeshMergeUtilities::BuildMergedMeshData(*GatherData, *BuildData);
+		MeshMergeDiskCache::Save(*GatherData, *BuildData);
+	});
+
+	UE_LOG(LogMeshMerge, Verbose, TEXT("UAsyncSkeletalMeshMerge::Start - Launched build of %d parts, %d LODs"), GatherData->Sources.Num(), GatherData->NumLODs);
+	return true;
+}
+
+bool UAsyncSkeletalMeshMerge::TryFinish()
+{
+	if (!GatherData.IsValid())
+	{
+		return true;
+	}
+
+	if (!BuildTask.IsCompleted())
+	{
+		return false;
+	}
+
+	// 3. Create mesh on game thread
+	USkeletalMesh* PooledMesh = BuildData->bSucceeded ? UMeshMergeSubsystem::AcquirePooledMesh(GetWorld()) : nullptr;
+	USkeletalMesh* MergedMesh = MeshMergeUtilities::CreateMergedMesh(*GatherData, *BuildData, Skeleton, PooledMesh);
+	if (!MergedMesh)
+	{
+		UE_LOG(LogMeshMerge, Error, TEXT("UAsyncSkeletalMeshMerge::TryFinish - Build phase failed"));
+	}
+	else
+	{
+		UE_LOG(LogMeshMerge, Verbose, TEXT("UAsyncSkeletalMeshMerge::TryFinish - Merged %d parts in %.2f ms"),
+			GatherData->Sources.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	Complete(MergedMesh);
+	return true;
+}
+
+void UAsyncSkeletalMeshMerge::Cancel()
+{
+	BuildTask.Wait();
+	Complete(nullptr);
+}
+
+void UAsyncSkeletalMeshMerge::Complete(USkeletalMesh* MergedMesh)
+{
+	GatherData.Reset();
+	BuildData.Reset();
+	SourceMeshes.Reset();
+	Skeleton = nullptr;
+	AtlasTextures.Reset();
+	PreviousMergedMesh = nullptr;
+
+	// Delegate may start another merge, so move it out first
+	FOnMeshMergeCompleteDelegate Delegate = MoveTemp(OnMeshMergeComplete);
+	Delegate.ExecuteIfBound(MergedMesh);
+}
@@ -0,0 +1,587 @@
+#include "Utilities/MeshMerger/MeshMergeAtlas.h"
+
+#include "Engine/SkinnedAssetCommon.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "TextureResource.h"
+#include "UObject/ObjectKey.h"
+#include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+namespace MeshMergeAtlas
+{
+	namespace Private
+	{
+		int64 GetMipSizeInBytes(EPixelFormat PixelFormat, const FIntPoint& Size)
+		{
+			const FPixelFormatInfo& FormatInfo = GPixelFormats[PixelFormat];
+			return static_cast<int64>(Size.X / FormatInfo.BlockSizeX) * (Size.Y / FormatInfo.BlockSizeY) * FormatInfo.BlockBytes;
+		}
+
+		FIntPoint GetMipSize(const FIntPoint& Size, int32 MipIndex)
+		{
+			return FIntPoint(Size.X >> MipIndex, Size.Y >> MipIndex);
+		}
+
+		bool IsMipReadable(const FTexture2DMipMap& Mip)
+		{
+#if WITH_EDITORONLY_DATA
+			// Editor reads mips from derived data
+			return true;
+#else
+			return Mip.BulkData.IsBulkDataLoaded() || Mip.BulkData.CanLoadFromDisk();
+#endif
+		}
+
+		// Atlas material instance is created from the first entry, every other one has to render the same with only the atlas texture swapped
+		bool CanShareAtlasMaterial(const UMaterialInterface* Material, const UMaterialInterface* Reference, FName ParameterName)
+		{
+			const UMaterialInstance* Instance = Cast<UMaterialInstance>(Material);
+			const UMaterialInstance* ReferenceInstance = Cast<UMaterialInstance>(Reference);
+			if (!Instance || !ReferenceInstance || Instance->Parent != ReferenceInstance->Parent || !(Instance->GetStaticParameters() == ReferenceInstance->GetStaticParameters()))
+			{
+				return false;
+			}
+
+			// Same parent, so values only differ where one of them overrides
+			for (const UMaterialInstance* Overrides : { Instance, ReferenceInstance })
+			{
+				for (const FScalarParameterValue& Parameter : Overrides->ScalarParameterValues)
+				{
+					const FHashedMaterialParameterInfo Info(Parameter.ParameterInfo);
+					float Value = 0.f;
+					float ReferenceValue = 0.f;
+					if (Instance->GetScalarParameterValue(Info, Value) != ReferenceInstance->GetScalarParameterValue(Info, ReferenceValue) || Value != ReferenceValue)
+					{
+						return false;
+					}
+				}
+
+				for (const FVectorParameterValue& Parameter : Overrides->VectorParameterValues)
+				{
+					const FHashedMaterialParameterInfo Info(Parameter.ParameterInfo);
+					FLinearColor Value = FLinearColor::Black;
+					FLinearColor ReferenceValue = FLinearColor::Black;
+					if (Instance->GetVectorParameterValue(Info, Value) != ReferenceInstance->GetVectorParameterValue(Info, ReferenceValue) || Value != ReferenceValue)
+					{
+						return false;
+					}
+				}
+
+				for (const FTextureParameterValue& Parameter : Overrides->TextureParameterValues)
+				{
+					if (Parameter.ParameterInfo.Name == ParameterName)
+					{
+						continue;
+					}
+
+					const FHashedMaterialParameterInfo Info(Parameter.ParameterInfo);
+					UTexture* Value = nullptr;
+					UTexture* ReferenceValue = nullptr;
+					if (Instance->GetTextureParameterValue(Info, Value) != ReferenceInstance->GetTextureParameterValue(Info, ReferenceValue) || Value != ReferenceValue)
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		// Materials of the mesh whose UV0 leaves 0-1 in a resident LOD or can't be read. Remapped into a tile, such UVs would sample its neighbours.
+		struct FUVRangeCache
+		{
+			TWeakObjectPtr<const USkeletalMesh> Mesh;
+			const FSkeletalMeshRenderData* RenderData = nullptr;
+			int32 FirstLODIndex = INDEX_NONE;
+			TBitArray<> OutsideUnitRange;
+		};
+		TMap<TObjectKey<USkeletalMesh>, FUVRangeCache> UVRangeCache;
+
+		const TBitArray<>& GetMaterialsOutsideUnitUVRange(USkeletalMesh* Mesh)
+		{
+			check(IsInGameThread());
+
+			if (!UVRangeCache.Contains(Mesh))
+			{
+				for (auto It = UVRangeCache.CreateIterator(); It; ++It)
+				{
+					if (!It->Value.Mesh.IsValid())
+					{
+						It.RemoveCurrent();
+					}
+				}
+			}
+
+			// Geometry only changes with the render data or the resident LOD range
+			const FSkeletalMeshRenderData* RenderData = Mesh->GetResourceForRendering();
+			const int32 FirstLODIndex = RenderData ? RenderData->CurrentFirstLODIdx : INDEX_NONE;
+			FUVRangeCache& Cache = UVRangeCache.FindOrAdd(Mesh);
+			if (Cache.Mesh.Get() == Mesh && Cache.RenderData == RenderData && Cache.FirstLODIndex == FirstLODIndex)
+			{
+				return Cache.OutsideUnitRange;
+			}
+
+			Cache.Mesh = Mesh;
+			Cache.RenderData = RenderData;
+			Cache.FirstLODIndex = FirstLODIndex;
+			Cache.OutsideUnitRange.Init(RenderData == nullptr, Mesh->GetMaterials().Num());
+			for (int32 LODIndex = FMath::Max(FirstLODIndex, 0); RenderData && LODIndex < RenderData->LODRenderData.Num(); ++LODIndex)
+			{
+				const FSkeletalMeshLODRenderData& LODData = RenderData->LODRenderData[LODIndex];
+				const FStaticMeshVertexBuffer& VertexBuffer = LODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+				const bool bReadable = MeshMergeUtilities::HasCPUAccess(LODData) && VertexBuffer.GetNumTexCoords() > 0;
+				const FSkeletalMeshLODInfo* LODInfo = Mesh->GetLODInfo(LODIndex);
+				for (int32 SectionIndex = 0; SectionIndex < LODData.RenderSections.Num(); ++SectionIndex)
+				{
+					const FSkelMeshRenderSection& Section = LODData.RenderSections[SectionIndex];
+					int32 MaterialIndex = Section.MaterialIndex;
+					if (LODInfo && LODInfo->LODMaterialMap.IsValidIndex(SectionIndex) && LODInfo->LODMaterialMap[SectionIndex] != INDEX_NONE)
+					{
+						MaterialIndex = LODInfo->LODMaterialMap[SectionIndex];
+					}
+					if (!Cache.OutsideUnitRange.IsValidIndex(MaterialIndex) || Cache.OutsideUnitRange[MaterialIndex])
+					{
+						continue;
+					}
+
+					bool bOutside = !bReadable;
+					for (uint32 VertexIndex = Section.BaseVertexIndex; !bOutside && VertexIndex < Section.BaseVertexIndex + Section.NumVertices; ++VertexIndex)
+					{
+						const FVector2f UV = VertexBuffer.GetVertexUV(VertexIndex, 0);
+						bOutside = UV.X < 0.f || UV.X > 1.f || UV.Y < 0.f || UV.Y > 1.f;
+					}
+					Cache.OutsideUnitRange[MaterialIndex] = bOutside;
+				}
+			}
+			return Cache.OutsideUnitRange;
+		}
+
+		// Texture the material samples through the atlas parameter, packed with its first mip not larger than the tile limit
+		bool MakeEntry(UMaterialInterface* Material, FName ParameterName, int32 MaxTileSize, FMeshMergeAtlasPlan& InOutPlan, FMeshMergeAtlasEntry& OutEntry)
+		{
+			UTexture* Texture = nullptr;
+			if (!Material->GetTextureParameterValue(FHashedMaterialParameterInfo(ParameterName), Texture))
+			{
+				return false;
+			}
+
+			const UTexture2D* Texture2D = Cast<UTexture2D>(Texture);
+			const FTexturePlatformData* PlatformData = Texture2D ? Texture2D->GetPlatformData() : nullptr;
+			if (!PlatformData || PlatformData->Mips.IsEmpty())
+			{
+				return false;
+			}
+
+#if WITH_EDITOR
+			// Platform data is replaced when the compile finishes, the worker reads it later
+			if (Texture2D->IsCompiling())
+			{
+				return false;
+			}
+#endif
+
+			// First texture decides the atlas format
+			const EPixelFormat PixelFormat = PlatformData->PixelFormat;
+			if (InOutPlan.PixelFormat != PF_Unknown && (PixelFormat != InOutPlan.PixelFormat || static_cast<bool>(Texture2D->SRGB) != InOutPlan.bSRGB))
+			{
+				return false;
+			}
+
+			int32 MipIndex = 0;
+			while (MipIndex + 1 < PlatformData->Mips.Num() && FMath::Max(PlatformData->Mips[MipIndex].SizeX, PlatformData->Mips[MipIndex].SizeY) > MaxTileSize)
+			{
+				++MipIndex;
+			}
+
+			const FTexture2DMipMap& Mip = PlatformData->Mips[MipIndex];
+			const FPixelFormatInfo& FormatInfo = GPixelFormats[PixelFormat];
+			if (!FormatInfo.Supported || FormatInfo.BlockSizeZ != 1 || Mip.SizeX % FormatInfo.BlockSizeX != 0 || Mip.SizeY % FormatInfo.BlockSizeY != 0 || !IsMipReadable(Mip))
+			{
+				return false;
+			}
+
+			InOutPlan.PixelFormat = PixelFormat;
+			InOutPlan.bSRGB = Texture2D->SRGB;
+
+			OutEntry.Material = Material;
+			OutEntry.Texture = Texture2D;
+			OutEntry.MipIndex = MipIndex;
+			OutEntry.Size = FIntPoint(Mip.SizeX, Mip.SizeY);
+			return true;
+		}
+
+		// Shelf packing, tallest tiles first. Entries that don't fit are dropped.
+		void PackEntries(int32 MaxAtlasSize, FMeshMergeAtlasPlan& InOutPlan)
+		{
+			TArray<int32> Order;
+			Order.Reserve(InOutPlan.Entries.Num());
+			for (int32 EntryIndex = 0; EntryIndex < InOutPlan.Entries.Num(); ++EntryIndex)
+			{
+				Order.Add(EntryIndex);
+			}
+			Order.StableSort([&InOutPlan](int32 A, int32 B)
+			{
+				return InOutPlan.Entries[A].Size.Y > InOutPlan.Entries[B].Size.Y;
+			});
+
+			TBitArray<> Packed(false, InOutPlan.Entries.Num());
+			FIntPoint Cursor = FIntPoint::ZeroValue;
+			int32 ShelfHeight = 0;
+			FIntPoint UsedSize = FIntPoint::ZeroValue;
+			for (const int32 EntryIndex : Order)
+			{
+				FMeshMergeAtlasEntry& Entry = InOutPlan.Entries[EntryIndex];
+				if (Cursor.X + Entry.Size.X > MaxAtlasSize)
+				{
+					Cursor = FIntPoint(0, Cursor.Y + ShelfHeight);
+					ShelfHeight = 0;
+				}
+				if (Cursor.X + Entry.Size.X > MaxAtlasSize || Cursor.Y + Entry.Size.Y > MaxAtlasSize)
+				{
+					continue;
+				}
+
+				Entry.Offset = Cursor;
+				Packed[EntryIndex] = true;
+				Cursor.X += Entry.Size.X;
+				ShelfHeight = FMath::Max(ShelfHeight, Entry.Size.Y);
+				UsedSize = FIntPoint(FMath::Max(UsedSize.X, Cursor.X), FMath::Max(UsedSize.Y, Cursor.Y + Entry.Size.Y));
+			}
+
+			TArray<FMeshMergeAtlasEntry> PackedEntries;
+			for (int32 EntryIndex = 0; EntryIndex < InOutPlan.Entries.Num(); ++EntryIndex)
+			{
+				if (Packed[EntryIndex])
+				{
+					PackedEntries.Add(InOutPlan.Entries[EntryIndex]);
+				}
+			}
+			InOutPlan.Entries = MoveTemp(PackedEntries);
+			InOutPlan.Size = FIntPoint(
+				FMath::Min<int32>(FMath::RoundUpToPowerOfTwo(UsedSize.X), MaxAtlasSize),
+				FMath::Min<int32>(FMath::RoundUpToPowerOfTwo(UsedSize.Y), MaxAtlasSize));
+		}
+
+		// Tile mips come from the same mip chain offset as the entry mip. Chain ends where a tile stops being block aligned or its texture runs out of mips.
+		bool CanBuildMip(const FMeshMergeAtlasPlan& Plan, int32 AtlasMipIndex)
+		{
+			const FPixelFormatInfo& FormatInfo = GPixelFormats[Plan.PixelFormat];
+			const FIntPoint Alignment(FormatInfo.BlockSizeX << AtlasMipIndex, FormatInfo.BlockSizeY << AtlasMipIndex);
+			auto IsAligned = [&Alignment](const FIntPoint& Value)
+			{
+				return Value.X % Alignment.X == 0 && Value.Y % Alignment.Y == 0;
+			};
+
+			if (!IsAligned(Plan.Size))
+			{
+				return false;
+			}
+
+			for (const FMeshMergeAtlasEntry& Entry : Plan.Entries)
+			{
+				const FTexturePlatformData* PlatformData = Entry.Texture->GetPlatformData();
+				const int32 SourceMipIndex = Entry.MipIndex + AtlasMipIndex;
+				if (!IsAligned(Entry.Size) || !IsAligned(Entry.Offset) || !PlatformData->Mips.IsValidIndex(SourceMipIndex))
+				{
+					return false;
+				}
+
+				const FTexture2DMipMap& Mip = PlatformData->Mips[SourceMipIndex];
+				if (FIntPoint(Mip.SizeX, Mip.SizeY) != GetMipSize(Entry.Size, AtlasMipIndex) || !IsMipReadable(Mip))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Deeper chains would need an inset of half their smallest texel, eating more than a couple of texels of every tile at mip 0
+		constexpr int32 MaxAtlasMips = 3;
+
+		// Plans by their candidate materials in part order, MakeMergeKey plans every key it builds
+		struct FPlanCache
+		{
+			TArray<TWeakObjectPtr<UMaterialInterface>> Candidates;
+			uint32 SettingsHash = 0;
+			FMeshMergeAtlasPlan Plan;
+		};
+		TMap<uint32, FPlanCache> PlanCache;
+		constexpr int32 MaxCachedPlans = 256;
+
+		uint32 GetPlanSettingsHash(const UCustomizationSettings& Settings)
+		{
+			uint32 Hash = GetTypeHash(Settings.GetAtlasParentMaterial());
+			Hash = HashCombine(Hash, GetTypeHash(Settings.GetAtlasTextureParameterName()));
+			Hash = HashCombine(Hash, GetTypeHash(Settings.GetMaxAtlasSize()));
+			return HashCombine(Hash, GetTypeHash(Settings.GetMaxAtlasTileSize()));
+		}
+
+		FPlanCache* FindCachedPlan(uint32 Key, const TArray<UMaterialInterface*>& Candidates, uint32 SettingsHash)
+		{
+			FPlanCache* Cached = PlanCache.Find(Key);
+			if (!Cached || Cached->SettingsHash != SettingsHash || Cached->Candidates.Num() != Candidates.Num())
+			{
+				return nullptr;
+			}
+			for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+			{
+				if (Cached->Candidates[Index].Get() != Candidates[Index])
+				{
+					return nullptr;
+				}
+			}
+			return Cached;
+		}
+
+#if WITH_EDITOR
+		// Entries of compiling textures are skipped, a plan missing them is not cached
+		bool HasCompilingTexture(const TArray<UMaterialInterface*>& Candidates, FName ParameterName)
+		{
+			for (const UMaterialInterface* Material : Candidates)
+			{
+				UTexture* Texture = nullptr;
+				if (Material->GetTextureParameterValue(FHashedMaterialParameterInfo(ParameterName), Texture) && Texture && Texture->IsCompiling())
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+#endif
+
+		// [Any thread] Mips of the entry the atlas chain uses, in atlas mip order
+		bool LoadEntryMips(const FMeshMergeAtlasPlan& Plan, const FMeshMergeAtlasEntry& Entry, TArray<TArray64<uint8>, TInlineAllocator<MAX_TEXTURE_MIP_COUNT>>& OutMips)
+		{
+			// Loads the planned mip and every smaller one, the ones past the atlas chain are dropped
+			FTexturePlatformData* PlatformData = const_cast<UTexture2D*>(Entry.Texture)->GetPlatformData();
+			const int32 NumMipsToLoad = PlatformData->Mips.Num() - Entry.MipIndex;
+			TArray<void*, TInlineAllocator<MAX_TEXTURE_MIP_COUNT>> MipData;
+			TArray<int64, TInlineAllocator<MAX_TEXTURE_MIP_COUNT>> MipSizes;
+			MipData.SetNumZeroed(NumMipsToLoad);
+			MipSizes.SetNumZeroed(NumMipsToLoad);
+
+			bool bLoaded = PlatformData->TryLoadMipsWithSizes(Entry.MipIndex, MipData.GetData(), MipSizes.GetData(), Entry.Texture->GetPathName());
+			OutMips.SetNum(Plan.NumMips);
+			for (int32 MipIndex = 0; bLoaded && MipIndex < Plan.NumMips; ++MipIndex)
+			{
+				bLoaded = MipData[MipIndex] && MipSizes[MipIndex] >= GetMipSizeInBytes(Plan.PixelFormat, GetMipSize(Entry.Size, MipIndex));
+				if (bLoaded)
+				{
+					OutMips[MipIndex].Append(static_cast<const uint8*>(MipData[MipIndex]), MipSizes[MipIndex]);
+				}
+			}
+
+			for (void* Data : MipData)
+			{
+				FMemory::Free(Data);
+			}
+			return bLoaded;
+		}
+	}
+
+	void PlanAtlas(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergeAtlasPlan& OutPlan)
+	{
+		OutPlan = FMeshMergeAtlasPlan();
+
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		if (!Settings || !Settings->GetAtlasMergedMaterials())
+		{
+			return;
+		}
+
+		// 1. Resolved part materials any part draws with UVs outside 0-1 keep their own material
+		TSet<const UMaterialInterface*> UnitRangeViolations;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			if (!Data.SkeletalMesh)
+			{
+				continue;
+			}
+
+			const TBitArray<>& OutsideUnitRange = Private::GetMaterialsOutsideUnitUVRange(Data.SkeletalMesh);
+			for (TConstSetBitIterator<> It(OutsideUnitRange); It; ++It)
+			{
+				UnitRangeViolations.Add(MeshMergeUtilities::GetResolvedMaterial(Data, It.GetIndex()));
+			}
+		}
+
+		// 2. Every other resolved instance of the atlas parent once, in part order
+		const UMaterialInterface* AtlasParentMaterial = Settings->GetAtlasParentMaterial();
+		const UMaterial* AtlasBaseMaterial = AtlasParentMaterial ? AtlasParentMaterial->GetMaterial() : nullptr;
+		TArray<UMaterialInterface*> Candidates;
+		uint32 CandidatesHash = 0;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			if (!Data.SkeletalMesh || !AtlasBaseMaterial)
+			{
+				continue;
+			}
+
+			for (int32 MaterialIndex = 0; MaterialIndex < Data.SkeletalMesh->GetMaterials().Num(); ++MaterialIndex)
+			{
+				UMaterialInterface* Material = MeshMergeUtilities::GetResolvedMaterial(Data, MaterialIndex);
+				if (Material && Material->GetMaterial() == AtlasBaseMaterial && !UnitRangeViolations.Contains(Material) && !Candidates.Contains(Material))
+				{
+					Candidates.Add(Material);
+					CandidatesHash = HashCombine(CandidatesHash, GetTypeHash(Material));
+				}
+			}
+		}
+		if (Candidates.Num() < 2)
+		{
+			return;
+		}
+
+		// 3. Same candidates pack the same way
+		const uint32 SettingsHash = Private::GetPlanSettingsHash(*Settings);
+		if (const Private::FPlanCache* Cached = Private::FindCachedPlan(CandidatesHash, Candidates, SettingsHash))
+		{
+			OutPlan = Cached->Plan;
+			return;
+		}
+
+		// 4. Only candidates sharing everything but the atlas texture with the first entry
+		const FName ParameterName = Settings->GetAtlasTextureParameterName();
+		const int32 MaxTileSize = Settings->GetMaxAtlasTileSize();
+		for (UMaterialInterface* Material : Candidates)
+		{
+			FMeshMergeAtlasEntry Entry;
+			if ((OutPlan.IsEmpty() || Private::CanShareAtlasMaterial(Material, OutPlan.Entries[0].Material, ParameterName))
+				&& Private::MakeEntry(Material, ParameterName, MaxTileSize, OutPlan, Entry))
+			{
+				OutPlan.Entries.Add(Entry);
+			}
+		}
+
+		// 5. One texture gains nothing over its own material
+		Private::PackEntries(Settings->GetMaxAtlasSize(), OutPlan);
+		const FPixelFormatInfo& FormatInfo = GPixelFormats[OutPlan.PixelFormat];
+		if (OutPlan.Entries.Num() < 2 || OutPlan.Size.X % FormatInfo.BlockSizeX != 0 || OutPlan.Size.Y % FormatInfo.BlockSizeY != 0)
+		{
+			OutPlan = FMeshMergeAtlasPlan();
+		}
+		else
+		{
+			// 6. Mip chain as deep as every tile allows, capped so the inset stays small
+			OutPlan.NumMips = 1;
+			while (OutPlan.NumMips < Private::MaxAtlasMips && Private::CanBuildMip(OutPlan, OutPlan.NumMips))
+			{
+				++OutPlan.NumMips;
+			}
+
+			// 7. Tiles in UV space, inset by half a texel of the smallest mip against bleeding of bilinear filtering
+			const FVector2f AtlasSize(OutPlan.Size);
+			const float Inset = 0.5f * static_cast<float>(1 << (OutPlan.NumMips - 1));
+			for (FMeshMergeAtlasEntry& Entry : OutPlan.Entries)
+			{
+				Entry.UVRect = FBox2f(
+					(FVector2f(Entry.Offset) + Inset) / AtlasSize,
+					(FVector2f(Entry.Offset + Entry.Size) - Inset) / AtlasSize);
+			}
+		}
+
+#if WITH_EDITOR
+		if (Private::HasCompilingTexture(Candidates, ParameterName))
+		{
+			return;
+		}
+#endif
+		if (Private::PlanCache.Num() >= Private::MaxCachedPlans)
+		{
+			Private::PlanCache.Reset();
+		}
+		Private::FPlanCache& Cached = Private::PlanCache.FindOrAdd(CandidatesHash);
+		Cached.Candidates = TArray<TWeakObjectPtr<UMaterialInterface>>(Candidates);
+		Cached.SettingsHash = SettingsHash;
+		Cached.Plan = OutPlan;
+	}
+
+	bool BuildAtlasData(const FMeshMergeGatherData& GatherData, TArray<TArray64<uint8>>& OutAtlasMips)
+	{
+		// Mips are read as tightly packed block rows, platforms with tiled mip data are not supported
+		const FMeshMergeAtlasPlan& Plan = GatherData.AtlasPlan;
+		const FPixelFormatInfo& FormatInfo = GPixelFormats[Plan.PixelFormat];
+
+		OutAtlasMips.SetNum(Plan.NumMips);
+		for (int32 MipIndex = 0; MipIndex < Plan.NumMips; ++MipIndex)
+		{
+			OutAtlasMips[MipIndex].SetNumZeroed(Private::GetMipSizeInBytes(Plan.PixelFormat, Private::GetMipSize(Plan.Size, MipIndex)));
+		}
+
+		// Entry mips are read one entry at a time and copied into their tile of every atlas mip
+		for (const FMeshMergeAtlasEntry& Entry : Plan.Entries)
+		{
+			TArray<TArray64<uint8>, TInlineAllocator<MAX_TEXTURE_MIP_COUNT>> EntryMips;
+			if (!Private::LoadEntryMips(Plan, Entry, EntryMips))
+			{
+				UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeAtlas::BuildAtlasData - Failed to read mips %d-%d of %s"),
+					Entry.MipIndex, Entry.MipIndex + Plan.NumMips - 1, *GetNameSafe(Entry.Texture));
+				OutAtlasMips.Empty();
+				return false;
+			}
+
+			for (int32 MipIndex = 0; MipIndex < Plan.NumMips; ++MipIndex)
+			{
+				const FIntPoint TileSize = Private::GetMipSize(Entry.Size, MipIndex);
+				const FIntPoint TileOffset = Private::GetMipSize(Entry.Offset, MipIndex);
+				const int64 AtlasRowBytes = static_cast<int64>(Private::GetMipSize(Plan.Size, MipIndex).X / FormatInfo.BlockSizeX) * FormatInfo.BlockBytes;
+				const int64 TileRowBytes = static_cast<int64>(TileSize.X / FormatInfo.BlockSizeX) * FormatInfo.BlockBytes;
+				const int32 NumBlockRows = TileSize.Y / FormatInfo.BlockSizeY;
+
+				const uint8* Source = EntryMips[MipIndex].GetData();
+				uint8* Target = OutAtlasMips[MipIndex].GetData()
+					+ (TileOffset.Y / FormatInfo.BlockSizeY) * AtlasRowBytes
+					+ (TileOffset.X / FormatInfo.BlockSizeX) * FormatInfo.BlockBytes;
+				for (int32 BlockRow = 0; BlockRow < NumBlockRows; ++BlockRow)
+				{
+					FMemory::Memcpy(Target + BlockRow * AtlasRowBytes, Source + BlockRow * TileRowBytes, TileRowBytes);
+				}
+			}
+		}
+		return true;
+	}
+
+	UMaterialInterface* CreateAtlasMaterial(const FMeshMergeGatherData& GatherData, TArray<TArray64<uint8>>& AtlasMips, USkeletalMesh* MergedMesh)
+	{
+		check(IsInGameThread());
+
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		const FMeshMergeAtlasPlan& Plan = GatherData.AtlasPlan;
+		if (!Settings || Plan.IsEmpty() || AtlasMips.Num() != Plan.NumMips || AtlasMips[0].Num() != Private::GetMipSizeInBytes(Plan.PixelFormat, Plan.Size))
+		{
+			UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeAtlas::CreateAtlasMaterial - No atlas data for %s"), *GetNameSafe(MergedMesh));
+			return nullptr;
+		}
+
+		// Mip 0 comes with the transient texture, the rest of the chain is appended before its resource is created
+		UTexture2D* AtlasTexture = UTexture2D::CreateTransient(Plan.Size.X, Plan.Size.Y, Plan.PixelFormat, NAME_None, AtlasMips[0]);
+		if (!AtlasTexture)
+		{
+			AtlasMips.Empty();
+			return nullptr;
+		}
+
+		FTexturePlatformData* PlatformData = AtlasTexture->GetPlatformData();
+		for (int32 MipIndex = 1; MipIndex < AtlasMips.Num(); ++MipIndex)
+		{
+			const FIntPoint MipSize = Private::GetMipSize(Plan.Size, MipIndex);
+			FTexture2DMipMap* Mip = new FTexture2DMipMap(MipSize.X, MipSize.Y, 1);
+			PlatformData->Mips.Add(Mip);
+
+			Mip->BulkData.Lock(LOCK_READ_WRITE);
+			FMemory::Memcpy(Mip->BulkData.Realloc(AtlasMips[MipIndex].Num()), AtlasMips[MipIndex].GetData(), AtlasMips[MipIndex].Num());
+			Mip->BulkData.Unlock();
+		}
+		AtlasMips.Empty();
+		AtlasTexture->SRGB = Plan.bSRGB;
+		AtlasTexture->UpdateResource();
+
+		// Entries share parent, static switches and parameter values, an instance of the first one draws all of them once the atlas is swapped in.
+		// Material instance references the texture, both live as long as the merged mesh uses them.
+		UMaterialInstanceDynamic* AtlasMaterial = UMaterialInstanceDynamic::Create(Plan.Entries[0].Material, MergedMesh);
+		AtlasMaterial->SetTextureParameterValue(Settings->GetAtlasTextureParameterName(), AtlasTexture);
+		return AtlasMaterial;
+	}
+}
@@ -0,0 +1,170 @@
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "SkeletalMeshMerge.h"
+#include "Animation/Skeleton.h"
+#include "Components/Core/Assets/BodyPartAsset.h"
+#include "Constants/GlobalConstants.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "Utilities/CustomizationAssetManager.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+#include "Utilities/MeshMerger/MeshMergeVertexCache.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * MeshMerge.Benchmark [Iterations]
+ * Merges every body part mesh of a skeleton as one part set with the native kernel and with FSkeletalMeshMerge, logs average times.
+ * Native kernel runs with current settings, so consolidation, atlasing and pruning are part of its time when enabled.
+ * Vertex cache ACMR of the native LOD 0 is logged too, toggle Optimize Merged Vertex Cache to compare.
+ */
+namespace MeshMergeBenchmark
+{
+	namespace Private
+	{
+		TMap<const USkeleton*, TArray<USkeletalMesh*>> CollectBodyPartMeshes()
+		{
+			TMap<const USkeleton*, TArray<USkeletalMesh*>> MeshesBySkeleton;
+			UCustomizationAssetManager* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
+			if (!AssetManager)
+			{
+				return MeshesBySkeleton;
+			}
+
+			TArray<FPrimaryAssetId> BodyPartIds;
+			AssetManager->GetPrimaryAssetIdList(GLOBAL_CONSTANTS::PrimaryBodyPartAssetType, BodyPartIds);
+			for (const FPrimaryAssetId& BodyPartId : BodyPartIds)
+			{
+				const UBodyPartAsset* BodyPart = AssetManager->LoadBodyPartAssetSync(BodyPartId);
+				if (!BodyPart)
+				{
+					continue;
+				}
+
+				for (const FBodyPartVariant& Variant : BodyPart->Variants)
+				{
+					if (Variant.BodyPartSkeletalMesh && Variant.BodyPartSkeletalMesh->GetSkeleton())
+					{
+						MeshesBySkeleton.FindOrAdd(Variant.BodyPartSkeletalMesh->GetSkeleton()).AddUnique(Variant.BodyPartSkeletalMesh);
+					}
+				}
+			}
+			return MeshesBySkeleton;
+		}
+
+		int32 GetNumVertices(const USkeletalMesh* Mesh)
+		{
+			const FSkeletalMeshRenderData* RenderData = Mesh ? Mesh->GetResourceForRendering() : nullptr;
+			return RenderData && !RenderData->LODRenderData.IsEmpty() ? RenderData->LODRenderData[0].GetNumVertices() : 0;
+		}
+
+		// Average milliseconds per merge, negative if a merge failed
+		double TimeNativeKernel(const TArray<FMeshToMergeData>& MeshesToMergeData, int32 NumIterations, int32& OutNumVertices)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				const USkeletalMesh* MergedMesh = MeshMergeUtilities::MergeImmediate(MeshesToMergeData);
+				if (!MergedMesh)
+				{
+					return -1.0;
+				}
+				OutNumVertices = GetNumVertices(MergedMesh);
+			}
+			return (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+		}
+
+		// Read from built buffers, merged mesh itself may not keep CPU copies of its indices
+		float GetNativeACMR(const TArray<FMeshToMergeData>& MeshesToMergeData)
+		{
+			FMeshMergeGatherData GatherData;
+			FMergedMeshBuildData BuildData;
+			if (!MeshMergeUtilities::GatherMergeData(MeshesToMergeData, GatherData) || !MeshMergeUtilities::AcquireSourceCopies(GatherData))
+			{
+				return 0.f;
+			}
+
+			MeshMergeUtilities::BuildMergedMeshData(GatherData, BuildData);
+			if (!BuildData.bSucceeded)
+			{
+				return 0.f;
+			}
+
+			TArray<uint32> Indices;
+			BuildData.LODs[0]->MultiSizeIndexContainer.GetIndexBuffer(Indices);
+			return MeshMergeVertexCache::ComputeACMR(Indices);
+		}
+
+		double TimeSkeletalMeshMerge(const TArray<FMeshToMergeData>& MeshesToMergeData, int32 NumIterations, int32& OutNumVertices)
+		{
+			TArray<USkeletalMesh*> MeshesToMerge;
+			for (const FMeshToMergeData& Data : MeshesToMergeData)
+			{
+				MeshesToMerge.Add(Data.SkeletalMesh);
+			}
+
+			const TArray<FSkelMeshMergeSectionMapping> SectionMappings;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				USkeletalMesh* MergedMesh = NewObject<USkeletalMesh>(GetTransientPackage(), NAME_None, RF_Transient);
+				MergedMesh->SetSkeleton(MeshesToMerge[0]->GetSkeleton());
+
+				FSkeletalMeshMerge Merger(MergedMesh, MeshesToMerge, SectionMappings, 0, EMeshBufferAccess::Default);
+				if (!Merger.DoMerge())
+				{
+					return -1.0;
+				}
+				OutNumVertices = GetNumVertices(MergedMesh);
+			}
+			return (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+		}
+	}
+
+	void Run(const TArray<FString>& Args)
+	{
+		const int32 NumIterations = Args.IsEmpty() ? 10 : FMath::Max(FCString::Atoi(*Args[0]), 1);
+
+		for (const auto& Pair : Private::CollectBodyPartMeshes())
+		{
+			const TArray<USkeletalMesh*>& Meshes = Pair.Value;
+			if (Meshes.Num() < 2)
+			{
+				continue;
+			}
+
+			TArray<FMeshToMergeData> MeshesToMergeData;
+			for (USkeletalMesh* Mesh : Meshes)
+			{
+				MeshesToMergeData.AddDefaulted_GetRef().SkeletalMesh = Mesh;
+			}
+			MeshMergeUtilities::NormalizeMergeOrder(MeshesToMergeData);
+
+			if (!MeshMergeUtilities::CanMergeNatively(MeshesToMergeData))
+			{
+				UE_LOG(LogMeshMerge, Display, TEXT("MeshMerge.Benchmark - %s: %d parts skipped, native kernel can't read them (CPU access or weight precision)"),
+					*GetNameSafe(Pair.Key), Meshes.Num());
+				continue;
+			}
+
+			int32 NativeNumVertices = 0;
+			int32 SkeletalMeshMergeNumVertices = 0;
+			const double NativeMs = Private::TimeNativeKernel(MeshesToMergeData, NumIterations, NativeNumVertices);
+			const double SkeletalMeshMergeMs = Private::TimeSkeletalMeshMerge(MeshesToMergeData, NumIterations, SkeletalMeshMergeNumVertices);
+
+			UE_LOG(LogMeshMerge, Display, TEXT("MeshMerge.Benchmark - %s: %d parts, %d iterations. Native %.3f ms (%d vertices, ACMR %.3f), FSkeletalMeshMerge %.3f ms (%d vertices), x%.2f"),
+				*GetNameSafe(Pair.Key), Meshes.Num(), NumIterations, NativeMs, NativeNumVertices, Private::GetNativeACMR(MeshesToMergeData),
+				SkeletalMeshMergeMs, SkeletalMeshMergeNumVertices, NativeMs > 0.0 ? SkeletalMeshMergeMs / NativeMs : 0.0);
+		}
+
+		// Merged meshes of the runs are transient, don't keep them until the next regular GC
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+}
+
+static FAutoConsoleCommand MeshMergeBenchmarkCommand(
+	TEXT("MeshMerge.Benchmark"),
+	TEXT("Merges body part meshes of every skeleton with the native kernel and FSkeletalMeshMerge and logs average times. Args: [Iterations=10]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MeshMergeBenchmark::Run));
+
+#endif
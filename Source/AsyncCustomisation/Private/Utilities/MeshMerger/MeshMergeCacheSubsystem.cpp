@@ -0,0 +1,153 @@
+#include "Utilities/MeshMerger/MeshMergeCacheSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Tasks/Task.h"
+#include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/MeshMergeDiskCache.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+
+
+UMeshMergeCacheSubsystem* UMeshMergeCacheSubsystem::Get(const UWorld* World)
+{
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMeshMergeCacheSubsystem>() : nullptr;
+}
+
+void UMeshMergeCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Stale disk entries are never read again, drop the least recently used ones off the game thread
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	if (Settings && Settings->GetEnableMeshMergeDiskCache())
+	{
+		const int32 MaxEntries = Settings->GetMeshMergeDiskCacheMaxEntries();
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [MaxEntries]()
+		{
+			MeshMergeDiskCache::Trim(MaxEntries);
+		}, UE::Tasks::ETaskPriority::BackgroundLow);
+	}
+}
+
+void UMeshMergeCacheSubsystem::Deinitialize()
+{
+	Clear();
+	Super::Deinitialize();
+}
+
+USkeletalMesh* UMeshMergeCacheSubsystem::FindMesh(const FSkeletalMeshArrayKey& Key)
+{
+	FMergedMeshCacheEntry* Entry = CachedMeshes.Find(Key);
+	if (!Entry || !Entry->Mesh)
+	{
+		return nullptr;
+	}
+
+	Entry->LastAccess = ++AccessCounter;
+	UE_LOG(LogMeshMerge, Verbose, TEXT("UMeshMergeCacheSubsystem::FindMesh - Cache hit %s"), *GetNameSafe(Entry->Mesh));
+	return Entry->Mesh;
+}
+
+bool UMeshMergeCacheSubsystem::AddPendingRequest(const FSkeletalMeshArrayKey& Key, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete)
+{
+	if (TArray<FOnMeshMergeCompleteDelegate>* Waiters = PendingRequests.Find(Key))
+	{
+		Waiters->Add(MoveTemp(OnMeshMergeComplete));
+		UE_LOG(LogMeshMerge, Verbose, TEXT("UMeshMergeCacheSubsystem::AddPendingRequest - Joined running merge, %d waiters"), Waiters->Num());
+		return true;
+	}
+
+	PendingRequests.Add(Key).Add(MoveTemp(OnMeshMergeComplete));
+	return false;
+}
+
+FOnMeshMergeCompleteDelegate UMeshMergeCacheSubsystem::MakeMergeCompleteDelegate(const FSkeletalMeshArrayKey& Key)
+{
+	return FOnMeshMergeCompleteDelegate::CreateUObject(this, &UMeshMergeCacheSubsystem::OnMergeCompleted, Key);
+}
+
+void UMeshMergeCacheSubsystem::Clear()
+{
+	CachedMeshes.Empty();
+	CachedBytes = 0;
+}
+
+bool UMeshMergeCacheSubsystem::ContainsMesh(const USkeletalMesh* Mesh) const
+{
+	for (const auto& [Key, Entry] : CachedMeshes)
+	{
+		if (Entry.Mesh == Mesh)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UMeshMergeCacheSubsystem::OnMergeCompleted(USkeletalMesh* MergedMesh, FSkeletalMeshArrayKey Key)
+{
+	if (MergedMesh)
+	{
+		AddMesh(Key, MergedMesh);
+	}
+
+	// Waiters may request merges themselves, so the list is detached before executing them
+	TArray<FOnMeshMergeCompleteDelegate> Waiters;
+	PendingRequests.RemoveAndCopyValue(Key, Waiters);
+
+	for (FOnMeshMergeCompleteDelegate& Waiter : Waiters)
+	{
+		Waiter.ExecuteIfBound(MergedMesh);
+	}
+}
+
+void UMeshMergeCacheSubsystem::AddMesh(const FSkeletalMeshArrayKey& Key, USkeletalMesh* MergedMesh)
+{
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	const int64 BudgetBytes = Settings ? Settings->GetMeshMergeCacheBudgetBytes() : 0;
+
+	if (const FMergedMeshCacheEntry* OldEntry = CachedMeshes.Find(Key))
+	{
+		CachedBytes -= OldEntry->SizeBytes;
+	}
+
+	FMergedMeshCacheEntry& Entry = CachedMeshes.Add(Key);
+	Entry.Mesh = MergedMesh;
+	Entry.SizeBytes = MergedMesh->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	Entry.LastAccess = ++AccessCounter;
+	CachedBytes += Entry.SizeBytes;
+
+	EvictToBudget(BudgetBytes);
+
+	UE_LOG(LogMeshMerge, Verbose, TEXT("UMeshMergeCacheSubsystem::AddMesh - Cached %s (%lld bytes), %d meshes, %lld / %lld bytes"),
+		*GetNameSafe(MergedMesh), Entry.SizeBytes, CachedMeshes.Num(), CachedBytes, BudgetBytes);
+}
+
+void UMeshMergeCacheSubsystem::EvictToBudget(int64 BudgetBytes)
+{
+	// Newest entry always stays, even if it alone is over budget
+	while (CachedBytes > BudgetBytes && CachedMeshes.Num() > 1)
+	{
+		const FSkeletalMeshArrayKey* OldestKey = nullptr;
+		uint64 OldestAccess = MAX_uint64;
+		for (const auto& [Key, Entry] : CachedMeshes)
+		{
+			if (Entry.LastAccess < OldestAccess)
+			{
+				OldestAccess = Entry.LastAccess;
+				OldestKey = &Key;
+			}
+		}
+
+		if (!OldestKey)
+		{
+			break;
+		}
+
+		// Meshes still used by components are kept alive by them, cache only forgets about it
+		const FSkeletalMeshArrayKey KeyToEvict = *OldestKey;
+		CachedBytes -= CachedMeshes.FindChecked(KeyToEvict).SizeBytes;
+		CachedMeshes.Remove(KeyToEvict);
+	}
+}
@@ -0,0 +1,519 @@
+#include "Utilities/MeshMerger/MeshMergeDiskCache.h"
+
+#include "Algo/AnyOf.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "StaticMeshResources.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#if WITH_EDITORONLY_DATA
+#include "Rendering/SkeletalMeshModel.h"
+#endif
+#include "Utilities/CustomizationSettings.h"
+
+namespace MeshMergeDiskCache
+{
+	namespace Private
+	{
+		constexpr uint32 FileMagic = 0x4D4D4343; // MMCC
+
+		// Bump when the file layout or the merge output changes
+		constexpr uint32 FileVersion = 4;
+
+		const TCHAR* FileExtension = TEXT(".mmc");
+
+		FString GetEntryPath(const FString& Fingerprint)
+		{
+			return GetCacheDirectory() / Fingerprint + FileExtension;
+		}
+
+		// Bulk copy with a bound check against the file size when loading
+		bool SerializeBulk(FArchive& Ar, void* Data, int64 NumBytes)
+		{
+			if (NumBytes < 0 || (Ar.IsLoading() && Ar.TotalSize() - Ar.Tell() < NumBytes))
+			{
+				Ar.SetError();
+				return false;
+			}
+
+			if (NumBytes > 0)
+			{
+				Ar.Serialize(Data, NumBytes);
+			}
+			return !Ar.IsError();
+		}
+
+		// Element count then bulk data, loading rejects counts above MaxNum or past the end of the file
+		template <typename ElementType, typename AllocatorType>
+		bool SerializeArray(FArchive& Ar, TArray<ElementType, AllocatorType>& Array, int32 MaxNum)
+		{
+			int32 Num = Array.Num();
+			Ar << Num;
+			if (Ar.IsLoading())
+			{
+				if (Ar.IsError() || Num < 0 || Num > MaxNum)
+				{
+					Ar.SetError();
+					return false;
+				}
+				Array.SetNumUninitialized(Num);
+			}
+			return SerializeBulk(Ar, Array.GetData(), Num * static_cast<int64>(sizeof(ElementType)));
+		}
+
+		void SerializeMaterialSlotMap(FArchive& Ar, TMap<int32, FName>& SlotMap)
+		{
+			Ar << SlotMap;
+		}
+
+		void SerializeSection(FArchive& Ar, FSkelMeshRenderSection& Section)
+		{
+			uint8 VertexMaskChannel = static_cast<uint8>(Section.RecomputeTangentsVertexMaskChannel);
+
+			Ar << Section.MaterialIndex;
+			Ar << Section.BaseIndex;
+			Ar << Section.NumTriangles;
+			Ar << Section.BaseVertexIndex;
+			Ar << Section.NumVertices;
+			Ar << Section.MaxBoneInfluences;
+			Ar << Section.bRecomputeTangent;
+			Ar << VertexMaskChannel;
+			Ar << Section.bCastShadow;
+			Ar << Section.bVisibleInRayTracing;
+			Ar << Section.bDisabled;
+			SerializeArray(Ar, Section.BoneMap, MAX_uint16);
+
+			if (Ar.IsLoading())
+			{
+				Section.RecomputeTangentsVertexMaskChannel = static_cast<ESkinVertexColorChannel>(VertexMaskChannel);
+				Section.DuplicatedVerticesBuffer.Init(1, TMap<int, TArray<int32>>());
+			}
+		}
+
+		bool SaveLOD(FArchive& Ar, const FSkeletalMeshLODRenderData& LODData)
+		{
+			const FPositionVertexBuffer& PositionBuffer = LODData.StaticVertexBuffers.PositionVertexBuffer;
+			const FStaticMeshVertexBuffer& MeshVertexBuffer = LODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+			const FColorVertexBuffer& ColorBuffer = LODData.StaticVertexBuffers.ColorVertexBuffer;
+			const FSkinWeightVertexBuffer& SkinWeightBuffer = LODData.SkinWeightVertexBuffer;
+
+			TArray<uint32> Indices;
+			LODData.MultiSizeIndexContainer.GetIndexBuffer(Indices);
+
+			uint32 NumVertices = PositionBuffer.GetNumVertices();
+			uint32 NumIndices = Indices.Num();
+			uint32 NumTexCoords = MeshVertexBuffer.GetNumTexCoords();
+			bool bUseFullPrecisionUVs = MeshVertexBuffer.GetUseFullPrecisionUVs();
+			bool bUseHighPrecisionTangents = MeshVertexBuffer.GetUseHighPrecisionTangentBasis();
+			bool bHasVertexColors = ColorBuffer.GetNumVertices() > 0;
+			uint32 MaxBoneInfluences = SkinWeightBuffer.GetMaxBoneInfluences();
+			bool bUse16BitBoneIndex = SkinWeightBuffer.Use16BitBoneIndex();
+			bool bUse16BitBoneWeight = SkinWeightBuffer.Use16BitBoneWeight();
+
+			Ar << NumVertices << NumIndices << NumTexCoords << bUseFullPrecisionUVs << bUseHighPrecisionTangents << bHasVertexColors;
+			Ar << MaxBoneInfluences << bUse16BitBoneIndex << bUse16BitBoneWeight;
+
+			SerializeBulk(Ar, const_cast<void*>(PositionBuffer.GetVertexData()), static_cast<int64>(PositionBuffer.GetStride()) * NumVertices);
+			SerializeBulk(Ar, const_cast<void*>(MeshVertexBuffer.GetTangentData()), MeshVertexBuffer.GetTangentSize());
+			SerializeBulk(Ar, const_cast<void*>(MeshVertexBuffer.GetTexCoordData()), MeshVertexBuffer.GetTexCoordSize());
+			if (bHasVertexColors)
+			{
+				SerializeBulk(Ar, const_cast<void*>(ColorBuffer.GetVertexData()), static_cast<int64>(ColorBuffer.GetStride()) * NumVertices);
+			}
+
+			TArray<FSkinWeightInfo> SkinWeights;
+			SkinWeightBuffer.GetSkinWeights(SkinWeights);
+			SerializeBulk(Ar, SkinWeights.GetData(), SkinWeights.Num() * static_cast<int64>(sizeof(FSkinWeightInfo)));
+
+			uint8 IndexDataTypeSize = LODData.MultiSizeIndexContainer.GetDataTypeSize();
+			Ar << IndexDataTypeSize;
+			SerializeBulk(Ar, Indices.GetData(), Indices.Num() * static_cast<int64>(sizeof(uint32)));
+
+			int32 NumSections = LODData.RenderSections.Num();
+			Ar << NumSections;
+			for (const FSkelMeshRenderSection& Section : LODData.RenderSections)
+			{
+				SerializeSection(Ar, const_cast<FSkelMeshRenderSection&>(Section));
+			}
+
+			SerializeArray(Ar, const_cast<TArray<FBoneIndexType>&>(LODData.ActiveBoneIndices), MAX_uint16);
+			SerializeArray(Ar, const_cast<TArray<FBoneIndexType>&>(LODData.RequiredBones), MAX_uint16);
+
+			return !Ar.IsError();
+		}
+
+		bool LoadLOD(FArchive& Ar, bool bAllowCPUAccess, FSkeletalMeshLODRenderData& OutLODData)
+		{
+			FPositionVertexBuffer& PositionBuffer = OutLODData.StaticVertexBuffers.PositionVertexBuffer;
+			FStaticMeshVertexBuffer& MeshVertexBuffer = OutLODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+			FColorVertexBuffer& ColorBuffer = OutLODData.StaticVertexBuffers.ColorVertexBuffer;
+			FSkinWeightVertexBuffer& SkinWeightBuffer = OutLODData.SkinWeightVertexBuffer;
+
+			uint32 NumVertices = 0;
+			uint32 NumIndices = 0;
+			uint32 NumTexCoords = 0;
+			bool bUseFullPrecisionUVs = false;
+			bool bUseHighPrecisionTangents = false;
+			bool bHasVertexColors = false;
+			uint32 MaxBoneInfluences = 0;
+			bool bUse16BitBoneIndex = false;
+			bool bUse16BitBoneWeight = false;
+
+			Ar << NumVertices << NumIndices << NumTexCoords << bUseFullPrecisionUVs << bUseHighPrecisionTangents << bHasVertexColors;
+			Ar << MaxBoneInfluences << bUse16BitBoneIndex << bUse16BitBoneWeight;
+
+			// Header counts are bound by the file size before anything is allocated from them
+			if (Ar.IsError() || NumVertices == 0 || NumTexCoords == 0 || NumTexCoords > MAX_TEXCOORDS || MaxBoneInfluences > MAX_TOTAL_INFLUENCES
+				|| NumIndices == 0 || NumIndices % 3 != 0
+				|| static_cast<int64>(NumVertices) * sizeof(FVector3f) > Ar.TotalSize()
+				|| static_cast<int64>(NumIndices) * sizeof(uint32) > Ar.TotalSize())
+			{
+				return false;
+			}
+
+			MeshVertexBuffer.SetUseFullPrecisionUVs(bUseFullPrecisionUVs);
+			MeshVertexBuffer.SetUseHighPrecisionTangentBasis(bUseHighPrecisionTangents);
+			PositionBuffer.Init(NumVertices, bAllowCPUAccess);
+			MeshVertexBuffer.Init(NumVertices, NumTexCoords, bAllowCPUAccess);
+
+			SerializeBulk(Ar, PositionBuffer.GetVertexData(), static_cast<int64>(PositionBuffer.GetStride()) * NumVertices);
+			SerializeBulk(Ar, MeshVertexBuffer.GetTangentData(), MeshVertexBuffer.GetTangentSize());
+			SerializeBulk(Ar, MeshVertexBuffer.GetTexCoordData(), MeshVertexBuffer.GetTexCoordSize());
+			if (bHasVertexColors)
+			{
+				ColorBuffer.Init(NumVertices, bAllowCPUAccess);
+				SerializeBulk(Ar, ColorBuffer.GetVertexData(), static_cast<int64>(ColorBuffer.GetStride()) * NumVertices);
+			}
+
+			TArray<FSkinWeightInfo> SkinWeights;
+			SkinWeights.SetNumUninitialized(NumVertices);
+			if (!SerializeBulk(Ar, SkinWeights.GetData(), SkinWeights.Num() * static_cast<int64>(sizeof(FSkinWeightInfo))))
+			{
+				return false;
+			}
+
+			SkinWeightBuffer.SetNeedsCPUAccess(bAllowCPUAccess);
+			SkinWeightBuffer.SetMaxBoneInfluences(MaxBoneInfluences);
+			SkinWeightBuffer.SetUse16BitBoneIndex(bUse16BitBoneIndex);
+			SkinWeightBuffer.SetUse16BitBoneWeight(bUse16BitBoneWeight);
+			SkinWeightBuffer = SkinWeights;
+
+			uint8 IndexDataTypeSize = 0;
+			TArray<uint32> Indices;
+			Indices.SetNumUninitialized(NumIndices);
+			Ar << IndexDataTypeSize;
+			if (!SerializeBulk(Ar, Indices.GetData(), Indices.Num() * static_cast<int64>(sizeof(uint32)))
+				|| (IndexDataTypeSize != sizeof(uint16) && IndexDataTypeSize != sizeof(uint32))
+				|| Algo::AnyOf(Indices, [NumVertices](uint32 Index) { return Index >= NumVertices; }))
+			{
+				return false;
+			}
+			OutLODData.MultiSizeIndexContainer.RebuildIndexBuffer(IndexDataTypeSize, Indices);
+
+			int32 NumSections = 0;
+			Ar << NumSections;
+			if (Ar.IsError() || NumSections <= 0 || NumSections > MAX_uint16)
+			{
+				return false;
+			}
+
+			OutLODData.RenderSections.SetNum(NumSections);
+			for (FSkelMeshRenderSection& Section : OutLODData.RenderSections)
+			{
+				SerializeSection(Ar, Section);
+				if (Ar.IsError() || static_cast<uint64>(Section.BaseIndex) + Section.NumTriangles * 3ull > NumIndices
+					|| static_cast<uint64>(Section.BaseVertexIndex) + Section.NumVertices > NumVertices)
+				{
+					return false;
+				}
+			}
+
+			SerializeArray(Ar, OutLODData.ActiveBoneIndices, MAX_uint16);
+			SerializeArray(Ar, OutLODData.RequiredBones, MAX_uint16);
+
+			return !Ar.IsError();
+		}
+	}
+
+	FString GetCacheDirectory()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("MeshMergeCache");
+	}
+
+	FString MakeFingerprint(const FMeshMergeGatherData& GatherData)
+	{
+		check(IsInGameThread());
+
+		// Atlas texels are not stored, atlased merges always run
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		if (!Settings || !Settings->GetEnableMeshMergeDiskCache() || GatherData.AtlasMaterialIndex != INDEX_NONE)
+		{
+			return FString();
+		}
+
+		FSHA1 Hash;
+		auto UpdateString = [&Hash](const FString& Value)
+		{
+			Hash.UpdateWithString(*Value, Value.Len());
+		};
+		auto UpdateValue = [&Hash](const auto& Value)
+		{
+			Hash.Update(reinterpret_cast<const uint8*>(&Value), sizeof(Value));
+		};
+
+		// 1. Format and build, cooked content only changes together with the build
+		UpdateValue(Private::FileVersion);
+		UpdateValue(sizeof(FSkinWeightInfo));
+		UpdateString(FEngineVersion::Current().ToString());
+		UpdateString(FApp::GetBuildVersion());
+		UpdateValue(GatherData.NumLODs);
+		UpdateValue(GatherData.bConsolidateSections);
+		UpdateValue(GatherData.MaxBonesPerSection);
+		UpdateValue(GatherData.bOptimizeVertexCache);
+		UpdateValue(GatherData.MaxTexCoords);
+		UpdateValue(GatherData.bStripVertexColors);
+		UpdateValue(GatherData.MaxHalfUVError);
+
+		// Pruned skeleton changes bone indices of every section
+		for (const FMeshBoneInfo& BoneInfo : GatherData.RefSkeleton.GetRawRefBoneInfo())
+		{
+			UpdateString(BoneInfo.Name.ToString());
+		}
+
+		// 2. Every source package and the geometry actually taking part in the merge
+		for (const FMeshMergeSource& Source : GatherData.Sources)
+		{
+			UpdateString(GetPathNameSafe(Source.Mesh));
+			UpdateString(Source.SlotTag.ToString());
+
+			if (const UPackage* Package = Source.Mesh ? Source.Mesh->GetPackage() : nullptr)
+			{
+				const FPackageFileVersion PackageVersion = Package->GetLinkerPackageVersion();
+				UpdateValue(PackageVersion.FileVersionUE4);
+				UpdateValue(PackageVersion.FileVersionUE5);
+				UpdateValue(Package->GetLinkerLicenseeVersion());
+#if WITH_EDITORONLY_DATA
+				// Changes on every save of the source asset in editor
+				UpdateString(LexToString(Package->GetSavedHash()));
+#endif
+			}
+
+#if WITH_EDITORONLY_DATA
+			// Changes on every geometry edit and reimport, saved or not. Cooked geometry only changes with the build version above
+			if (const FSkeletalMeshModel* ImportedModel = Source.Mesh ? Source.Mesh->GetImportedModel() : nullptr)
+			{
+				UpdateString(ImportedModel->GetIdString());
+			}
+#endif
+
+			for (const FSkeletalMeshLODRenderData* LODData : Source.LODs)
+			{
+				UpdateValue(LODData->GetNumVertices());
+				UpdateValue(LODData->MultiSizeIndexContainer.GetIndexBuffer() ? LODData->MultiSizeIndexContainer.GetIndexBuffer()->Num() : 0);
+				UpdateValue(LODData->RenderSections.Num());
+			}
+
+			// Culled skin drops triangles the source still has
+			UpdateValue(Source.CulledRegionMask);
+			for (const FMeshMergeCulledRange& Range : Source.CulledRanges)
+			{
+				UpdateValue(Range);
+			}
+
+			// Consolidated section layout depends on which materials resolve to the same one
+			for (const TArray<int32>& SectionMaterials : Source.SectionMaterials)
+			{
+				for (const int32 MaterialIndex : SectionMaterials)
+				{
+					UpdateValue(MaterialIndex);
+				}
+			}
+		}
+
+		// 3. Baked accessories, their placement and the static LODs picked for them
+		for (const FMeshMergeRigidSource& RigidSource : GatherData.RigidSources)
+		{
+			UpdateString(GetPathNameSafe(RigidSource.Mesh));
+			UpdateValue(RigidSource.BoneIndex);
+			UpdateValue(RigidSource.MeshToComponent);
+#if WITH_EDITORONLY_DATA
+			if (const FStaticMeshRenderData* RenderData = RigidSource.Mesh ? RigidSource.Mesh->GetRenderData() : nullptr)
+			{
+				UpdateString(RenderData->DerivedDataKey);
+			}
+#endif
+			for (const FStaticMeshLODResources* LODResources : RigidSource.LODs)
+			{
+				UpdateValue(LODResources->GetNumVertices());
+				UpdateValue(LODResources->GetNumTriangles());
+			}
+		}
+
+		Hash.Final();
+		uint8 Digest[FSHA1::DigestSize];
+		Hash.GetHash(Digest);
+		return BytesToHex(Digest, FSHA1::DigestSize);
+	}
+
+	bool Contains(const FString& Fingerprint)
+	{
+		return !Fingerprint.IsEmpty() && IFileManager::Get().FileExists(*Private::GetEntryPath(Fingerprint));
+	}
+
+	bool Load(const FMeshMergeGatherData& GatherData, FMergedMeshBuildData& OutBuildData)
+	{
+		const FString& Fingerprint = GatherData.DiskCacheFingerprint;
+		if (Fingerprint.IsEmpty())
+		{
+			return false;
+		}
+
+		const FString EntryPath = Private::GetEntryPath(Fingerprint);
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*EntryPath, FILEREAD_Silent));
+		if (!Reader)
+		{
+			return false;
+		}
+
+		// 1. Header
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		FString StoredFingerprint;
+		*Reader << Magic << Version << StoredFingerprint;
+
+		bool bValid = !Reader->IsError() && Magic == Private::FileMagic && Version == Private::FileVersion && StoredFingerprint == Fingerprint;
+
+		// 2. Slot mapping has to match the one handed out to the caller
+		if (bValid)
+		{
+			TMap<int32, FName> StoredSlotMap;
+			Private::SerializeMaterialSlotMap(*Reader, StoredSlotMap);
+
+			bValid = !Reader->IsError() && StoredSlotMap.Num() == GatherData.MaterialSlotMap.Num();
+			for (auto It = GatherData.MaterialSlotMap.CreateConstIterator(); bValid && It; ++It)
+			{
+				const FName* StoredTagName = StoredSlotMap.Find(It.Key());
+				bValid = StoredTagName && *StoredTagName == It.Value().GetTagName();
+			}
+		}
+
+		// 3. LODs
+		int32 NumLODs = 0;
+		*Reader << NumLODs;
+		bValid &= !Reader->IsError() && NumLODs == GatherData.NumLODs;
+
+		OutBuildData.LODs.Reset(NumLODs);
+		for (int32 LODIndex = 0; bValid && LODIndex < NumLODs; ++LODIndex)
+		{
+			TUniquePtr<FSkeletalMeshLODRenderData>& LODData = OutBuildData.LODs.Add_GetRef(MakeUnique<FSkeletalMeshLODRenderData>());
+			bValid = Private::LoadLOD(*Reader, GatherData.bAllowCPUAccess, *LODData);
+		}
+
+		Reader.Reset();
+
+		if (!bValid)
+		{
+			UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergeDiskCache::Load - Dropping stale or corrupted entry %s"), *EntryPath);
+			OutBuildData.LODs.Reset();
+			IFileManager::Get().Delete(*EntryPath, false, false, true);
+			return false;
+		}
+
+		// Timestamp drives LRU trimming
+		IFileManager::Get().SetTimeStamp(*EntryPath, FDateTime::UtcNow());
+
+		OutBuildData.bSucceeded = true;
+		UE_LOG(LogMeshMerge, Verbose, TEXT("MeshMergeDiskCache::Load - Loaded %s"), *EntryPath);
+		return true;
+	}
+
+	bool Save(const FMeshMergeGatherData& GatherData, const FMergedMeshBuildData& BuildData)
+	{
+		const FString& Fingerprint = GatherData.DiskCacheFingerprint;
+		if (Fingerprint.IsEmpty() || !BuildData.bSucceeded || BuildData.LODs.Num() != GatherData.NumLODs)
+		{
+			return false;
+		}
+
+		// Write to a temp file first, a crash mid-write must not leave a valid looking entry
+		const FString EntryPath = Private::GetEntryPath(Fingerprint);
+		const FString TempPath = FPaths::CreateTempFilename(*GetCacheDirectory(), TEXT("Tmp"), TEXT(".tmp"));
+
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath, FILEWRITE_Silent));
+		if (!Writer)
+		{
+			UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergeDiskCache::Save - Can't create %s"), *TempPath);
+			return false;
+		}
+
+		uint32 Magic = Private::FileMagic;
+		uint32 Version = Private::FileVersion;
+		FString StoredFingerprint = Fingerprint;
+		*Writer << Magic << Version << StoredFingerprint;
+
+		TMap<int32, FName> SlotMap;
+		for (const auto& [MaterialIndex, SlotTag] : GatherData.MaterialSlotMap)
+		{
+			SlotMap.Add(MaterialIndex, SlotTag.GetTagName());
+		}
+		Private::SerializeMaterialSlotMap(*Writer, SlotMap);
+
+		int32 NumLODs = BuildData.LODs.Num();
+		*Writer << NumLODs;
+
+		bool bSucceeded = true;
+		for (const TUniquePtr<FSkeletalMeshLODRenderData>& LODData : BuildData.LODs)
+		{
+			bSucceeded &= Private::SaveLOD(*Writer, *LODData);
+		}
+
+		bSucceeded &= Writer->Close();
+		Writer.Reset();
+
+		if (!bSucceeded || !IFileManager::Get().Move(*EntryPath, *TempPath, true, true, false, true))
+		{
+			UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergeDiskCache::Save - Failed to write %s"), *EntryPath);
+			IFileManager::Get().Delete(*TempPath, false, false, true);
+			return false;
+		}
+
+		UE_LOG(LogMeshMerge, Verbose, TEXT("MeshMergeDiskCache::Save - Saved %s"), *EntryPath);
+		return true;
+	}
+
+	void Trim(int32 MaxEntries)
+	{
+		struct FEntry
+		{
+			FString Path;
+			FDateTime ModificationTime;
+		};
+
+		TArray<FEntry> Entries;
+		IFileManager::Get().IterateDirectoryStat(*GetCacheDirectory(), [&Entries](const TCHAR* Path, const FFileStatData& StatData)
+		{
+			if (!StatData.bIsDirectory && FPaths::GetExtension(Path, true) == Private::FileExtension)
+			{
+				Entries.Add({ Path, StatData.ModificationTime });
+			}
+			return true;
+		});
+
+		if (Entries.Num() <= MaxEntries)
+		{
+			return;
+		}
+
+		Entries.Sort([](const FEntry& A, const FEntry& B) { return A.ModificationTime > B.ModificationTime; });
+		for (int32 EntryIndex = FMath::Max(MaxEntries, 0); EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			IFileManager::Get().Delete(*Entries[EntryIndex].Path, false, false, true);
+		}
+
+		UE_LOG(LogMeshMerge, Log, TEXT("MeshMergeDiskCache::Trim - Removed %d entries"), Entries.Num() - FMath::Max(MaxEntries, 0));
+	}
+}
@@ -0,0 +1,313 @@
+#include "Utilities/MeshMerger/MeshMergePrebakeCommandlet.h"
+
+#include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/MeshMergePrebakeManifest.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+#if WITH_EDITOR
+#include "BoneWeights.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkinnedAssetCommon.h"
+#include "Misc/PackageName.h"
+#include "Rendering/SkeletalMeshLODModel.h"
+#include "Rendering/SkeletalMeshModel.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "SkeletalMeshAttributes.h"
+#include "UObject/SavePackage.h"
+#endif
+
+UMeshMergePrebakeCommandlet::UMeshMergePrebakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+namespace MeshMergePrebake
+{
+	namespace Private
+	{
+		FName GetMaterialSlotName(int32 MaterialIndex)
+		{
+			return *FString::Printf(TEXT("MergedMaterial_%d"), MaterialIndex);
+		}
+
+		// One vertex instance per render vertex, the mesh build welds them again
+		void MakeMeshDescription(const FSkeletalMeshLODRenderData& LODData, FMeshDescription& OutMeshDescription)
+		{
+			FSkeletalMeshAttributes Attributes(OutMeshDescription);
+			Attributes.Register();
+
+			const FStaticMeshVertexBuffers& VertexBuffers = LODData.StaticVertexBuffers;
+			const FSkinWeightVertexBuffer& SkinWeightBuffer = LODData.SkinWeightVertexBuffer;
+			const uint32 NumVertices = LODData.GetNumVertices();
+			const uint32 NumTexCoords = VertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords();
+			const bool bHasVertexColors = VertexBuffers.ColorVertexBuffer.GetNumVertices() > 0;
+
+			TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+			TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+			TVertexInstanceAttributesRef<FVector3f> Tangents = Attributes.GetVertexInstanceTangents();
+			TVertexInstanceAttributesRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+			TVertexInstanceAttributesRef<FVector4f> Colors = Attributes.GetVertexInstanceColors();
+			TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+			FSkinWeightsVertexAttributesRef SkinWeights = Attributes.GetVertexSkinWeights();
+			TPolygonGroupAttributesRef<FName> MaterialSlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+			UVs.SetNumChannels(NumTexCoords);
+
+			// 1. Vertex attributes
+			TArray<FVertexID> VertexIDs;
+			TArray<FVertexInstanceID> VertexInstanceIDs;
+			VertexIDs.Reserve(NumVertices);
+			VertexInstanceIDs.Reserve(NumVertices);
+			OutMeshDescription.ReserveNewVertices(NumVertices);
+			OutMeshDescription.ReserveNewVertexInstances(NumVertices);
+			for (uint32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+			{
+				const FVertexID VertexID = VertexIDs.Add_GetRef(OutMeshDescription.CreateVertex());
+				const FVertexInstanceID VertexInstanceID = VertexInstanceIDs.Add_GetRef(OutMeshDescription.CreateVertexInstance(VertexID));
+
+				const FVector4f TangentZ = VertexBuffers.StaticMeshVertexBuffer.VertexTangentZ(VertexIndex);
+				Positions[VertexID] = VertexBuffers.PositionVertexBuffer.VertexPosition(VertexIndex);
+				Normals[VertexInstanceID] = FVector3f(TangentZ);
+				Tangents[VertexInstanceID] = FVector3f(VertexBuffers.StaticMeshVertexBuffer.VertexTangentX(VertexIndex));
+				BinormalSigns[VertexInstanceID] = TangentZ.W < 0.f ? -1.f : 1.f;
+				for (uint32 UVIndex = 0; UVIndex < NumTexCoords; ++UVIndex)
+				{
+					UVs.Set(VertexInstanceID, UVIndex, VertexBuffers.StaticMeshVertexBuffer.GetVertexUV(VertexIndex, UVIndex));
+				}
+				if (bHasVertexColors)
+				{
+					Colors[VertexInstanceID] = FVector4f(FLinearColor(VertexBuffers.ColorVertexBuffer.VertexColor(VertexIndex)));
+				}
+			}
+
+			// 2. Section bones map back to the skeleton, one polygon group per section
+			TArray<uint32> Indices;
+			LODData.MultiSizeIndexContainer.GetIndexBuffer(Indices);
+			for (const FSkelMeshRenderSection& Section : LODData.RenderSections)
+			{
+				for (uint32 VertexIndex = Section.BaseVertexIndex; VertexIndex < Section.BaseVertexIndex + Section.NumVertices; ++VertexIndex)
+				{
+					TArray<UE::AnimationCore::FBoneWeight, TInlineAllocator<MAX_TOTAL_INFLUENCES>> BoneWeights;
+					for (uint32 InfluenceIndex = 0; InfluenceIndex < SkinWeightBuffer.GetMaxBoneInfluences(); ++InfluenceIndex)
+					{
+						const uint16 Weight = SkinWeightBuffer.GetBoneWeight(VertexIndex, InfluenceIndex);
+						const int32 SectionBoneIndex = static_cast<int32>(SkinWeightBuffer.GetBoneIndex(VertexIndex, InfluenceIndex));
+						if (Weight > 0 && Section.BoneMap.IsValidIndex(SectionBoneIndex))
+						{
+							BoneWeights.Emplace(Section.BoneMap[SectionBoneIndex], static_cast<float>(Weight) / MAX_uint16);
+						}
+					}
+					SkinWeights.Set(VertexIDs[VertexIndex], UE::AnimationCore::FBoneWeights::Create(BoneWeights));
+				}
+
+				const FPolygonGroupID PolygonGroupID = OutMeshDescription.CreatePolygonGroup();
+				MaterialSlotNames[PolygonGroupID] = GetMaterialSlotName(Section.MaterialIndex);
+				for (uint32 TriangleIndex = 0; TriangleIndex < Section.NumTriangles; ++TriangleIndex)
+				{
+					const uint32 FirstIndex = Section.BaseIndex + TriangleIndex * 3;
+					const FVertexInstanceID Corners[3] =
+					{
+						VertexInstanceIDs[Indices[FirstIndex]],
+						VertexInstanceIDs[Indices[FirstIndex + 1]],
+						VertexInstanceIDs[Indices[FirstIndex + 2]]
+					};
+					OutMeshDescription.CreateTriangle(PolygonGroupID, MakeArrayView(Corners));
+				}
+			}
+		}
+
+		// Render data built by the merge becomes the source model of the asset, cook builds it like any imported mesh
+		USkeletalMesh* CreateBakedMesh(const FMeshMergeGatherData& GatherData, const FMergedMeshBuildData& BuildData, USkeleton* Skeleton, UPackage* Package, FName MeshName)
+		{
+			USkeletalMesh* BakedMesh = NewObject<USkeletalMesh>(Package, MeshName, RF_Public | RF_Standalone);
+			BakedMesh->PreEditChange(nullptr);
+			BakedMesh->SetSkeleton(Skeleton);
+			BakedMesh->SetRefSkeleton(GatherData.RefSkeleton);
+
+			// Polygon groups find their material by slot name
+			TArray<FSkeletalMaterial> Materials = GatherData.Materials;
+			for (int32 MaterialIndex = 0; MaterialIndex < Materials.Num(); ++MaterialIndex)
+			{
+				Materials[MaterialIndex].MaterialSlotName = GetMaterialSlotName(MaterialIndex);
+				Materials[MaterialIndex].ImportedMaterialSlotName = GetMaterialSlotName(MaterialIndex);
+			}
+			BakedMesh->SetMaterials(Materials);
+			BakedMesh->SetHasVertexColors(BuildData.LODs[0]->StaticVertexBuffers.ColorVertexBuffer.GetNumVertices() > 0);
+
+			FSkeletalMeshModel* ImportedModel = BakedMesh->GetImportedModel();
+			ImportedModel->LODModels.Empty();
+			BakedMesh->ResetLODInfo();
+			for (int32 LODIndex = 0; LODIndex < GatherData.NumLODs; ++LODIndex)
+			{
+				// Merged LODs are final geometry, build must neither reduce them nor recompute their tangent space
+				FSkeletalMeshLODInfo LODInfo = GatherData.LODInfos[LODIndex];
+				LODInfo.BuildSettings.bRecomputeNormals = false;
+				LODInfo.BuildSettings.bRecomputeTangents = false;
+				LODInfo.ReductionSettings = FSkeletalMeshOptimizationSettings();
+				LODInfo.bHasBeenSimplified = false;
+				BakedMesh->AddLODInfo(LODInfo);
+				ImportedModel->LODModels.Add(new FSkeletalMeshLODModel());
+
+				FMeshDescription MeshDescription;
+				MakeMeshDescription(*BuildData.LODs[LODIndex], MeshDescription);
+				BakedMesh->CreateMeshDescription(LODIndex, MoveTemp(MeshDescription));
+				BakedMesh->CommitMeshDescription(LODIndex);
+			}
+
+			BakedMesh->CalculateInvRefMatrices();
+			BakedMesh->SetImportedBounds(GatherData.Bounds);
+			BakedMesh->PostEditChange();
+			return BakedMesh;
+		}
+
+		// Asset of a previous bake is moved out of the way, references to it resolve to the new one after save
+		UPackage* PreparePackage(const FString& PackageName, FName AssetName)
+		{
+			UPackage* Package = FPackageName::DoesPackageExist(PackageName) ? LoadPackage(nullptr, *PackageName, LOAD_None) : nullptr;
+			Package = Package ? Package : CreatePackage(*PackageName);
+			Package->FullyLoad();
+
+			if (UObject* PreviousAsset = StaticFindObjectFast(UObject::StaticClass(), Package, AssetName))
+			{
+				PreviousAsset->ClearFlags(RF_Public | RF_Standalone);
+				PreviousAsset->Rename(nullptr, GetTransientPackage(), REN_DontCreateRedirectors | REN_NonTransactional);
+			}
+			return Package;
+		}
+
+		bool SaveAsset(UObject* Asset)
+		{
+			UPackage* Package = Asset->GetPackage();
+			Package->MarkPackageDirty();
+
+			FSavePackageArgs SaveArgs;
+			SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+			SaveArgs.SaveFlags = SAVE_NoError;
+			const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+			return UPackage::SavePackage(Package, Asset, *Filename, SaveArgs);
+		}
+
+		bool BakeOutfit(const FMeshMergePrebakeOutfit& Outfit, const FString& OutputPath, FMeshMergePrebakedMesh& OutBakedMesh)
+		{
+			// 1. Same normalized part set the subsystem is handed at runtime
+			TArray<FMeshToMergeData> MeshesToMergeData = Outfit.LoadMeshesToMergeData();
+			MeshMergeUtilities::NormalizeMergeOrder(MeshesToMergeData);
+			if (Outfit.Name.IsNone() || MeshesToMergeData.IsEmpty() || !MeshMergeUtilities::CanMergeNatively(MeshesToMergeData))
+			{
+				UE_LOG(LogMeshMerge, Error, TEXT("MeshMergePrebake - Outfit '%s' has no name, misses parts or can't be merged natively (CPU access or weight precision)"),
+					*Outfit.Name.ToString());
+				return false;
+			}
+
+			// 2. Phases 1 and 2 of a merge, their LODs become the asset instead of a transient mesh
+			FMeshMergeGatherData GatherData;
+			if (!MeshMergeUtilities::GatherMergeData(MeshesToMergeData, GatherData))
+			{
+				return false;
+			}
+
+			if (GatherData.AtlasMaterialIndex != INDEX_NONE)
+			{
+				UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergePrebake - Outfit '%s' skipped, atlased merges are not baked"), *Outfit.Name.ToString());
+				return false;
+			}
+
+			if (!MeshMergeUtilities::AcquireSourceCopies(GatherData))
+			{
+				return false;
+			}
+
+			// Stream usage comes from editor-only material analysis, a cooked run would need streams stripped here
+			GatherData.MaxTexCoords = MAX_uint32;
+			GatherData.bStripVertexColors = false;
+
+			FMergedMeshBuildData BuildData;
+			MeshMergeUtilities::BuildMergedMeshData(GatherData, BuildData);
+			if (!BuildData.bSucceeded || BuildData.LODs.Num() != GatherData.NumLODs)
+			{
+				return false;
+			}
+
+			// 3. Asset and its manifest entry
+			const FName MeshName = *FString::Printf(TEXT("SK_Prebaked_%s"), *Outfit.Name.ToString());
+			UPackage* Package = PreparePackage(OutputPath / MeshName.ToString(), MeshName);
+			USkeletalMesh* BakedMesh = CreateBakedMesh(GatherData, BuildData, MeshesToMergeData[0].SkeletalMesh->GetSkeleton(), Package, MeshName);
+			if (!SaveAsset(BakedMesh))
+			{
+				UE_LOG(LogMeshMerge, Error, TEXT("MeshMergePrebake - Failed to save %s"), *Package->GetName());
+				return false;
+			}
+
+			OutBakedMesh.OutfitName = Outfit.Name;
+			OutBakedMesh.PartSetKey = MeshMergeUtilities::MakePrebakeKey(MeshMergeUtilities::MakeMergeKey(MeshesToMergeData));
+			OutBakedMesh.Mesh = BakedMesh;
+			MeshMergeUtilities::BuildMaterialSlotMap(MeshesToMergeData, OutBakedMesh.MaterialSlotMap);
+			OutBakedMesh.MergeSettingsHash = MeshMergeUtilities::MakeMergeSettingsHash();
+			OutBakedMesh.MaxTexCoords = GatherData.MaxTexCoords;
+			OutBakedMesh.bStripVertexColors = GatherData.bStripVertexColors;
+
+			UE_LOG(LogMeshMerge, Display, TEXT("MeshMergePrebake - Baked '%s': %d parts, %d LODs, %d vertices in LOD 0"),
+				*Outfit.Name.ToString(), MeshesToMergeData.Num(), GatherData.NumLODs, BuildData.LODs[0]->GetNumVertices());
+			return true;
+		}
+	}
+}
+
+#endif
+
+int32 UMeshMergePrebakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	// 1. Manifest from the command line, settings one otherwise
+	FString ManifestPath;
+	UMeshMergePrebakeManifest* Manifest = nullptr;
+	if (FParse::Value(*Params, TEXT("Manifest="), ManifestPath))
+	{
+		const FString ObjectPath = ManifestPath.Contains(TEXT(".")) ? ManifestPath : ManifestPath + TEXT(".") + FPackageName::GetShortName(ManifestPath);
+		Manifest = LoadObject<UMeshMergePrebakeManifest>(nullptr, *ObjectPath);
+	}
+	else
+	{
+		Manifest = UCustomizationSettings::Get()->GetPrebakeManifest();
+	}
+
+	if (!Manifest)
+	{
+		UE_LOG(LogMeshMerge, Error, TEXT("MeshMergePrebake - No manifest, pass -Manifest= or set Prebake Manifest in Customization Settings"));
+		return 1;
+	}
+
+	FString OutputPath = TEXT("/Game/MeshMerge/Prebaked");
+	FParse::Value(*Params, TEXT("OutputPath="), OutputPath);
+
+	// 2. Every outfit is baked again, entries of failed ones are dropped so they merge at runtime
+	TArray<FMeshMergePrebakedMesh> BakedMeshes;
+	for (const FMeshMergePrebakeOutfit& Outfit : Manifest->Outfits)
+	{
+		FMeshMergePrebakedMesh BakedMesh;
+		if (MeshMergePrebake::Private::BakeOutfit(Outfit, OutputPath, BakedMesh))
+		{
+			BakedMeshes.Add(MoveTemp(BakedMesh));
+		}
+	}
+
+	const int32 NumFailed = Manifest->Outfits.Num() - BakedMeshes.Num();
+	Manifest->SetBakedMeshes(MoveTemp(BakedMeshes));
+	if (!MeshMergePrebake::Private::SaveAsset(Manifest))
+	{
+		UE_LOG(LogMeshMerge, Error, TEXT("MeshMergePrebake - Failed to save manifest %s"), *Manifest->GetPathName());
+		return 1;
+	}
+
+	UE_LOG(LogMeshMerge, Display, TEXT("MeshMergePrebake - Baked %d of %d outfits into %s"),
+		Manifest->GetBakedMeshes().Num(), Manifest->Outfits.Num(), *OutputPath);
+	return NumFailed > 0 ? 1 : 0;
+#else
+	return 1;
+#endif
+}
@@ -0,0 +1,73 @@
+#include "Utilities/MeshMerger/MeshMergePrebakeManifest.h"
+
+#include "Algo/Count.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+
+TArray<FMeshToMergeData> FMeshMergePrebakeOutfit::LoadMeshesToMergeData() const
+{
+	TArray<FMeshToMergeData> MeshesToMergeData;
+	for (const FMeshMergePrebakePart& Part : Parts)
+	{
+		FMeshToMergeData& Data = MeshesToMergeData.AddDefaulted_GetRef();
+		Data.SkeletalMesh = Part.SkeletalMesh.LoadSynchronous();
+		if (!Data.SkeletalMesh)
+		{
+			return TArray<FMeshToMergeData>();
+		}
+
+		Data.SlotTag = Part.SlotTag;
+		Data.KeptSocketNames = Part.KeptSocketNames;
+		Data.CoveredSkinMask = Part.CoveredSkinMask;
+		for (const TSoftObjectPtr<UMaterialInterface>& MaterialOverride : Part.MaterialOverrides)
+		{
+			Data.MaterialOverrides.Add(MaterialOverride.LoadSynchronous());
+		}
+
+		for (const FMeshMergePrebakeRigidPart& RigidPart : Part.RigidMeshes)
+		{
+			FRigidMeshToMergeData& RigidData = Data.RigidMeshes.AddDefaulted_GetRef();
+			RigidData.StaticMesh = RigidPart.StaticMesh.LoadSynchronous();
+			RigidData.SocketName = RigidPart.SocketName;
+			RigidData.RelativeTransform = RigidPart.RelativeTransform;
+		}
+	}
+	return MeshesToMergeData;
+}
+
+void UMeshMergePrebakeManifest::PostLoad()
+{
+	Super::PostLoad();
+	RebuildLookup();
+}
+
+const FMeshMergePrebakedMesh* UMeshMergePrebakeManifest::FindBakedMesh(const FString& PartSetKey, uint32 MergeSettingsHash) const
+{
+	const int32* BakedMeshIndex = BakedMeshLookup.Find(PartSetKey);
+	return BakedMeshIndex && BakedMeshes[*BakedMeshIndex].MergeSettingsHash == MergeSettingsHash ? &BakedMeshes[*BakedMeshIndex] : nullptr;
+}
+
+int32 UMeshMergePrebakeManifest::GetNumStaleBakedMeshes(uint32 MergeSettingsHash) const
+{
+	return Algo::CountIf(BakedMeshes, [MergeSettingsHash](const FMeshMergePrebakedMesh& BakedMesh)
+	{
+		return BakedMesh.MergeSettingsHash != MergeSettingsHash;
+	});
+}
+
+void UMeshMergePrebakeManifest::SetBakedMeshes(TArray<FMeshMergePrebakedMesh>&& InBakedMeshes)
+{
+	BakedMeshes = MoveTemp(InBakedMeshes);
+	RebuildLookup();
+}
+
+void UMeshMergePrebakeManifest::RebuildLookup()
+{
+	BakedMeshLookup.Reset();
+	for (int32 BakedMeshIndex = 0; BakedMeshIndex < BakedMeshes.Num(); ++BakedMeshIndex)
+	{
+		BakedMeshLookup.Add(BakedMeshes[BakedMeshIndex].PartSetKey, BakedMeshIndex);
+	}
+}
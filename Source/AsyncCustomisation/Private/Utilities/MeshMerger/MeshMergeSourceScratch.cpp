@@ -0,0 +1,413 @@
+#include "Utilities/MeshMerger/MeshMergeSourceScratch.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "RHI.h"
+#include "RenderingThread.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "UObject/UObjectIterator.h"
+#include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+DECLARE_MEMORY_STAT(TEXT("Source Scratch Pool"), STAT_MeshMerge_SourceScratchBytes, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Source Read Backs"), STAT_MeshMerge_SourceReadBacks, STATGROUP_MeshMerge);
+
+namespace MeshMergeSourceScratch
+{
+	namespace Private
+	{
+		struct FPooledCopy
+		{
+			TWeakObjectPtr<const USkeletalMesh> Mesh;
+			TSharedPtr<FSkeletalMeshLODRenderData, ESPMode::ThreadSafe> Copy;
+			int64 NumBytes = 0;
+			uint64 LastUse = 0;
+		};
+
+		// Raw GPU data of one source LOD, filled on the render thread and decoded on the game thread
+		struct FReadBack
+		{
+			const FSkeletalMeshLODRenderData* Source = nullptr;
+			TSharedPtr<FSkeletalMeshLODRenderData, ESPMode::ThreadSafe> Copy;
+			TArray<uint8> WeightData;
+			TArray<uint32> WeightLookup;
+			TArray<uint8> IndexData;
+			bool bSucceeded = false;
+		};
+
+		// Keyed by the source LOD, render data of a mesh only moves when the mesh is rebuilt or destroyed
+		TMap<const FSkeletalMeshLODRenderData*, FPooledCopy> Pool;
+		int64 PooledBytes = 0;
+		uint64 UseCounter = 0;
+
+		int64 GetCPUBytes(const FSkeletalMeshLODRenderData& LODData)
+		{
+			const FStaticMeshVertexBuffers& VertexBuffers = LODData.StaticVertexBuffers;
+			const FSkinWeightVertexBuffer& SkinWeights = LODData.SkinWeightVertexBuffer;
+			const FRawStaticIndexBuffer16or32Interface* IndexBuffer = LODData.MultiSizeIndexContainer.GetIndexBuffer();
+			const int64 NumVertices = LODData.GetNumVertices();
+
+			return NumVertices * VertexBuffers.PositionVertexBuffer.GetStride()
+				+ VertexBuffers.StaticMeshVertexBuffer.GetTangentSize()
+				+ VertexBuffers.StaticMeshVertexBuffer.GetTexCoordSize()
+				+ static_cast<int64>(VertexBuffers.ColorVertexBuffer.GetNumVertices()) * VertexBuffers.ColorVertexBuffer.GetStride()
+				+ NumVertices * SkinWeights.GetMaxBoneInfluences() * ((SkinWeights.Use16BitBoneIndex() ? 2 : 1) + (SkinWeights.Use16BitBoneWeight() ? 2 : 1))
+				+ (IndexBuffer ? static_cast<int64>(IndexBuffer->Num()) * LODData.MultiSizeIndexContainer.GetDataTypeSize() : 0);
+		}
+
+		// Buffers and metadata of the copy are set up on the game thread, the render thread only fills them
+		TSharedPtr<FSkeletalMeshLODRenderData, ESPMode::ThreadSafe> AllocateCopy(const FSkeletalMeshLODRenderData& Source)
+		{
+			TSharedPtr<FSkeletalMeshLODRenderData, ESPMode::ThreadSafe> Copy = MakeShared<FSkeletalMeshLODRenderData, ESPMode::ThreadSafe>();
+			const uint32 NumVertices = Source.GetNumVertices();
+			const FStaticMeshVertexBuffer& SourceMeshVertexBuffer = Source.StaticVertexBuffers.StaticMeshVertexBuffer;
+
+			FStaticMeshVertexBuffers& VertexBuffers = Copy->StaticVertexBuffers;
+			VertexBuffers.PositionVertexBuffer.Init(NumVertices, true);
+			VertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(SourceMeshVertexBuffer.GetUseFullPrecisionUVs());
+			VertexBuffers.StaticMeshVertexBuffer.SetUseHighPrecisionTangentBasis(SourceMeshVertexBuffer.GetUseHighPrecisionTangentBasis());
+			VertexBuffers.StaticMeshVertexBuffer.Init(NumVertices, SourceMeshVertexBuffer.GetNumTexCoords(), true);
+			if (Source.StaticVertexBuffers.ColorVertexBuffer.GetNumVertices() > 0)
+			{
+				VertexBuffers.ColorVertexBuffer.Init(NumVertices, true);
+			}
+
+			for (const FSkelMeshRenderSection& SourceSection : Source.RenderSections)
+			{
+				FSkelMeshRenderSection& Section = Copy->RenderSections.AddDefaulted_GetRef();
+				Section.MaterialIndex = SourceSection.MaterialIndex;
+				Section.BaseIndex = SourceSection.BaseIndex;
+				Section.NumTriangles = SourceSection.NumTriangles;
+				Section.BaseVertexIndex = SourceSection.BaseVertexIndex;
+				Section.NumVertices = SourceSection.NumVertices;
+				Section.MaxBoneInfluences = SourceSection.MaxBoneInfluences;
+				Section.bRecomputeTangent = SourceSection.bRecomputeTangent;
+				Section.RecomputeTangentsVertexMaskChannel = SourceSection.RecomputeTangentsVertexMaskChannel;
+				Section.bCastShadow = SourceSection.bCastShadow;
+				Section.bVisibleInRayTracing = SourceSection.bVisibleInRayTracing;
+				Section.bDisabled = SourceSection.bDisabled;
+				Section.BoneMap = SourceSection.BoneMap;
+				Section.DuplicatedVerticesBuffer.Init(1, TMap<int, TArray<int32>>());
+			}
+
+			Copy->ActiveBoneIndices = Source.ActiveBoneIndices;
+			Copy->RequiredBones = Source.RequiredBones;
+			return Copy;
+		}
+
+		bool ReadBuffer(FRHICommandListImmediate& RHICmdList, FRHIBuffer* Buffer, void* OutData, uint32 NumBytes)
+		{
+			if (NumBytes == 0)
+			{
+				return true;
+			}
+
+			if (!Buffer || Buffer->GetSize() < NumBytes)
+			{
+				return false;
+			}
+
+			const void* Data = RHICmdList.LockBuffer(Buffer, 0, NumBytes, RLM_ReadOnly);
+			FMemory::Memcpy(OutData, Data, NumBytes);
+			RHICmdList.UnlockBuffer(Buffer);
+			return true;
+		}
+
+		// [Render thread]
+		void ReadBackBuffers(FRHICommandListImmediate& RHICmdList, FReadBack& ReadBack)
+		{
+			const FSkeletalMeshLODRenderData& Source = *ReadBack.Source;
+			const FStaticMeshVertexBuffers& SourceBuffers = Source.StaticVertexBuffers;
+			FStaticMeshVertexBuffers& TargetBuffers = ReadBack.Copy->StaticVertexBuffers;
+
+			// 1. Vertex streams straight into the preallocated copy
+			const uint32 NumVertices = TargetBuffers.PositionVertexBuffer.GetNumVertices();
+			ReadBack.bSucceeded = ReadBuffer(RHICmdList, SourceBuffers.PositionVertexBuffer.VertexBufferRHI, TargetBuffers.PositionVertexBuffer.GetVertexData(),
+					NumVertices * TargetBuffers.PositionVertexBuffer.GetStride())
+				&& ReadBuffer(RHICmdList, SourceBuffers.StaticMeshVertexBuffer.TangentsVertexBuffer.VertexBufferRHI, TargetBuffers.StaticMeshVertexBuffer.GetTangentData(),
+					TargetBuffers.StaticMeshVertexBuffer.GetTangentSize())
+				&& ReadBuffer(RHICmdList, SourceBuffers.StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI, TargetBuffers.StaticMeshVertexBuffer.GetTexCoordData(),
+					TargetBuffers.StaticMeshVertexBuffer.GetTexCoordSize())
+				&& ReadBuffer(RHICmdList, SourceBuffers.ColorVertexBuffer.VertexBufferRHI, TargetBuffers.ColorVertexBuffer.GetVertexData(),
+					TargetBuffers.ColorVertexBuffer.GetNumVertices() * TargetBuffers.ColorVertexBuffer.GetStride());
+
+			// 2. Packed skin weights and indices are decoded on the game thread
+			const FSkinWeightVertexBuffer& SourceWeights = Source.SkinWeightVertexBuffer;
+			const FSkinWeightDataVertexBuffer* WeightBuffer = SourceWeights.GetDataVertexBuffer();
+			FRHIBuffer* WeightBufferRHI = WeightBuffer ? WeightBuffer->VertexBufferRHI.GetReference() : nullptr;
+			ReadBack.WeightData.SetNumUninitialized(WeightBufferRHI ? WeightBufferRHI->GetSize() : 0);
+			ReadBack.bSucceeded &= WeightBufferRHI && ReadBuffer(RHICmdList, WeightBufferRHI, ReadBack.WeightData.GetData(), ReadBack.WeightData.Num());
+
+			if (SourceWeights.GetVariableBonesPerVertex())
+			{
+				const FSkinWeightLookupVertexBuffer* LookupBuffer = SourceWeights.GetLookupVertexBuffer();
+				ReadBack.WeightLookup.SetNumUninitialized(NumVertices);
+				ReadBack.bSucceeded &= LookupBuffer && ReadBuffer(RHICmdList, LookupBuffer->VertexBufferRHI, ReadBack.WeightLookup.GetData(), NumVertices * sizeof(uint32));
+			}
+
+			const FRawStaticIndexBuffer16or32Interface* IndexBuffer = Source.MultiSizeIndexContainer.GetIndexBuffer();
+			FRHIBuffer* IndexBufferRHI = IndexBuffer ? IndexBuffer->IndexBufferRHI.GetReference() : nullptr;
+			ReadBack.IndexData.SetNumUninitialized(IndexBufferRHI ? IndexBufferRHI->GetSize() : 0);
+			ReadBack.bSucceeded &= IndexBufferRHI && ReadBuffer(RHICmdList, IndexBufferRHI, ReadBack.IndexData.GetData(), ReadBack.IndexData.Num());
+		}
+
+		// Per vertex bone indices followed by weights. 8 bit weights are widened the way FSkinWeightVertexBuffer reads them.
+		void DecodeSkinWeights(const FSkinWeightVertexBuffer& SourceWeights, const FReadBack& ReadBack, uint32 NumVertices, TArray<FSkinWeightInfo>& OutSkinWeights)
+		{
+			const uint32 BoneIndexSize = SourceWeights.Use16BitBoneIndex() ? 2 : 1;
+			const uint32 BoneWeightSize = SourceWeights.Use16BitBoneWeight() ? 2 : 1;
+			const uint32 MaxBoneInfluences = SourceWeights.GetMaxBoneInfluences();
+			const uint8* WeightData = ReadBack.WeightData.GetData();
+
+			OutSkinWeights.SetNumZeroed(NumVertices);
+			for (uint32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+			{
+				uint32 Offset = VertexIndex * MaxBoneInfluences * (BoneIndexSize + BoneWeightSize);
+				uint32 NumInfluences = MaxBoneInfluences;
+				if (!ReadBack.WeightLookup.IsEmpty())
+				{
+					Offset = ReadBack.WeightLookup[VertexIndex] >> 8;
+					NumInfluences = ReadBack.WeightLookup[VertexIndex] & 0xff;
+				}
+
+				if (Offset + NumInfluences * (BoneIndexSize + BoneWeightSize) > static_cast<uint32>(ReadBack.WeightData.Num()))
+				{
+					continue;
+				}
+
+				FSkinWeightInfo& SkinWeight = OutSkinWeights[VertexIndex];
+				const uint8* BoneIndices = WeightData + Offset;
+				const uint8* BoneWeights = BoneIndices + NumInfluences * BoneIndexSize;
+				for (uint32 InfluenceIndex = 0; InfluenceIndex < FMath::Min<uint32>(NumInfluences, MAX_TOTAL_INFLUENCES); ++InfluenceIndex)
+				{
+					SkinWeight.InfluenceBones[InfluenceIndex] = BoneIndexSize == 2
+						? reinterpret_cast<const uint16*>(BoneIndices)[InfluenceIndex]
+						: BoneIndices[InfluenceIndex];
+					SkinWeight.InfluenceWeights[InfluenceIndex] = BoneWeightSize == 2
+						? reinterpret_cast<const uint16*>(BoneWeights)[InfluenceIndex]
+						: static_cast<uint16>((BoneWeights[InfluenceIndex] << 8) | BoneWeights[InfluenceIndex]);
+				}
+			}
+		}
+
+		// [Game thread] Turns read back data into CPU buffers of the copy
+		void FinishCopy(FReadBack& ReadBack)
+		{
+			const FSkeletalMeshLODRenderData& Source = *ReadBack.Source;
+			FSkeletalMeshLODRenderData& Copy = *ReadBack.Copy;
+
+			TArray<FSkinWeightInfo> SkinWeights;
+			DecodeSkinWeights(Source.SkinWeightVertexBuffer, ReadBack, Copy.GetNumVertices(), SkinWeights);
+
+			FSkinWeightVertexBuffer& SkinWeightBuffer = Copy.SkinWeightVertexBuffer;
+			SkinWeightBuffer.SetNeedsCPUAccess(true);
+			SkinWeightBuffer.SetMaxBoneInfluences(Source.SkinWeightVertexBuffer.GetMaxBoneInfluences());
+			SkinWeightBuffer.SetUse16BitBoneIndex(Source.SkinWeightVertexBuffer.Use16BitBoneIndex());
+			SkinWeightBuffer.SetUse16BitBoneWeight(Source.SkinWeightVertexBuffer.Use16BitBoneWeight());
+			SkinWeightBuffer = SkinWeights;
+
+			const uint8 IndexDataTypeSize = Source.MultiSizeIndexContainer.GetDataTypeSize();
+			TArray<uint32> Indices;
+			Indices.SetNumUninitialized(ReadBack.IndexData.Num() / IndexDataTypeSize);
+			for (int32 Index = 0; Index < Indices.Num(); ++Index)
+			{
+				Indices[Index] = IndexDataTypeSize == sizeof(uint16)
+					? reinterpret_cast<const uint16*>(ReadBack.IndexData.GetData())[Index]
+					: reinterpret_cast<const uint32*>(ReadBack.IndexData.GetData())[Index];
+			}
+			Copy.MultiSizeIndexContainer.RebuildIndexBuffer(IndexDataTypeSize, Indices);
+		}
+
+		void RemovePooled(const FSkeletalMeshLODRenderData* Key)
+		{
+			if (const FPooledCopy* PooledCopy = Pool.Find(Key))
+			{
+				PooledBytes -= PooledCopy->NumBytes;
+				Pool.Remove(Key);
+			}
+		}
+	}
+
+	bool IsReadBackSupported()
+	{
+		// Read only locks of static buffers are unsupported or stall the driver on GLES and mobile feature levels, null RHI has no data
+		return FApp::CanEverRender() && GMaxRHIFeatureLevel > ERHIFeatureLevel::ES3_1 && !IsOpenGLPlatform(GMaxRHIShaderPlatform);
+	}
+
+	bool IsEnabled()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetUseTransientSourceCopies() && IsReadBackSupported();
+	}
+
+	void AcquireCopies(TArray<FRequest>& InOutRequests)
+	{
+		check(IsInGameThread());
+		check(IsReadBackSupported());
+
+		// 1. Pooled copies of the same render data
+		TArray<Private::FReadBack> ReadBacks;
+		for (FRequest& Request : InOutRequests)
+		{
+			Private::FPooledCopy* PooledCopy = Private::Pool.Find(Request.LODData);
+			if (PooledCopy && PooledCopy->Mesh.Get() == Request.Mesh)
+			{
+				PooledCopy->LastUse = ++Private::UseCounter;
+				Request.Copy = PooledCopy->Copy;
+				continue;
+			}
+
+			if (!ReadBacks.ContainsByPredicate([&Request](const Private::FReadBack& ReadBack) { return ReadBack.Source == Request.LODData; }))
+			{
+				Private::FReadBack& ReadBack = ReadBacks.AddDefaulted_GetRef();
+				ReadBack.Source = Request.LODData;
+				ReadBack.Copy = Private::AllocateCopy(*Request.LODData);
+			}
+		}
+
+		if (ReadBacks.IsEmpty())
+		{
+			return;
+		}
+
+		// 2. Missing ones are read from GPU buffers, the game thread waits once for all of them
+		ENQUEUE_RENDER_COMMAND(MeshMergeReadBackSources)([&ReadBacks](FRHICommandListImmediate& RHICmdList)
+		{
+			for (Private::FReadBack& ReadBack : ReadBacks)
+			{
+				Private::ReadBackBuffers(RHICmdList, ReadBack);
+			}
+		});
+		FlushRenderingCommands();
+		INC_DWORD_STAT_BY(STAT_MeshMerge_SourceReadBacks, ReadBacks.Num());
+
+		// 3. Decoded copies go to the pool, Trim brings it back under budget once merges let go of them
+		for (FRequest& Request : InOutRequests)
+		{
+			Private::FReadBack* ReadBack = Request.Copy ? nullptr : ReadBacks.FindByPredicate([&Request](const Private::FReadBack& Candidate) { return Candidate.Source == Request.LODData; });
+			if (!ReadBack || !ReadBack->Copy)
+			{
+				continue;
+			}
+
+			if (!ReadBack->bSucceeded)
+			{
+				UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeSourceScratch::AcquireCopies - Failed to read back render data of %s"), *GetNameSafe(Request.Mesh));
+				ReadBack->Copy.Reset();
+				continue;
+			}
+
+			if (!Private::Pool.Contains(Request.LODData) || Private::Pool[Request.LODData].Copy != ReadBack->Copy)
+			{
+				Private::FinishCopy(*ReadBack);
+				Private::RemovePooled(Request.LODData);
+
+				Private::FPooledCopy& PooledCopy = Private::Pool.Add(Request.LODData);
+				PooledCopy.Mesh = Request.Mesh;
+				PooledCopy.Copy = ReadBack->Copy;
+				PooledCopy.NumBytes = Private::GetCPUBytes(*ReadBack->Copy);
+				Private::PooledBytes += PooledCopy.NumBytes;
+			}
+
+			Private::Pool[Request.LODData].LastUse = ++Private::UseCounter;
+			Request.Copy = ReadBack->Copy;
+		}
+
+		SET_MEMORY_STAT(STAT_MeshMerge_SourceScratchBytes, Private::PooledBytes);
+	}
+
+	void Trim()
+	{
+		check(IsInGameThread());
+
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		const int64 BudgetBytes = IsEnabled() ? static_cast<int64>(Settings->GetSourceScratchPoolBudgetMB()) * 1024 * 1024 : 0;
+
+		// Copies of destroyed meshes are never read again
+		TArray<TPair<uint64, const FSkeletalMeshLODRenderData*>, TInlineAllocator<16>> Evictable;
+		for (auto It = Private::Pool.CreateIterator(); It; ++It)
+		{
+			if (!It->Value.Copy.IsUnique())
+			{
+				continue;
+			}
+
+			if (!It->Value.Mesh.IsValid())
+			{
+				Private::PooledBytes -= It->Value.NumBytes;
+				It.RemoveCurrent();
+				continue;
+			}
+			Evictable.Emplace(It->Value.LastUse, It->Key);
+		}
+
+		Evictable.Sort([](const TPair<uint64, const FSkeletalMeshLODRenderData*>& A, const TPair<uint64, const FSkeletalMeshLODRenderData*>& B)
+		{
+			return A.Key < B.Key;
+		});
+		for (int32 Index = 0; Index < Evictable.Num() && Private::PooledBytes > BudgetBytes; ++Index)
+		{
+			Private::RemovePooled(Evictable[Index].Value);
+		}
+
+		SET_MEMORY_STAT(STAT_MeshMerge_SourceScratchBytes, Private::PooledBytes);
+	}
+
+	void Empty()
+	{
+		check(IsInGameThread());
+
+		for (auto It = Private::Pool.CreateIterator(); It; ++It)
+		{
+			if (It->Value.Copy.IsUnique())
+			{
+				Private::PooledBytes -= It->Value.NumBytes;
+				It.RemoveCurrent();
+			}
+		}
+		SET_MEMORY_STAT(STAT_MeshMerge_SourceScratchBytes, Private::PooledBytes);
+	}
+
+	int64 GetPooledBytes()
+	{
+		return Private::PooledBytes;
+	}
+
+	int64 GetResidentMeshCPUBytes()
+	{
+		int64 NumBytes = 0;
+		for (TObjectIterator<USkeletalMesh> It; It; ++It)
+		{
+			// Merge results live in the transient package
+			const FSkeletalMeshRenderData* RenderData = It->GetPackage() != GetTransientPackage() ? It->GetResourceForRendering() : nullptr;
+			if (!RenderData)
+			{
+				continue;
+			}
+
+			for (int32 LODIndex = RenderData->CurrentFirstLODIdx; LODIndex < RenderData->LODRenderData.Num(); ++LODIndex)
+			{
+				const FSkeletalMeshLODRenderData& LODData = RenderData->LODRenderData[LODIndex];
+				if (MeshMergeUtilities::HasCPUAccess(LODData))
+				{
+					NumBytes += Private::GetCPUBytes(LODData);
+				}
+			}
+		}
+		return NumBytes;
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommand MeshMergeSourceMemoryCommand(
+	TEXT("MeshMerge.SourceMemory"),
+	TEXT("Logs CPU bytes of source meshes keeping their buffers resident and of the transient source scratch pool"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		UE_LOG(LogMeshMerge, Display, TEXT("MeshMerge.SourceMemory - Resident source meshes %lld bytes, scratch pool %lld bytes, transient copies %s"),
+			MeshMergeSourceScratch::GetResidentMeshCPUBytes(), MeshMergeSourceScratch::GetPooledBytes(),
+			MeshMergeSourceScratch::IsEnabled() ? TEXT("enabled") : TEXT("disabled"));
+	}));
+
+#endif
@@ -0,0 +1,305 @@
+#include "Utilities/MeshMerger/MeshMergeSpeculationSubsystem.h"
+
+#include "Algo/AnyOf.h"
+#include "HAL/IConsoleManager.h"
+#include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/MeshMergeCacheSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+DECLARE_MEMORY_STAT(TEXT("Speculative Meshes"), STAT_MeshMerge_SpeculativeBytes, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Speculative Merges"), STAT_MeshMerge_SpeculativeMerges, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Speculation Hits"), STAT_MeshMerge_SpeculationHits, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Speculation Misses"), STAT_MeshMerge_SpeculationMisses, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Discarded Speculations"), STAT_MeshMerge_DiscardedSpeculations, STATGROUP_MeshMerge);
+
+
+UMeshMergeSpeculationSubsystem* UMeshMergeSpeculationSubsystem::Get(const UWorld* World)
+{
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	if (!World || !Settings || !Settings->GetEnableSpeculativeMerges() || Settings->GetSpeculativeMergeBudgetBytes() <= 0)
+	{
+		return nullptr;
+	}
+	return World->GetSubsystem<UMeshMergeSpeculationSubsystem>();
+}
+
+void UMeshMergeSpeculationSubsystem::Deinitialize()
+{
+	if (NumSpeculativeMerges > 0)
+	{
+		LogStats();
+	}
+
+	// World goes away with every merged mesh, nothing to release
+	Speculations.Empty();
+	NextMeshesToMergeData.Empty();
+	RunningKey.Reset();
+	SpeculativeBytes = 0;
+	SET_MEMORY_STAT(STAT_MeshMerge_SpeculativeBytes, 0);
+
+	Super::Deinitialize();
+}
+
+void UMeshMergeSpeculationSubsystem::Tick(float DeltaTime)
+{
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	const double Lifetime = Settings ? Settings->GetSpeculativeMergeLifetimeSeconds() : 0.f;
+	const double Now = FPlatformTime::Seconds();
+
+	// Merges with waiters belong to their commits already
+	TArray<FSkeletalMeshArrayKey, TInlineAllocator<4>> StaleKeys;
+	for (const TPair<FSkeletalMeshArrayKey, FSpeculativeMerge>& Pair : Speculations)
+	{
+		const FSpeculativeMerge& Speculation = Pair.Value;
+		if (Speculation.Waiters.IsEmpty() && (!Speculation.Owner.IsValid() || Now - Speculation.LastRequestTime > Lifetime))
+		{
+			StaleKeys.Add(Pair.Key);
+		}
+	}
+
+	for (const FSkeletalMeshArrayKey& StaleKey : StaleKeys)
+	{
+		Discard(StaleKey);
+	}
+}
+
+void UMeshMergeSpeculationSubsystem::RequestSpeculativeMerge(const UObject* Owner, const TArray<FMeshToMergeData>& MeshesToMergeData)
+{
+	if (!Owner || MeshesToMergeData.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FMeshToMergeData> NormalizedMeshesToMergeData = MeshesToMergeData;
+	MeshMergeUtilities::NormalizeMergeOrder(NormalizedMeshesToMergeData);
+	FSkeletalMeshArrayKey MergeKey = MeshMergeUtilities::MakeMergeKey(NormalizedMeshesToMergeData);
+
+	// 1. Hovered again, keep it alive
+	if (FSpeculativeMerge* Speculation = Speculations.Find(MergeKey))
+	{
+		Speculation->Owner = Owner;
+		Speculation->LastRequestTime = FPlatformTime::Seconds();
+		return;
+	}
+
+	// 2. Commit of a cached part set costs nothing already
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	UMeshMergeCacheSubsystem* MeshMergeCache = Settings && Settings->GetEnableMeshMergeCache() ? UMeshMergeCacheSubsystem::Get(GetWorld()) : nullptr;
+	if (MeshMergeCache && MeshMergeCache->FindMesh(MergeKey))
+	{
+		return;
+	}
+
+	// 3. One speculation runs at a time, the newest hover waits for it
+	if (RunningKey.IsSet())
+	{
+		NextMeshesToMergeData = MoveTemp(NormalizedMeshesToMergeData);
+		NextOwner = Owner;
+		return;
+	}
+
+	FSpeculativeMerge& Speculation = Speculations.Add(MergeKey);
+	Speculation.Owner = Owner;
+	Speculation.LastRequestTime = FPlatformTime::Seconds();
+	RunningKey = MergeKey;
+
+	++NumSpeculativeMerges;
+	INC_DWORD_STAT(STAT_MeshMerge_SpeculativeMerges);
+
+	// Real merges go first, result may also arrive right away from the caches
+	FMeshMergeRequestParams RequestParams;
+	RequestParams.Requester = this;
+	RequestParams.Priority = EMeshMergePriority::Low;
+	UMeshMergeSubsystem::MergeMeshesWithSettings(GetWorld(), NormalizedMeshesToMergeData, nullptr,
+		FOnMeshMergeCompleteDelegate::CreateUObject(this, &UMeshMergeSpeculationSubsystem::OnSpeculativeMergeCompleted, MoveTemp(MergeKey)), RequestParams);
+}
+
+bool UMeshMergeSpeculationSubsystem::ClaimSpeculation(const FSkeletalMeshArrayKey& MergeKey, const FMeshMergeRequestParams& RequestParams, FOnMeshMergeCompleteDelegate& OnMeshMergeComplete)
+{
+	if (RequestParams.Requester == this)
+	{
+		return false;
+	}
+
+	FSpeculativeMerge* Speculation = Speculations.Find(MergeKey);
+	if (!Speculation)
+	{
+		// Only commits of owners that browsed something count, other characters never speculate
+		const UObject* Requester = RequestParams.Requester;
+		const bool bRequesterSpeculated = Requester && (NextOwner.Get() == Requester || Algo::AnyOf(Speculations, [Requester](const TPair<FSkeletalMeshArrayKey, FSpeculativeMerge>& Pair)
+		{
+			return Pair.Value.Owner.Get() == Requester;
+		}));
+		if (bRequesterSpeculated)
+		{
+			++NumMisses;
+			INC_DWORD_STAT(STAT_MeshMerge_SpeculationMisses);
+		}
+		return false;
+	}
+
+	++NumHits;
+	INC_DWORD_STAT(STAT_MeshMerge_SpeculationHits);
+
+	// 1. Still merging, commit waits for it at its own priority
+	if (!Speculation->Mesh)
+	{
+		Speculation->Waiters.Add(MoveTemp(OnMeshMergeComplete));
+		UMeshMergeSubsystem::RaiseMergePriority(GetWorld(), this, RequestParams.Priority);
+		return true;
+	}
+
+	// 2. Mesh goes to the committing owner, it is no longer a speculation
+	USkeletalMesh* Mesh = Speculation->Mesh;
+	SpeculativeBytes -= Speculation->SizeBytes;
+	Speculations.Remove(MergeKey);
+	SET_MEMORY_STAT(STAT_MeshMerge_SpeculativeBytes, SpeculativeBytes);
+
+	UE_LOG(LogMeshMerge, Verbose, TEXT("UMeshMergeSpeculationSubsystem::ClaimSpeculation - %s committed to speculated %s"), *GetNameSafe(RequestParams.Requester), *GetNameSafe(Mesh));
+	OnMeshMergeComplete.ExecuteIfBound(Mesh);
+	return true;
+}
+
+void UMeshMergeSpeculationSubsystem::DiscardSpeculations(const UObject* Owner)
+{
+	if (NextOwner.Get() == Owner)
+	{
+		NextMeshesToMergeData.Empty();
+		NextOwner.Reset();
+	}
+
+	TArray<FSkeletalMeshArrayKey, TInlineAllocator<4>> OwnedKeys;
+	for (const TPair<FSkeletalMeshArrayKey, FSpeculativeMerge>& Pair : Speculations)
+	{
+		if (Pair.Value.Owner.Get() == Owner && Pair.Value.Waiters.IsEmpty())
+		{
+			OwnedKeys.Add(Pair.Key);
+		}
+	}
+
+	for (const FSkeletalMeshArrayKey& OwnedKey : OwnedKeys)
+	{
+		Discard(OwnedKey);
+	}
+}
+
+float UMeshMergeSpeculationSubsystem::GetHitRate() const
+{
+	const int32 NumCommits = NumHits + NumMisses;
+	return NumCommits > 0 ? static_cast<float>(NumHits) / NumCommits : 0.f;
+}
+
+void UMeshMergeSpeculationSubsystem::LogStats() const
+{
+	UE_LOG(LogMeshMerge, Log, TEXT("UMeshMergeSpeculationSubsystem - %d speculative merges, %d hits, %d misses (hit rate %.1f%%), %d discarded, %d kept (%lld bytes)"),
+		NumSpeculativeMerges, NumHits, NumMisses, GetHitRate() * 100.f, NumDiscarded, Speculations.Num(), SpeculativeBytes);
+}
+
+void UMeshMergeSpeculationSubsystem::StartNextSpeculation()
+{
+	if (NextMeshesToMergeData.IsEmpty())
+	{
+		return;
+	}
+
+	const TArray<FMeshToMergeData> MeshesToMergeData = MoveTemp(NextMeshesToMergeData);
+	const UObject* Owner = NextOwner.Get();
+	NextMeshesToMergeData.Reset();
+	NextOwner.Reset();
+
+	RequestSpeculativeMerge(Owner, MeshesToMergeData);
+}
+
+void UMeshMergeSpeculationSubsystem::OnSpeculativeMergeCompleted(USkeletalMesh* MergedMesh, FSkeletalMeshArrayKey MergeKey)
+{
+	RunningKey.Reset();
+
+	FSpeculativeMerge* Speculation = Speculations.Find(MergeKey);
+	if (!Speculation || !MergedMesh || !Speculation->Waiters.IsEmpty())
+	{
+		// Commits take the result, entry is removed first as their delegates may speculate again
+		TArray<FOnMeshMergeCompleteDelegate> Waiters = Speculation ? MoveTemp(Speculation->Waiters) : TArray<FOnMeshMergeCompleteDelegate>();
+		Speculations.Remove(MergeKey);
+
+		if (Waiters.IsEmpty())
+		{
+			// Discarded while it was merging
+			UMeshMergeSubsystem::DiscardMergedMesh(GetWorld(), MergedMesh);
+		}
+		for (FOnMeshMergeCompleteDelegate& Waiter : Waiters)
+		{
+			Waiter.ExecuteIfBound(MergedMesh);
+		}
+	}
+	else
+	{
+		Speculation->Mesh = MergedMesh;
+		Speculation->SizeBytes = MergedMesh->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		SpeculativeBytes += Speculation->SizeBytes;
+
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		DiscardToBudget(Settings ? Settings->GetSpeculativeMergeBudgetBytes() : 0);
+		SET_MEMORY_STAT(STAT_MeshMerge_SpeculativeBytes, SpeculativeBytes);
+	}
+
+	StartNextSpeculation();
+}
+
+void UMeshMergeSpeculationSubsystem::Discard(const FSkeletalMeshArrayKey& MergeKey)
+{
+	FSpeculativeMerge Speculation;
+	if (!Speculations.RemoveAndCopyValue(MergeKey, Speculation))
+	{
+		return;
+	}
+
+	++NumDiscarded;
+	INC_DWORD_STAT(STAT_MeshMerge_DiscardedSpeculations);
+
+	// Running merge releases its mesh on completion
+	if (Speculation.Mesh)
+	{
+		SpeculativeBytes -= Speculation.SizeBytes;
+		SET_MEMORY_STAT(STAT_MeshMerge_SpeculativeBytes, SpeculativeBytes);
+		UMeshMergeSubsystem::DiscardMergedMesh(GetWorld(), Speculation.Mesh);
+	}
+}
+
+void UMeshMergeSpeculationSubsystem::DiscardToBudget(int64 BudgetBytes)
+{
+	while (SpeculativeBytes > BudgetBytes)
+	{
+		const FSkeletalMeshArrayKey* OldestKey = nullptr;
+		double OldestRequestTime = MAX_dbl;
+		for (const TPair<FSkeletalMeshArrayKey, FSpeculativeMerge>& Pair : Speculations)
+		{
+			if (Pair.Value.Mesh && Pair.Value.LastRequestTime < OldestRequestTime)
+			{
+				OldestKey = &Pair.Key;
+				OldestRequestTime = Pair.Value.LastRequestTime;
+			}
+		}
+
+		if (!OldestKey)
+		{
+			break;
+		}
+		Discard(FSkeletalMeshArrayKey(*OldestKey));
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommandWithWorld MeshMergeSpeculationStatsCommand(
+	TEXT("MeshMerge.SpeculationStats"),
+	TEXT("Logs speculative merges of the world, their hit rate on commits and memory they hold"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UMeshMergeSpeculationSubsystem* Speculation = World ? World->GetSubsystem<UMeshMergeSpeculationSubsystem>() : nullptr)
+		{
+			Speculation->LogStats();
+		}
+	}));
+
+#endif
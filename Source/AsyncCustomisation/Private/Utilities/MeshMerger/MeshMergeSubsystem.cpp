@@ -2,37 +2,571 @@
 
 #include "SkeletalMeshMerge.h"
 #include "Algo/AllOf.h"
+#include "Engine/AssetManager.h"
 #include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/AsyncSkeletalMeshMerge.h"
+#include "Utilities/MeshMerger/MergedMeshLayoutUserData.h"
+#include "Utilities/MeshMerger/MeshMergeCacheSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeDiskCache.h"
+#include "Utilities/MeshMerger/MeshMergePrebakeManifest.h"
+#include "Utilities/MeshMerger/MeshMergeSourceScratch.h"
+#include "Utilities/MeshMerger/MeshMergeSpeculationSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tick"), STAT_MeshMerge_Tick, STATGROUP_MeshMerge);
+DECLARE_CYCLE_STAT(TEXT("Merge Job"), STAT_MeshMerge_Job, STATGROUP_MeshMerge);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued Jobs"), STAT_MeshMerge_QueuedJobs, STATGROUP_MeshMerge);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Async Merges"), STAT_MeshMerge_ActiveAsyncMerges, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Processed Jobs"), STAT_MeshMerge_ProcessedJobs, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Superseded Jobs"), STAT_MeshMerge_SupersededJobs, STATGROUP_MeshMerge);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Job Wait (ms)"), STAT_MeshMerge_JobWaitMs, STATGROUP_MeshMerge);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Job Cost (ms)"), STAT_MeshMerge_JobCostMs, STATGROUP_MeshMerge);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Meshes"), STAT_MeshMerge_PooledMeshes, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Recycled Meshes"), STAT_MeshMerge_RecycledMeshes, STATGROUP_MeshMerge);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Merge Plans"), STAT_MeshMerge_MergePlans, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Compiled Merge Plans"), STAT_MeshMerge_CompiledMergePlans, STATGROUP_MeshMerge);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Prebaked Meshes"), STAT_MeshMerge_PrebakedMeshes, STATGROUP_MeshMerge);
+
+namespace
+{
+	UMeshMergeCacheSubsystem* GetMeshMergeCache(const UWorld* World)
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetEnableMeshMergeCache() ? UMeshMergeCacheSubsystem::Get(World) : nullptr;
+	}
+}
 
 
 void UMeshMergeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+
+	// One load per world instead of a hitch on its first merge
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	PrebakeManifest = Settings ? Settings->GetPrebakeManifest() : nullptr;
+	if (PrebakeManifest)
+	{
+		const int32 NumStaleBakedMeshes = PrebakeManifest->GetNumStaleBakedMeshes(MeshMergeUtilities::MakeMergeSettingsHash());
+		UE_CLOG(NumStaleBakedMeshes > 0, LogMeshMerge, Warning, TEXT("UMeshMergeSubsystem::Initialize - %d of %d outfits in %s were baked under other merge settings and are merged instead, run the MeshMergePrebake commandlet again"),
+			NumStaleBakedMeshes, PrebakeManifest->GetBakedMeshes().Num(), *PrebakeManifest->GetPathName());
+	}
+}
+
+void UMeshMergeSubsystem::Deinitialize()
+{
+	// Workers may still read source render data, wait for them before meshes can be collected
+	TArray<TObjectPtr<UAsyncSkeletalMeshMerge>> MergesToCancel = MoveTemp(ActiveAsyncMerges);
+	for (UAsyncSkeletalMeshMerge* MergeTask : MergesToCancel)
+	{
+		if (MergeTask)
+		{
+			MergeTask->Cancel();
+		}
+	}
+	ActiveAsyncMerges.Empty();
+	QueuedJobs.Empty();
+	LatestRequestSerials.Empty();
+	PendingReleases.Empty();
+	PooledMeshes.Empty();
+	MergedMeshUsers.Empty();
+	PrebakeManifest = nullptr;
+	MergePlans.Empty();
+	MeshMergeSourceScratch::Empty();
 	
+	Super::Deinitialize();
 }
 
 void UMeshMergeSubsystem::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_MeshMerge_Tick);
+	const double TickStartTime = FPlatformTime::Seconds();
+
+	// Completion delegates may queue new merges, so finished ones are collected first
+	TArray<UAsyncSkeletalMeshMerge*, TInlineAllocator<8>> FinishedMerges;
+	for (UAsyncSkeletalMeshMerge* MergeTask : ActiveAsyncMerges)
+	{
+		if (!MergeTask || MergeTask->IsBuildCompleted())
+		{
+			FinishedMerges.Add(MergeTask);
+		}
+	}
+
+	for (UAsyncSkeletalMeshMerge* MergeTask : FinishedMerges)
+	{
+		ActiveAsyncMerges.Remove(MergeTask);
+		if (MergeTask)
+		{
+			MergeTask->TryFinish();
+		}
+	}
 
+	UpdatePendingReleases();
+	PruneRequestSerials();
+
+	// Source copies finished merges read are released down to the pool budget
+	MeshMergeSourceScratch::Trim();
+
+	// Finishing merges is part of the frame budget too
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	const double BudgetSeconds = (Settings ? Settings->GetMeshMergeFrameBudgetMs() : 0.f) / 1000.0;
+	ProcessQueuedJobs(BudgetSeconds - (FPlatformTime::Seconds() - TickStartTime));
+
+	SET_DWORD_STAT(STAT_MeshMerge_QueuedJobs, QueuedJobs.Num());
+	SET_DWORD_STAT(STAT_MeshMerge_ActiveAsyncMerges, ActiveAsyncMerges.Num());
+	SET_DWORD_STAT(STAT_MeshMerge_PooledMeshes, PooledMeshes.Num());
+	SET_DWORD_STAT(STAT_MeshMerge_MergePlans, MergePlans.Num());
 }
 
-bool UMeshMergeSubsystem::MergeMeshesWithSettings(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete)
+bool UMeshMergeSubsystem::MergeMeshesWithSettings(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete,
+	const FMeshMergeRequestParams& RequestParams)
 {
+	// Every path below may complete later, a newer request of the requester must win over this one wherever it is by then
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (MeshMergeSubsystem && RequestParams.Requester)
+	{
+		OnMeshMergeComplete = MeshMergeSubsystem->TagRequest(RequestParams.Requester, MoveTemp(OnMeshMergeComplete));
+	}
+
 	if (MeshesToMergeData.Num() == 0)
 	{
 		OnMeshMergeComplete.ExecuteIfBound(nullptr);
 		return false;
 	}
 	
+	TArray<FMeshToMergeData> NormalizedMeshesToMergeData = MeshesToMergeData;
+	MeshMergeUtilities::NormalizeMergeOrder(NormalizedMeshesToMergeData);
+
+	// Build the Material Index to Slot Tag map if the output map is provided
+	if (OutMaterialMap)
+	{
+		MeshMergeUtilities::BuildMaterialSlotMap(NormalizedMeshesToMergeData, *OutMaterialMap);
+	}
+
+	// Cache hit costs nothing, no need to wait in the queue
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	UMeshMergeCacheSubsystem* MeshMergeCache = GetMeshMergeCache(World);
+	const UMeshMergePrebakeManifest* Manifest = MeshMergeSubsystem ? MeshMergeSubsystem->PrebakeManifest.Get() : nullptr;
+	UMeshMergeSpeculationSubsystem* MeshMergeSpeculation = UMeshMergeSpeculationSubsystem::Get(World);
+	if (MeshMergeCache || Manifest || MeshMergeSpeculation)
+	{
+		const FSkeletalMeshArrayKey MergeKey = MeshMergeUtilities::MakeMergeKey(NormalizedMeshesToMergeData);
+
+		// Outfit previewed in the inventory is merged already or on its way, checked first to count the hit
+		if (MeshMergeSpeculation && MeshMergeSpeculation->ClaimSpeculation(MergeKey, RequestParams, OnMeshMergeComplete))
+		{
+			return true;
+		}
+
+		if (USkeletalMesh* CachedMesh = MeshMergeCache ? MeshMergeCache->FindMesh(MergeKey) : nullptr)
+		{
+			OnMeshMergeComplete.ExecuteIfBound(CachedMesh);
+			return true;
+		}
+
+		// Baked part set is a plain asset load, nothing is merged
+		if (Manifest && LoadPrebakedMesh(World, *Manifest, MergeKey, NormalizedMeshesToMergeData, OutMaterialMap, OnMeshMergeComplete))
+		{
+			return true;
+		}
+	}
+
+	if (MeshMergeSubsystem && Settings && Settings->GetMeshMergeFrameBudgetMs() > 0.f)
+	{
+		FMeshMergeJob Job;
+		Job.MeshesToMergeData = MoveTemp(NormalizedMeshesToMergeData);
+		Job.Requester = RequestParams.Requester;
+		Job.Priority = RequestParams.Priority;
+		Job.PreviousMergedMesh = RequestParams.PreviousMergedMesh;
+		Job.OnMeshMergeComplete = MoveTemp(OnMeshMergeComplete);
+		Job.EnqueueTime = FPlatformTime::Seconds();
+		MeshMergeSubsystem->EnqueueJob(MoveTemp(Job));
+		return true;
+	}
+
+	return ExecuteMerge(World, NormalizedMeshesToMergeData, MoveTemp(OnMeshMergeComplete), RequestParams.PreviousMergedMesh);
+}
+
+bool UMeshMergeSubsystem::LoadPrebakedMesh(const UWorld* World, const UMeshMergePrebakeManifest& Manifest, const FSkeletalMeshArrayKey& MergeKey,
+	const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate& OnMeshMergeComplete)
+{
+	const FMeshMergePrebakedMesh* BakedMesh = Manifest.FindBakedMesh(MeshMergeUtilities::MakePrebakeKey(MergeKey), MeshMergeUtilities::MakeMergeSettingsHash());
+	if (!BakedMesh || BakedMesh->Mesh.IsNull())
+	{
+		return false;
+	}
+
+	// Baked mesh has to keep every stream the resolved materials read
+	if (BakedMesh->MaxTexCoords < MergeKey.MaxTexCoords || (BakedMesh->bStripVertexColors && !MergeKey.bStripVertexColors))
+	{
+		UE_LOG(LogMeshMerge, Verbose, TEXT("UMeshMergeSubsystem::LoadPrebakedMesh - %s stripped vertex streams its materials read, merging the part set instead"), *BakedMesh->Mesh.ToString());
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_MeshMerge_PrebakedMeshes);
+	if (OutMaterialMap)
+	{
+		*OutMaterialMap = BakedMesh->MaterialSlotMap;
+	}
+
+	if (USkeletalMesh* LoadedMesh = BakedMesh->Mesh.Get())
+	{
+		OnMeshMergeComplete.ExecuteIfBound(LoadedMesh);
+		return true;
+	}
+
+	// Missing asset falls back to a regular merge of the part set
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(BakedMesh->Mesh.ToSoftObjectPath(), FStreamableDelegate::CreateLambda(
+		[WeakWorld = TWeakObjectPtr<const UWorld>(World), Mesh = BakedMesh->Mesh, MeshesToMergeData, OnMeshMergeComplete = MoveTemp(OnMeshMergeComplete)]() mutable
+		{
+			if (USkeletalMesh* LoadedMesh = Mesh.Get())
+			{
+				OnMeshMergeComplete.ExecuteIfBound(LoadedMesh);
+				return;
+			}
+
+			UE_LOG(LogMeshMerge, Warning, TEXT("UMeshMergeSubsystem::LoadPrebakedMesh - Failed to load %s, merging the part set instead"), *Mesh.ToString());
+			ExecuteMerge(WeakWorld.Get(), MeshesToMergeData, MoveTemp(OnMeshMergeComplete));
+		}));
+	return true;
+}
+
+void UMeshMergeSubsystem::CancelMergeRequest(const UWorld* World, const UObject* Requester)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (!MeshMergeSubsystem || !Requester)
+	{
+		return;
+	}
+
+	const int32 NumRemoved = MeshMergeSubsystem->QueuedJobs.RemoveAll([Requester](const FMeshMergeJob& Job)
+	{
+		return Job.Requester.Get() == Requester;
+	});
+
+	// In-flight merges still finish for the caches, their results are no longer handed to the requester
+	MeshMergeSubsystem->LatestRequestSerials.Remove(Requester);
+	MeshMergeSubsystem->PruneRequestSerials();
+
+	UE_CLOG(NumRemoved > 0, LogMeshMerge, Verbose, TEXT("UMeshMergeSubsystem::CancelMergeRequest - Dropped %d queued jobs of %s"), NumRemoved, *GetNameSafe(Requester));
+}
+
+void UMeshMergeSubsystem::RaiseMergePriority(const UWorld* World, const UObject* Requester, EMeshMergePriority Priority)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (!MeshMergeSubsystem || !Requester)
+	{
+		return;
+	}
+
+	const int32 JobIndex = MeshMergeSubsystem->QueuedJobs.IndexOfByPredicate([Requester](const FMeshMergeJob& Job)
+	{
+		return Job.Requester.Get() == Requester;
+	});
+	if (JobIndex == INDEX_NONE || MeshMergeSubsystem->QueuedJobs[JobIndex].Priority >= Priority)
+	{
+		return;
+	}
+
+	// Requeued behind jobs already waiting at that priority
+	FMeshMergeJob Job = MoveTemp(MeshMergeSubsystem->QueuedJobs[JobIndex]);
+	MeshMergeSubsystem->QueuedJobs.RemoveAt(JobIndex);
+	Job.Priority = Priority;
+	MeshMergeSubsystem->EnqueueJob(MoveTemp(Job));
+}
+
+void UMeshMergeSubsystem::RetainMergedMesh(const UWorld* World, USkeletalMesh* MergedMesh)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (MeshMergeSubsystem && IsValid(MergedMesh) && MergedMesh->GetPackage() == GetTransientPackage())
+	{
+		++MeshMergeSubsystem->MergedMeshUsers.FindOrAdd(MergedMesh);
+	}
+}
+
+void UMeshMergeSubsystem::ReleaseMergedMesh(const UWorld* World, USkeletalMesh* MergedMesh)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (!MeshMergeSubsystem || !MergedMesh)
+	{
+		return;
+	}
+
+	if (int32* NumUsers = MeshMergeSubsystem->MergedMeshUsers.Find(MergedMesh))
+	{
+		if (--*NumUsers > 0)
+		{
+			return;
+		}
+		MeshMergeSubsystem->MergedMeshUsers.Remove(MergedMesh);
+	}
+	MeshMergeSubsystem->RecycleMergedMesh(MergedMesh);
+}
+
+void UMeshMergeSubsystem::DiscardMergedMesh(const UWorld* World, USkeletalMesh* MergedMesh)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (MeshMergeSubsystem && MergedMesh && !MeshMergeSubsystem->MergedMeshUsers.Contains(MergedMesh))
+	{
+		MeshMergeSubsystem->RecycleMergedMesh(MergedMesh);
+	}
+}
+
+void UMeshMergeSubsystem::RecycleMergedMesh(USkeletalMesh* MergedMesh)
+{
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	if (!Settings || Settings->GetMeshMergePoolSize() <= 0)
+	{
+		return;
+	}
+
+	// 1. Only merge results are pooled, never source assets
+	if (!IsValid(MergedMesh) || MergedMesh->GetPackage() != GetTransientPackage())
+	{
+		return;
+	}
+
+	const bool bAlreadyReleased = PooledMeshes.Contains(MergedMesh)
+		|| PendingReleases.ContainsByPredicate([MergedMesh](const FPendingMeshRelease& Pending) { return Pending.Mesh == MergedMesh; });
+	if (bAlreadyReleased)
+	{
+		return;
+	}
+
+	// 2. Cache may hand the mesh out to another character at any time
+	if (const UMeshMergeCacheSubsystem* MeshMergeCache = UMeshMergeCacheSubsystem::Get(GetWorld()); MeshMergeCache && MeshMergeCache->ContainsMesh(MergedMesh))
+	{
+		return;
+	}
+
+	// 3. GPU memory goes away now, the object waits for the render thread before it can be emptied
+	MergedMesh->ReleaseResources();
+
+	FPendingMeshRelease& PendingRelease = PendingReleases.AddDefaulted_GetRef();
+	PendingRelease.Mesh = MergedMesh;
+	PendingRelease.ReleaseFence = MakeShared<FRenderCommandFence>();
+	PendingRelease.ReleaseFence->BeginFence();
+}
+
+USkeletalMesh* UMeshMergeSubsystem::AcquirePooledMesh(const UWorld* World)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (!MeshMergeSubsystem || MeshMergeSubsystem->PooledMeshes.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	INC_DWORD_STAT(STAT_MeshMerge_RecycledMeshes);
+	return MeshMergeSubsystem->PooledMeshes.Pop(EAllowShrinking::No);
+}
+
+TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> UMeshMergeSubsystem::FindOrCompileMergePlan(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	const int32 MaxCachedMergePlans = Settings ? Settings->GetMaxCachedMergePlans() : 0;
+	if (!MeshMergeSubsystem || MaxCachedMergePlans <= 0)
+	{
+		return nullptr;
+	}
+
+	// 1. Same part set with any skins, still valid unless its meshes were reloaded or streamed other LODs
+	FSkeletalMeshArrayKey PlanKey = MeshMergeUtilities::MakeMergePlanKey(MeshesToMergeData);
+	if (FCachedMergePlan* CachedPlan = MeshMergeSubsystem->MergePlans.Find(PlanKey))
+	{
+		if (MeshMergeUtilities::IsMergePlanValid(*CachedPlan->Plan, MeshesToMergeData))
+		{
+			CachedPlan->LastUseTime = FPlatformTime::Seconds();
+			return CachedPlan->Plan;
+		}
+		MeshMergeSubsystem->MergePlans.Remove(PlanKey);
+	}
+
+	// 2. Compile, failed part sets are cached as failed plans so lookups and merges of them don't compile and log again
+	TSharedRef<FMeshMergePlan, ESPMode::ThreadSafe> Plan = MakeShared<FMeshMergePlan, ESPMode::ThreadSafe>();
+	if (MeshMergeUtilities::CompileMergePlan(MeshesToMergeData, *Plan))
+	{
+		INC_DWORD_STAT(STAT_MeshMerge_CompiledMergePlans);
+	}
+
+	// 3. Least recently used plan makes room
+	if (MeshMergeSubsystem->MergePlans.Num() >= MaxCachedMergePlans)
+	{
+		const FSkeletalMeshArrayKey* OldestKey = nullptr;
+		double OldestUseTime = MAX_dbl;
+		for (const TPair<FSkeletalMeshArrayKey, FCachedMergePlan>& Pair : MeshMergeSubsystem->MergePlans)
+		{
+			if (Pair.Value.LastUseTime < OldestUseTime)
+			{
+				OldestKey = &Pair.Key;
+				OldestUseTime = Pair.Value.LastUseTime;
+			}
+		}
+		MeshMergeSubsystem->MergePlans.Remove(FSkeletalMeshArrayKey(*OldestKey));
+	}
+
+	FCachedMergePlan& CachedPlan = MeshMergeSubsystem->MergePlans.Add(MoveTemp(PlanKey));
+	CachedPlan.Plan = Plan;
+	CachedPlan.LastUseTime = FPlatformTime::Seconds();
+	return CachedPlan.Plan;
+}
+
+void UMeshMergeSubsystem::UpdatePendingReleases()
+{
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	const int32 PoolSize = Settings ? Settings->GetMeshMergePoolSize() : 0;
+
+	for (int32 Index = PendingReleases.Num() - 1; Index >= 0; --Index)
+	{
+		FPendingMeshRelease& PendingRelease = PendingReleases[Index];
+		USkeletalMesh* Mesh = PendingRelease.Mesh;
+
+		// Incremental merge may still copy parts out of its CPU buffers
+		const bool bReadByMerge = ActiveAsyncMerges.ContainsByPredicate([Mesh](const UAsyncSkeletalMeshMerge* MergeTask)
+		{
+			return MergeTask && MergeTask->IsReadingMesh(Mesh);
+		});
+		if (Mesh && (bReadByMerge || !PendingRelease.ReleaseFence->IsFenceComplete()))
+		{
+			continue;
+		}
+
+		// CPU copies and the part layout are dropped, only the object itself is kept. LOD buffers are allocated by every merge
+		// and handed over to the mesh, so their memory is not reused. Pool overflow goes to GC.
+		if (Mesh && PooledMeshes.Num() < PoolSize)
+		{
+			Mesh->RemoveUserDataOfClass(UMergedMeshLayoutUserData::StaticClass());
+			Mesh->ResetLODInfo();
+			Mesh->AllocateResourceForRendering();
+			PooledMeshes.Add(Mesh);
+		}
+		PendingReleases.RemoveAtSwap(Index, EAllowShrinking::No);
+	}
+}
+
+void UMeshMergeSubsystem::EnqueueJob(FMeshMergeJob&& Job)
+{
+	// 1. Supersede older request of the same requester, only its newest state matters
+	if (const UObject* Requester = Job.Requester.Get())
+	{
+		const int32 NumSuperseded = QueuedJobs.RemoveAll([Requester](const FMeshMergeJob& QueuedJob)
+		{
+			return QueuedJob.Requester.Get() == Requester;
+		});
+		INC_DWORD_STAT_BY(STAT_MeshMerge_SupersededJobs, NumSuperseded);
+	}
+
+	// 2. Queue is kept sorted by priority, FIFO within the same priority
+	const int32 InsertIndex = QueuedJobs.IndexOfByPredicate([&Job](const FMeshMergeJob& QueuedJob)
+	{
+		return QueuedJob.Priority < Job.Priority;
+	});
+	QueuedJobs.Insert(MoveTemp(Job), InsertIndex != INDEX_NONE ? InsertIndex : QueuedJobs.Num());
+
+	SET_DWORD_STAT(STAT_MeshMerge_QueuedJobs, QueuedJobs.Num());
+}
+
+void UMeshMergeSubsystem::PruneRequestSerials()
+{
+	// Requesters destroyed with a merge still in flight never see it complete
+	for (auto It = LatestRequestSerials.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FOnMeshMergeCompleteDelegate UMeshMergeSubsystem::TagRequest(const UObject* Requester, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete)
+{
+	const uint32 RequestSerial = ++NextRequestSerial;
+	LatestRequestSerials.Add(Requester, RequestSerial);
+
+	return FOnMeshMergeCompleteDelegate::CreateWeakLambda(this, [this, RequesterKey = TObjectKey<UObject>(Requester), RequestSerial, OnMeshMergeComplete = MoveTemp(OnMeshMergeComplete)](USkeletalMesh* MergedMesh)
+	{
+		const uint32* LatestSerial = LatestRequestSerials.Find(RequesterKey);
+		if (!LatestSerial || *LatestSerial != RequestSerial)
+		{
+			INC_DWORD_STAT(STAT_MeshMerge_SupersededJobs);
+			UE_LOG(LogMeshMerge, Verbose, TEXT("UMeshMergeSubsystem::TagRequest - Dropped superseded result %s"), *GetNameSafe(MergedMesh));
+
+			// Nobody else saw the result, it goes back to the pool unless the cache hands it out
+			DiscardMergedMesh(GetWorld(), MergedMesh);
+			return;
+		}
+
+		LatestRequestSerials.Remove(RequesterKey);
+		OnMeshMergeComplete.ExecuteIfBound(MergedMesh);
+	});
+}
+
+void UMeshMergeSubsystem::ProcessQueuedJobs(double BudgetSeconds)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumProcessedJobs = 0;
+
+	while (!QueuedJobs.IsEmpty())
+	{
+		const double JobStartTime = FPlatformTime::Seconds();
+		if (NumProcessedJobs > 0 && JobStartTime - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+
+		// Job is detached before running, completion delegates may queue new jobs
+		FMeshMergeJob Job = MoveTemp(QueuedJobs[0]);
+		QueuedJobs.RemoveAt(0, EAllowShrinking::No);
+
+		// Requester is gone, nobody waits for the result. Tagged delegates stay bound to this subsystem, so the requester itself is checked.
+		if (Job.Requester.IsStale())
+		{
+			continue;
+		}
+
+		SET_FLOAT_STAT(STAT_MeshMerge_JobWaitMs, (JobStartTime - Job.EnqueueTime) * 1000.0);
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MeshMerge_Job);
+			ExecuteMerge(GetWorld(), Job.MeshesToMergeData, MoveTemp(Job.OnMeshMergeComplete), Job.PreviousMergedMesh.Get());
+		}
+		SET_FLOAT_STAT(STAT_MeshMerge_JobCostMs, (FPlatformTime::Seconds() - JobStartTime) * 1000.0);
+
+		++NumProcessedJobs;
+	}
+
+	INC_DWORD_STAT_BY(STAT_MeshMerge_ProcessedJobs, NumProcessedJobs);
+}
+
+bool UMeshMergeSubsystem::ExecuteMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete, const USkeletalMesh* PreviousMergedMesh)
+{
+	if (UMeshMergeCacheSubsystem* MeshMergeCache = GetMeshMergeCache(World))
+	{
+		const FSkeletalMeshArrayKey MergeKey = MeshMergeUtilities::MakeMergeKey(MeshesToMergeData);
+
+		// Same part set may have been merged while this job was queued
+		if (USkeletalMesh* CachedMesh = MeshMergeCache->FindMesh(MergeKey))
+		{
+			OnMeshMergeComplete.ExecuteIfBound(CachedMesh);
+			return true;
+		}
+
+		if (MeshMergeCache->AddPendingRequest(MergeKey, MoveTemp(OnMeshMergeComplete)))
+		{
+			return true;
+		}
+
+		// Cache receives the result first and passes it to every waiter
+		OnMeshMergeComplete = MeshMergeCache->MakeMergeCompleteDelegate(MergeKey);
+	}
+	
 	switch (GetCurrentMergeMethod())
 	{
 	case EMeshMergeMethod::SyncMeshMerge:
-		return SyncMerge(World, MeshesToMergeData, OutMaterialMap, MoveTemp(OnMeshMergeComplete));
-	// case EMeshMergeMethod::AsyncMeshMerge:
-	// 	return false; //AsyncMergeMeshes(World, MeshesToMergeData, OutMaterialMap, MoveTemp(OnMeshMergeComplete));
+		return SyncMerge(World, MeshesToMergeData, MoveTemp(OnMeshMergeComplete), PreviousMergedMesh);
+	case EMeshMergeMethod::AsyncMeshMerge:
+		return AsyncMerge(World, MeshesToMergeData, MoveTemp(OnMeshMergeComplete), PreviousMergedMesh);
 	default:
-		UE_LOG(LogTemp, Warning, TEXT("UMeshMergeSubsystem::MergeMeshesWithSettings: Unknown merge method, falling back to synchronous"));
-		return SyncMerge(World, MeshesToMergeData, OutMaterialMap, MoveTemp(OnMeshMergeComplete));
+		UE_LOG(LogMeshMerge, Warning, TEXT("UMeshMergeSubsystem::MergeMeshesWithSettings: Unknown merge method, falling back to synchronous"));
+		return SyncMerge(World, MeshesToMergeData, MoveTemp(OnMeshMergeComplete), PreviousMergedMesh);
 	}
 }
 
@@ -42,7 +576,7 @@ EMeshMergeMethod UMeshMergeSubsystem::GetCurrentMergeMethod()
 	return Settings ? Settings->GetMeshMergeMethod() : EMeshMergeMethod::SyncMeshMerge;
 }
 
-bool UMeshMergeSubsystem::SyncMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete)
+bool UMeshMergeSubsystem::SyncMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete, const USkeletalMesh* PreviousMergedMesh)
 {
 	if (MeshesToMergeData.IsEmpty())
 	{
@@ -72,36 +606,58 @@ bool UMeshMergeSubsystem::SyncMerge(const UWorld* World, const TArray<FMeshToMer
 		return false;
 	}
 	
-	USkeletalMesh* MergedMesh = NewObject<USkeletalMesh>(GetTransientPackage());
+	// Disk cache hit skips the merge itself, only the mesh is created
+	if (USkeletalMesh* CachedMesh = LoadFromDiskCache(World, MeshesToMergeData))
+	{
+		OnMeshMergeComplete.ExecuteIfBound(CachedMesh);
+		return true;
+	}
+
+	// FSkeletalMeshMerge keeps one section per source section, the whole skeleton and rebuilds every part. Consolidation, atlasing,
+	// bone pruning, skin culling, baked accessories and copying unchanged parts from the previous merge need the native builder.
+	const bool bCullsSkin = MeshesToMergeData.ContainsByPredicate([](const FMeshToMergeData& Data)
+	{
+		return MeshMergeUtilities::GetCulledRegionMask(Data) != 0;
+	});
+	const bool bNeedsNativeKernel = MeshMergeUtilities::ShouldConsolidateMaterials() || MeshMergeUtilities::ShouldAtlasMaterials() || MeshMergeUtilities::ShouldPruneBones()
+		|| bCullsSkin || !MeshMergeUtilities::CollectRigidMeshes(MeshesToMergeData).IsEmpty() || MeshMergeUtilities::CanMergeIncrementally(PreviousMergedMesh);
+	if (bNeedsNativeKernel)
+	{
+		const TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> Plan = FindOrCompileMergePlan(World, MeshesToMergeData);
+		USkeletalMesh* MergedMesh = MeshMergeUtilities::MergeImmediate(MeshesToMergeData, PreviousMergedMesh, AcquirePooledMesh(World), Plan.Get());
+		OnMeshMergeComplete.ExecuteIfBound(MergedMesh);
+		return MergedMesh != nullptr;
+	}
+
+	// Common case goes through the native kernel as well, FSkeletalMeshMerge only takes parts it can't read
+	if (MeshMergeUtilities::ShouldUseNativeMergeKernel() && MeshMergeUtilities::CanMergeNatively(MeshesToMergeData))
+	{
+		const TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> Plan = FindOrCompileMergePlan(World, MeshesToMergeData);
+		if (USkeletalMesh* MergedMesh = MeshMergeUtilities::MergeImmediate(MeshesToMergeData, PreviousMergedMesh, AcquirePooledMesh(World), Plan.Get()))
+		{
+			OnMeshMergeComplete.ExecuteIfBound(MergedMesh);
+			return true;
+		}
+		UE_LOG(LogMeshMerge, Warning, TEXT("UMeshMergeSubsystem::ExecuteSynchronousMerge - Native kernel failed, falling back to FSkeletalMeshMerge"));
+	}
+	
+	// FSkeletalMeshMerge releases and replaces whatever render data the target mesh had
+	USkeletalMesh* MergedMesh = AcquirePooledMesh(World);
+	if (!MergedMesh)
+	{
+		MergedMesh = NewObject<USkeletalMesh>(GetTransientPackage());
+	}
 	if (BaseMesh->GetSkeleton())
 	{
 		MergedMesh->SetSkeleton(BaseMesh->GetSkeleton());
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("UMeshMergeSubsystem::ExecuteSynchronousMerge - BaseMesh has no skeleton."));
+		UE_LOG(LogMeshMerge, Error, TEXT("UMeshMergeSubsystem::ExecuteSynchronousMerge - BaseMesh has no skeleton."));
 		OnMeshMergeComplete.ExecuteIfBound(nullptr);
 		return false;
 	}
 	
-	// Build the Material Index to Slot Tag map if the output map is provided
-	if (OutMaterialMap)
-	{
-		OutMaterialMap->Empty();
-		int32 CurrentMaterialIndex = 0;
-		for (const auto& Data : MeshesToMergeData)
-		{
-			if (Data.SkeletalMesh)
-			{
-				for (int32 i = 0; i < Data.SkeletalMesh->GetMaterials().Num(); ++i)
-				{
-					OutMaterialMap->Add(CurrentMaterialIndex, Data.SlotTag);
-					CurrentMaterialIndex++;
-				}
-			}
-		}
-	}
-	
 	TArray<FSkelMeshMergeSectionMapping> SectionMappings;
 	const int32 StripTopLODs = 0;
     
@@ -109,11 +665,59 @@ bool UMeshMergeSubsystem::SyncMerge(const UWorld* World, const TArray<FMeshToMer
  
 	if (!Merger.DoMerge())
 	{
-		UE_LOG(LogTemp, Error, TEXT("UMeshMergeSubsystem::ExecuteSynchronousMerge - FSkeletalMeshMerge::DoMerge failed."));
+		UE_LOG(LogMeshMerge, Error, TEXT("UMeshMergeSubsystem::ExecuteSynchronousMerge - FSkeletalMeshMerge::DoMerge failed."));
 		OnMeshMergeComplete.ExecuteIfBound(nullptr);
 		return false;
 	}
 	
 	OnMeshMergeComplete.ExecuteIfBound(MergedMesh);
 	return true;
-}
\ No newline at end of file
+}
+
+bool UMeshMergeSubsystem::AsyncMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete, const USkeletalMesh* PreviousMergedMesh)
+{
+	UMeshMergeSubsystem* MeshMergeSubsystem = World ? World->GetSubsystem<UMeshMergeSubsystem>() : nullptr;
+	if (!MeshMergeSubsystem)
+	{
+		UE_LOG(LogMeshMerge, Warning, TEXT("UMeshMergeSubsystem::AsyncMerge - No subsystem for world, falling back to synchronous"));
+		return SyncMerge(World, MeshesToMergeData, MoveTemp(OnMeshMergeComplete), PreviousMergedMesh);
+	}
+
+	const TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> Plan = FindOrCompileMergePlan(World, MeshesToMergeData);
+	UAsyncSkeletalMeshMerge* AsyncMergeTask = NewObject<UAsyncSkeletalMeshMerge>(MeshMergeSubsystem);
+	if (!AsyncMergeTask->Start(MeshesToMergeData, MoveTemp(OnMeshMergeComplete), PreviousMergedMesh, Plan.Get()))
+	{
+		return false;
+	}
+
+	MeshMergeSubsystem->ActiveAsyncMerges.Add(AsyncMergeTask);
+	return true;
+}
+
+USkeletalMesh* UMeshMergeSubsystem::LoadFromDiskCache(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData)
+{
+	const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+	if (!Settings || !Settings->GetEnableMeshMergeDiskCache())
+	{
+		return nullptr;
+	}
+
+	const TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> Plan = FindOrCompileMergePlan(World, MeshesToMergeData);
+	FMeshMergeGatherData GatherData;
+	if (!MeshMergeUtilities::GatherMergeData(MeshesToMergeData, GatherData, nullptr, Plan.Get()))
+	{
+		return nullptr;
+	}
+
+	GatherData.DiskCacheFingerprint = MeshMergeDiskCache::MakeFingerprint(GatherData);
+
+	FMergedMeshBuildData BuildData;
+	if (!MeshMergeDiskCache::Load(GatherData, BuildData))
+	{
+		return nullptr;
+	}
+
+	// Sources are const in gather data, skeleton is taken from the mutable input
+	const FMeshToMergeData* BaseData = MeshesToMergeData.FindByPredicate([](const FMeshToMergeData& Data) { return IsValid(Data.SkeletalMesh); });
+	return MeshMergeUtilities::CreateMergedMesh(GatherData, BuildData, BaseData->SkeletalMesh->GetSkeleton(), AcquirePooledMesh(World));
+}
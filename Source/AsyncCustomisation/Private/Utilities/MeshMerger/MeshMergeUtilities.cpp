@@ -0,0 +1,2050 @@
+#include "Utilities/MeshMerger/MeshMergeUtilities.h"
+
+#include "AnimationRuntime.h"
+#include "Async/ParallelFor.h"
+#include "Algo/StableSort.h"
+#include "Animation/Skeleton.h"
+#include "GPUSkinVertexFactory.h"
+#include "Misc/SecureHash.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Engine/SkinnedAssetCommon.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstance.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "StaticMeshResources.h"
+#include "UObject/ObjectKey.h"
+#include "Utilities/CustomizationSettings.h"
+#include "Utilities/MeshMerger/MergedMeshLayoutUserData.h"
+#include "Utilities/MeshMerger/MeshMergeAtlas.h"
+#include "Utilities/MeshMerger/MeshMergeSourceScratch.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeVertexCache.h"
+#include "Utilities/MeshMerger/SkinCoverageUserData.h"
+
+DEFINE_LOG_CATEGORY(LogMeshMerge);
+
+DECLARE_MEMORY_STAT(TEXT("Memory Optimizer Saved"), STAT_MeshMerge_MemoryOptimizerSavedBytes, STATGROUP_MeshMerge);
+
+namespace MeshMergeUtilities
+{
+	namespace Private
+	{
+		// Adds bones of the source skeleton missing in the merged one. Parents always precede children in raw bone order.
+		void AppendMissingBones(const FReferenceSkeleton& SourceRefSkeleton, FReferenceSkeleton& MergedRefSkeleton, const USkeleton* Skeleton)
+		{
+			FReferenceSkeletonModifier Modifier(MergedRefSkeleton, Skeleton);
+
+			const TArray<FMeshBoneInfo>& SourceBoneInfos = SourceRefSkeleton.GetRawRefBoneInfo();
+			const TArray<FTransform>& SourceBonePose = SourceRefSkeleton.GetRawRefBonePose();
+
+			for (int32 BoneIndex = 0; BoneIndex < SourceBoneInfos.Num(); ++BoneIndex)
+			{
+				const FMeshBoneInfo& SourceBoneInfo = SourceBoneInfos[BoneIndex];
+				if (Modifier.FindBoneIndex(SourceBoneInfo.Name) != INDEX_NONE)
+				{
+					continue;
+				}
+
+				FMeshBoneInfo NewBoneInfo = SourceBoneInfo;
+				NewBoneInfo.ParentIndex = SourceBoneInfo.ParentIndex != INDEX_NONE
+					? Modifier.FindBoneIndex(SourceBoneInfos[SourceBoneInfo.ParentIndex].Name)
+					: INDEX_NONE;
+
+				Modifier.Add(NewBoneInfo, SourceBonePose[BoneIndex]);
+			}
+		}
+
+		// Keeps bones any part needs at its first merged LOD, bones of kept sockets and the parents of both. Lower LODs need a subset.
+		void PruneUnusedBones(FReferenceSkeleton& InOutRefSkeleton, TConstArrayView<const USkeletalMesh*> Meshes, int32 FirstLODIndex, const TArray<FName>& KeptSocketNames,
+			const USkeleton* Skeleton)
+		{
+			const FReferenceSkeleton& FullRefSkeleton = InOutRefSkeleton;
+			TBitArray<> KeptBones(false, FullRefSkeleton.GetRawBoneNum());
+			KeptBones[0] = true;
+
+			auto KeepBone = [&FullRefSkeleton, &KeptBones](int32 BoneIndex)
+			{
+				for (; BoneIndex != INDEX_NONE && !KeptBones[BoneIndex]; BoneIndex = FullRefSkeleton.GetRawParentIndex(BoneIndex))
+				{
+					KeptBones[BoneIndex] = true;
+				}
+			};
+
+			// 1. Bones skinned or required by the parts
+			for (const USkeletalMesh* Mesh : Meshes)
+			{
+				const FReferenceSkeleton& SourceRefSkeleton = Mesh->GetRefSkeleton();
+				const FSkeletalMeshLODRenderData& LODData = Mesh->GetResourceForRendering()->LODRenderData[FirstLODIndex];
+				for (const TArray<FBoneIndexType>* BoneIndices : { &LODData.RequiredBones, &LODData.ActiveBoneIndices })
+				{
+					for (const FBoneIndexType SourceBoneIndex : *BoneIndices)
+					{
+						if (SourceBoneIndex < SourceRefSkeleton.GetRawBoneNum())
+						{
+							KeepBone(FullRefSkeleton.FindRawBoneIndex(SourceRefSkeleton.GetBoneName(SourceBoneIndex)));
+						}
+					}
+				}
+			}
+
+			// 2. Sockets resolve on the base mesh first, then on the skeleton. Attaching to a bone by name works too.
+			const USkeletalMesh* BaseMesh = Meshes[0];
+			for (const FName& SocketName : KeptSocketNames)
+			{
+				const USkeletalMeshSocket* Socket = BaseMesh->FindSocket(SocketName);
+				KeepBone(FullRefSkeleton.FindRawBoneIndex(Socket ? Socket->BoneName : SocketName));
+			}
+
+			// 3. Raw order keeps parents ahead of children
+			const int32 NumFullBones = FullRefSkeleton.GetRawBoneNum();
+			FReferenceSkeleton PrunedRefSkeleton;
+			{
+				FReferenceSkeletonModifier Modifier(PrunedRefSkeleton, Skeleton);
+				const TArray<FMeshBoneInfo>& BoneInfos = FullRefSkeleton.GetRawRefBoneInfo();
+				const TArray<FTransform>& BonePose = FullRefSkeleton.GetRawRefBonePose();
+				for (int32 BoneIndex = 0; BoneIndex < NumFullBones; ++BoneIndex)
+				{
+					if (!KeptBones[BoneIndex])
+					{
+						continue;
+					}
+
+					FMeshBoneInfo BoneInfo = BoneInfos[BoneIndex];
+					BoneInfo.ParentIndex = BoneInfo.ParentIndex != INDEX_NONE ? Modifier.FindBoneIndex(BoneInfos[BoneInfo.ParentIndex].Name) : INDEX_NONE;
+					Modifier.Add(BoneInfo, BonePose[BoneIndex]);
+				}
+			}
+
+			InOutRefSkeleton = MoveTemp(PrunedRefSkeleton);
+			UE_LOG(LogMeshMerge, Verbose, TEXT("MeshMergeUtilities::PruneUnusedBones - Kept %d of %d bones"), InOutRefSkeleton.GetRawBoneNum(), NumFullBones);
+		}
+
+		// Kept sockets of all parts and sockets of baked accessories, which follow their bones just like attached actors
+		TArray<FName> CollectPlanSocketNames(const TArray<FMeshToMergeData>& MeshesToMergeData)
+		{
+			TArray<FName> SocketNames = CollectKeptSocketNames(MeshesToMergeData);
+			for (const FRigidMeshToMergeData& RigidData : CollectRigidMeshes(MeshesToMergeData))
+			{
+				SocketNames.AddUnique(RigidData.SocketName);
+			}
+			return SocketNames;
+		}
+
+		// Source LODs resident for every valid part, false if they have none in common
+		bool GetResidentLODRange(const TArray<FMeshToMergeData>& MeshesToMergeData, int32& OutFirstLODIndex, int32& OutLastLODIndex)
+		{
+			OutFirstLODIndex = 0;
+			OutLastLODIndex = MAX_int32;
+			for (const FMeshToMergeData& Data : MeshesToMergeData)
+			{
+				const FSkeletalMeshRenderData* RenderData = IsValid(Data.SkeletalMesh) ? Data.SkeletalMesh->GetResourceForRendering() : nullptr;
+				if (RenderData)
+				{
+					OutFirstLODIndex = FMath::Max<int32>(OutFirstLODIndex, RenderData->CurrentFirstLODIdx);
+					OutLastLODIndex = FMath::Min(OutLastLODIndex, RenderData->LODRenderData.Num() - 1);
+				}
+			}
+			return OutLastLODIndex != MAX_int32 && OutFirstLODIndex <= OutLastLODIndex;
+		}
+
+		void RemapBoneIndices(const TArray<FBoneIndexType>& SourceIndices, const TArray<FBoneIndexType>& BoneRemap, TArray<FBoneIndexType>& InOutMergedIndices)
+		{
+			for (const FBoneIndexType SourceIndex : SourceIndices)
+			{
+				if (BoneRemap.IsValidIndex(SourceIndex))
+				{
+					InOutMergedIndices.AddUnique(BoneRemap[SourceIndex]);
+				}
+			}
+		}
+
+		struct FSectionGroupMember
+		{
+			int32 SourceIndex = INDEX_NONE;
+			int32 SectionIndex = INDEX_NONE;
+
+			// Source section BoneMap slot -> group BoneMap slot
+			TArray<FBoneIndexType> LocalBoneRemap;
+		};
+
+		// Source sections rendered as one merged section
+		struct FSectionGroup
+		{
+			int32 MaterialIndex = INDEX_NONE;
+			TArray<FBoneIndexType> BoneMap;
+			TArray<FSectionGroupMember, TInlineAllocator<4>> Members;
+		};
+
+		// Geometry of a source section with culled triangles dropped
+		struct FCulledSection
+		{
+			bool bCulled = false;
+
+			// Source LOD vertex indices in order of first use
+			TArray<uint32> Vertices;
+
+			// Into Vertices
+			TArray<uint32> Indices;
+		};
+
+		bool HaveSameSectionFlags(const FSkelMeshRenderSection& A, const FSkelMeshRenderSection& B)
+		{
+			return A.bRecomputeTangent == B.bRecomputeTangent
+				&& A.RecomputeTangentsVertexMaskChannel == B.RecomputeTangentsVertexMaskChannel
+				&& A.bCastShadow == B.bCastShadow
+				&& A.bVisibleInRayTracing == B.bVisibleInRayTracing
+				&& A.bDisabled == B.bDisabled;
+		}
+
+		// Appends section bones missing in the group BoneMap, false if the group would exceed the bone limit
+		bool TryAddToGroup(FSectionGroup& Group, int32 SourceIndex, int32 SectionIndex, const TArray<FBoneIndexType>& MergedBoneMap, int32 MaxBones)
+		{
+			int32 NumNewBones = 0;
+			for (const FBoneIndexType BoneIndex : MergedBoneMap)
+			{
+				NumNewBones += Group.BoneMap.Contains(BoneIndex) ? 0 : 1;
+			}
+			if (!Group.Members.IsEmpty() && Group.BoneMap.Num() + NumNewBones > MaxBones)
+			{
+				return false;
+			}
+
+			FSectionGroupMember& Member = Group.Members.AddDefaulted_GetRef();
+			Member.SourceIndex = SourceIndex;
+			Member.SectionIndex = SectionIndex;
+			Member.LocalBoneRemap.Reserve(MergedBoneMap.Num());
+			for (const FBoneIndexType BoneIndex : MergedBoneMap)
+			{
+				Member.LocalBoneRemap.Add(static_cast<FBoneIndexType>(Group.BoneMap.AddUnique(BoneIndex)));
+			}
+			return true;
+		}
+
+		// Previous layout is only usable when both merges keep sections 1:1, its LODs have to be readable on CPU
+		void GatherPreviousMesh(const USkeletalMesh* PreviousMergedMesh, FMeshMergeGatherData& InOutGatherData)
+		{
+			const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+			const UMergedMeshLayoutUserData* LayoutUserData = UMergedMeshLayoutUserData::Find(PreviousMergedMesh);
+			const FSkeletalMeshRenderData* RenderData = PreviousMergedMesh ? PreviousMergedMesh->GetResourceForRendering() : nullptr;
+			if (!Settings || !Settings->GetEnableIncrementalMeshMerge() || InOutGatherData.bConsolidateSections
+				|| !LayoutUserData || !LayoutUserData->Layout.IsValid() || !RenderData)
+			{
+				return;
+			}
+
+			for (const FSkeletalMeshLODRenderData& LODData : RenderData->LODRenderData)
+			{
+				if (!HasCPUAccess(LODData))
+				{
+					InOutGatherData.PreviousLODs.Reset();
+					return;
+				}
+				InOutGatherData.PreviousLODs.Add(&LODData);
+			}
+			InOutGatherData.PreviousLayout = LayoutUserData->Layout;
+		}
+
+		// UV channels and vertex colors one material reads
+		struct FMaterialStreamUsage
+		{
+			int32 NumTexCoords = 0;
+			bool bReadsVertexColor = false;
+
+			void Append(const FMaterialStreamUsage& Other)
+			{
+				NumTexCoords = FMath::Max(NumTexCoords, Other.NumTexCoords);
+				bReadsVertexColor |= Other.bReadsVertexColor;
+			}
+		};
+
+		// Analysis translates the material once per property, results are kept until the material or its static switches change
+		FMaterialStreamUsage GetMaterialStreamUsage(UMaterialInterface* Material)
+		{
+			check(IsInGameThread());
+
+			FMaterialStreamUsage Usage;
+			Usage.NumTexCoords = MAX_TEXCOORDS;
+			Usage.bReadsVertexColor = true;
+
+#if WITH_EDITOR
+			const UMaterial* BaseMaterial = Material ? Material->GetMaterial() : nullptr;
+			if (!BaseMaterial)
+			{
+				return Usage;
+			}
+
+			struct FCachedUsage
+			{
+				FGuid StateId;
+				FStaticParameterSet StaticParameters;
+				FMaterialStreamUsage Usage;
+			};
+			static TMap<TObjectKey<UMaterialInterface>, FCachedUsage> Cache;
+
+			const UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(Material);
+			const FStaticParameterSet StaticParameters = MaterialInstance ? MaterialInstance->GetStaticParameters() : FStaticParameterSet();
+			if (const FCachedUsage* Cached = Cache.Find(Material))
+			{
+				if (Cached->StateId == BaseMaterial->StateId && Cached->StaticParameters == StaticParameters)
+				{
+					return Cached->Usage;
+				}
+			}
+
+			Usage = FMaterialStreamUsage();
+			for (int32 Property = 0; Property < MP_MAX; ++Property)
+			{
+				if (Property == MP_MaterialAttributes)
+				{
+					continue;
+				}
+
+				int32 NumTexCoords = 0;
+				bool bRequiresVertexData = false;
+				Material->AnalyzeMaterialProperty(static_cast<EMaterialProperty>(Property), NumTexCoords, bRequiresVertexData);
+				Usage.NumTexCoords = FMath::Max(Usage.NumTexCoords, NumTexCoords);
+				Usage.bReadsVertexColor |= bRequiresVertexData;
+			}
+
+			Cache.Add(Material, { BaseMaterial->StateId, StaticParameters, Usage });
+#endif
+			return Usage;
+		}
+
+		// Skins replace part materials after the merge, so the resolved materials decide what the merged mesh reads
+		FMaterialStreamUsage GetPartsStreamUsage(const TArray<FMeshToMergeData>& MeshesToMergeData)
+		{
+			FMaterialStreamUsage StreamUsage;
+			for (const FMeshToMergeData& Data : MeshesToMergeData)
+			{
+				for (int32 MaterialIndex = 0; Data.SkeletalMesh && MaterialIndex < Data.SkeletalMesh->GetMaterials().Num(); ++MaterialIndex)
+				{
+					StreamUsage.Append(GetMaterialStreamUsage(GetResolvedMaterial(Data, MaterialIndex)));
+				}
+			}
+			return StreamUsage;
+		}
+
+		// Buffers of the previous LOD can be copied byte for byte only when their formats match
+		uint32 GetUVAndColorStride(uint32 NumTexCoords, bool bUseFullPrecisionUVs, bool bHasVertexColors)
+		{
+			return static_cast<uint32>(NumTexCoords * (bUseFullPrecisionUVs ? sizeof(FVector2f) : sizeof(FVector2DHalf)) + (bHasVertexColors ? sizeof(FColor) : 0));
+		}
+
+		// Every merged UV of the kept channels survives a round trip through half precision within the gather error bound
+		bool FitHalfPrecisionUVs(const FMeshMergeGatherData& GatherData, int32 LODIndex, uint32 NumTexCoords)
+		{
+			auto FitsVertices = [&GatherData, NumTexCoords](const FStaticMeshVertexBuffer& VertexBuffer, uint32 FirstVertex, uint32 NumVertices, const FMeshMergeAtlasEntry* AtlasEntry)
+			{
+				// Half precision sources round trip exactly unless the atlas moves them
+				if (!VertexBuffer.GetUseFullPrecisionUVs() && !AtlasEntry)
+				{
+					return true;
+				}
+
+				const uint32 NumChannels = FMath::Min(NumTexCoords, VertexBuffer.GetNumTexCoords());
+				for (uint32 VertexIndex = FirstVertex; VertexIndex < FirstVertex + NumVertices; ++VertexIndex)
+				{
+					for (uint32 UVIndex = 0; UVIndex < NumChannels; ++UVIndex)
+					{
+						FVector2f UV = VertexBuffer.GetVertexUV(VertexIndex, UVIndex);
+						if (UVIndex == 0 && AtlasEntry)
+						{
+							UV = AtlasEntry->RemapUV(UV);
+						}
+						if (!UV.Equals(FVector2f(FVector2DHalf(UV)), GatherData.MaxHalfUVError))
+						{
+							return false;
+						}
+					}
+				}
+				return true;
+			};
+
+			// Atlas remap scales UVs into a tile away from 0, the remapped values are what gets halved
+			for (const FMeshMergeSource& Source : GatherData.Sources)
+			{
+				const FSkeletalMeshLODRenderData& LODData = *Source.LODs[LODIndex];
+				for (int32 SectionIndex = 0; SectionIndex < LODData.RenderSections.Num(); ++SectionIndex)
+				{
+					const FSkelMeshRenderSection& Section = LODData.RenderSections[SectionIndex];
+					const int32 AtlasEntryIndex = Source.SectionAtlasEntries[LODIndex][SectionIndex];
+					const FMeshMergeAtlasEntry* AtlasEntry = AtlasEntryIndex != INDEX_NONE ? &GatherData.AtlasPlan.Entries[AtlasEntryIndex] : nullptr;
+					if (!FitsVertices(LODData.StaticVertexBuffers.StaticMeshVertexBuffer, Section.BaseVertexIndex, Section.NumVertices, AtlasEntry))
+					{
+						return false;
+					}
+				}
+			}
+
+			for (const FMeshMergeRigidSource& RigidSource : GatherData.RigidSources)
+			{
+				const FStaticMeshVertexBuffer& VertexBuffer = RigidSource.LODs[LODIndex]->VertexBuffers.StaticMeshVertexBuffer;
+				if (!FitsVertices(VertexBuffer, 0, VertexBuffer.GetNumVertices(), nullptr))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool HasSameVertexFormat(const FSkeletalMeshLODRenderData& PreviousLOD, uint32 NumTexCoords, bool bUseFullPrecisionUVs, bool bUseHighPrecisionTangents, bool bHasVertexColors)
+		{
+			const FStaticMeshVertexBuffer& MeshVertexBuffer = PreviousLOD.StaticVertexBuffers.StaticMeshVertexBuffer;
+			return MeshVertexBuffer.GetNumTexCoords() == NumTexCoords
+				&& MeshVertexBuffer.GetUseFullPrecisionUVs() == bUseFullPrecisionUVs
+				&& MeshVertexBuffer.GetUseHighPrecisionTangentBasis() == bUseHighPrecisionTangents
+				&& (PreviousLOD.StaticVertexBuffers.ColorVertexBuffer.GetNumVertices() > 0) == bHasVertexColors;
+		}
+
+		// Range of the source in the previous merged LOD, nullptr if the part is new or its source LOD differs.
+		// SourceSize is the geometry the source adds to this merge, after culling.
+		const FMergedPartRange* FindPreviousRange(const FMeshMergeGatherData& GatherData, int32 LODIndex, int32 SourceIndex, const FMergedPartRange& SourceSize, TBitArray<>& InOutUsedParts)
+		{
+			const FMergedMeshLayout& Layout = *GatherData.PreviousLayout;
+			const int32 PreviousLODIndex = GatherData.FirstLODIndex + LODIndex - Layout.FirstLODIndex;
+			if (!GatherData.PreviousLODs.IsValidIndex(PreviousLODIndex))
+			{
+				return nullptr;
+			}
+
+			// Same mesh object may carry other geometry after a reimport in editor
+			const FMeshMergeSource& Source = GatherData.Sources[SourceIndex];
+			for (int32 PartIndex = 0; PartIndex < Layout.Parts.Num(); ++PartIndex)
+			{
+				const FMergedMeshLayout::FPart& Part = Layout.Parts[PartIndex];
+				if (!InOutUsedParts[PartIndex] && Part.Mesh.Get() == Source.Mesh && Part.CulledRegionMask == Source.CulledRegionMask && Part.LODs.IsValidIndex(PreviousLODIndex)
+					&& Part.LODs[PreviousLODIndex].NumVertices == SourceSize.NumVertices && Part.LODs[PreviousLODIndex].NumIndices == SourceSize.NumIndices)
+				{
+					InOutUsedParts[PartIndex] = true;
+					return &Part.LODs[PreviousLODIndex];
+				}
+			}
+			return nullptr;
+		}
+
+		// Tangent and UV streams can be copied as raw memory only when their layouts match
+		bool HasSameStreamFormat(const FStaticMeshVertexBuffer& Source, const FStaticMeshVertexBuffer& Target)
+		{
+			return Source.GetNumTexCoords() == Target.GetNumTexCoords()
+				&& Source.GetUseFullPrecisionUVs() == Target.GetUseFullPrecisionUVs()
+				&& Source.GetUseHighPrecisionTangentBasis() == Target.GetUseHighPrecisionTangentBasis();
+		}
+
+		// Every vertex stream of the range is copied in one go, strides follow from the matching formats.
+		// Target colors of a source without them are white.
+		void CopyVertexStreams(const FStaticMeshVertexBuffers& Source, uint32 FirstVertex, uint32 NumVertices, FStaticMeshVertexBuffers& Target, uint32 VertexOffset)
+		{
+			const uint32 PositionStride = Source.PositionVertexBuffer.GetStride();
+			FMemory::Memcpy(static_cast<uint8*>(Target.PositionVertexBuffer.GetVertexData()) + PositionStride * VertexOffset,
+				static_cast<const uint8*>(Source.PositionVertexBuffer.GetVertexData()) + PositionStride * FirstVertex, PositionStride * NumVertices);
+
+			const uint32 TangentStride = Source.StaticMeshVertexBuffer.GetTangentSize() / Source.StaticMeshVertexBuffer.GetNumVertices();
+			FMemory::Memcpy(static_cast<uint8*>(Target.StaticMeshVertexBuffer.GetTangentData()) + TangentStride * VertexOffset,
+				static_cast<const uint8*>(Source.StaticMeshVertexBuffer.GetTangentData()) + TangentStride * FirstVertex, TangentStride * NumVertices);
+
+			const uint32 TexCoordStride = Source.StaticMeshVertexBuffer.GetTexCoordSize() / Source.StaticMeshVertexBuffer.GetNumVertices();
+			FMemory::Memcpy(static_cast<uint8*>(Target.StaticMeshVertexBuffer.GetTexCoordData()) + TexCoordStride * VertexOffset,
+				static_cast<const uint8*>(Source.StaticMeshVertexBuffer.GetTexCoordData()) + TexCoordStride * FirstVertex, TexCoordStride * NumVertices);
+
+			if (Target.ColorVertexBuffer.GetNumVertices() == 0)
+			{
+				return;
+			}
+
+			if (Source.ColorVertexBuffer.GetNumVertices() == Source.PositionVertexBuffer.GetNumVertices())
+			{
+				const uint32 ColorStride = Source.ColorVertexBuffer.GetStride();
+				FMemory::Memcpy(static_cast<uint8*>(Target.ColorVertexBuffer.GetVertexData()) + ColorStride * VertexOffset,
+					static_cast<const uint8*>(Source.ColorVertexBuffer.GetVertexData()) + ColorStride * FirstVertex, ColorStride * NumVertices);
+			}
+			else
+			{
+				for (uint32 VertexIndex = VertexOffset; VertexIndex < VertexOffset + NumVertices; ++VertexIndex)
+				{
+					Target.ColorVertexBuffer.VertexColor(VertexIndex) = FColor::White;
+				}
+			}
+		}
+
+		// Moves influences from section local BoneMap slots to group BoneMap slots. Slots outside the section BoneMap
+		// are left as is, influences past the source count are cleared.
+		FORCEINLINE void RemapInfluences(FSkinWeightInfo& InOutSkinWeight, const TArray<FBoneIndexType>& LocalBoneRemap, uint32 SourceMaxBoneInfluences)
+		{
+			const uint32 NumInfluences = FMath::Min<uint32>(SourceMaxBoneInfluences, MAX_TOTAL_INFLUENCES);
+			const int32 NumSlots = LocalBoneRemap.Num();
+			for (uint32 InfluenceIndex = 0; InfluenceIndex < NumInfluences; ++InfluenceIndex)
+			{
+				FBoneIndexType& BoneSlot = InOutSkinWeight.InfluenceBones[InfluenceIndex];
+				BoneSlot = BoneSlot < NumSlots ? LocalBoneRemap.GetData()[BoneSlot] : BoneSlot;
+			}
+			for (uint32 InfluenceIndex = NumInfluences; InfluenceIndex < MAX_TOTAL_INFLUENCES; ++InfluenceIndex)
+			{
+				InOutSkinWeight.InfluenceBones[InfluenceIndex] = 0;
+				InOutSkinWeight.InfluenceWeights[InfluenceIndex] = 0;
+			}
+		}
+
+		// Adds the offset to every index, four at a time
+		void RebaseIndices(const uint32* SourceIndices, uint32 NumIndices, int32 Offset, uint32* OutIndices)
+		{
+			const VectorRegister4Int OffsetVector = VectorIntSet1(Offset);
+			uint32 Index = 0;
+			for (; Index + 4 <= NumIndices; Index += 4)
+			{
+				VectorIntStore(VectorIntAdd(VectorIntLoad(SourceIndices + Index), OffsetVector), OutIndices + Index);
+			}
+			for (; Index < NumIndices; ++Index)
+			{
+				OutIndices[Index] = static_cast<uint32>(static_cast<int32>(SourceIndices[Index]) + Offset);
+			}
+		}
+
+		void CopyPreviousRange(const FSkeletalMeshLODRenderData& PreviousLOD, const FMergedPartRange& PreviousRange, uint32 VertexOffset,
+			FSkeletalMeshLODRenderData& OutLODData, TArray<FSkinWeightInfo>& InOutSkinWeights, TArray<uint32>& InOutIndices)
+		{
+			const uint32 NumVertices = PreviousRange.NumVertices;
+			CopyVertexStreams(PreviousLOD.StaticVertexBuffers, PreviousRange.FirstVertex, NumVertices, OutLODData.StaticVertexBuffers, VertexOffset);
+
+			// Sections were 1:1 in the previous merge too, skin weights already reference the same BoneMap slots
+			for (uint32 VertexIndex = PreviousRange.FirstVertex; VertexIndex < PreviousRange.FirstVertex + NumVertices; ++VertexIndex)
+			{
+				InOutSkinWeights.Add(PreviousLOD.SkinWeightVertexBuffer.GetVertexSkinWeights(VertexIndex));
+			}
+
+			const FRawStaticIndexBuffer16or32Interface* PreviousIndexBuffer = PreviousLOD.MultiSizeIndexContainer.GetIndexBuffer();
+			for (uint32 Index = PreviousRange.FirstIndex; Index < PreviousRange.FirstIndex + PreviousRange.NumIndices; ++Index)
+			{
+				InOutIndices.Add(PreviousIndexBuffer->Get(Index) - PreviousRange.FirstVertex + VertexOffset);
+			}
+		}
+
+		// Part ranges are read back from the merged sections, which follow source sections 1:1 in source order.
+		// Culled parts are smaller than their source, the same for built and disk cached LODs.
+		TSharedPtr<const FMergedMeshLayout, ESPMode::ThreadSafe> MakeMergedMeshLayout(const FMeshMergeGatherData& GatherData, const FSkeletalMeshRenderData& RenderData)
+		{
+			TSharedPtr<FMergedMeshLayout, ESPMode::ThreadSafe> Layout = MakeShared<FMergedMeshLayout, ESPMode::ThreadSafe>();
+			Layout->FirstLODIndex = GatherData.FirstLODIndex;
+
+			TArray<FMergedPartRange, TInlineAllocator<8>> LODOffsets;
+			TArray<int32, TInlineAllocator<8>> LODSectionOffsets;
+			LODOffsets.SetNum(GatherData.NumLODs);
+			LODSectionOffsets.SetNumZeroed(GatherData.NumLODs);
+			for (const FMeshMergeSource& Source : GatherData.Sources)
+			{
+				FMergedMeshLayout::FPart& Part = Layout->Parts.AddDefaulted_GetRef();
+				Part.Mesh = Source.Mesh;
+				Part.SlotTag = Source.SlotTag;
+				Part.CulledRegionMask = Source.CulledRegionMask;
+				for (int32 LODIndex = 0; LODIndex < GatherData.NumLODs; ++LODIndex)
+				{
+					const TArray<FSkelMeshRenderSection>& MergedSections = RenderData.LODRenderData[LODIndex].RenderSections;
+					const int32 NumSections = Source.LODs[LODIndex]->RenderSections.Num();
+
+					FMergedPartRange& Range = Part.LODs.AddDefaulted_GetRef();
+					Range.FirstVertex = LODOffsets[LODIndex].NumVertices;
+					Range.FirstIndex = LODOffsets[LODIndex].NumIndices;
+					for (int32 SectionIndex = LODSectionOffsets[LODIndex]; SectionIndex < LODSectionOffsets[LODIndex] + NumSections; ++SectionIndex)
+					{
+						Range.NumVertices += MergedSections[SectionIndex].NumVertices;
+						Range.NumIndices += MergedSections[SectionIndex].NumTriangles * 3;
+					}
+					LODOffsets[LODIndex].NumVertices += Range.NumVertices;
+					LODOffsets[LODIndex].NumIndices += Range.NumIndices;
+					LODSectionOffsets[LODIndex] += NumSections;
+				}
+			}
+			return Layout;
+		}
+
+		// Section triangles left once the culled ranges of this section are dropped
+		void CullSection(const FSkelMeshRenderSection& Section, const TArray<uint32>& SourceIndices, int32 LODIndex, int32 SectionIndex,
+			const TArray<FMeshMergeCulledRange>& CulledRanges, FCulledSection& OutCulledSection)
+		{
+			TBitArray<> KeptTriangles(true, Section.NumTriangles);
+			for (const FMeshMergeCulledRange& Range : CulledRanges)
+			{
+				if (Range.LODIndex != LODIndex || Range.SectionIndex != SectionIndex)
+				{
+					continue;
+				}
+
+				OutCulledSection.bCulled = true;
+				const int32 LastTriangle = FMath::Min<int32>(Range.FirstTriangle + Range.NumTriangles, Section.NumTriangles);
+				for (int32 TriangleIndex = FMath::Max(Range.FirstTriangle, 0); TriangleIndex < LastTriangle; ++TriangleIndex)
+				{
+					KeptTriangles[TriangleIndex] = false;
+				}
+			}
+
+			if (!OutCulledSection.bCulled)
+			{
+				return;
+			}
+
+			// Vertices only referenced by dropped triangles go too, the rest are renumbered by first use
+			TArray<int32> LocalVertexRemap;
+			LocalVertexRemap.Init(INDEX_NONE, Section.NumVertices);
+			for (TConstSetBitIterator<> It(KeptTriangles); It; ++It)
+			{
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const uint32 VertexIndex = SourceIndices[Section.BaseIndex + It.GetIndex() * 3 + Corner];
+					int32& LocalVertexIndex = LocalVertexRemap[VertexIndex - Section.BaseVertexIndex];
+					if (LocalVertexIndex == INDEX_NONE)
+					{
+						LocalVertexIndex = OutCulledSection.Vertices.Add(VertexIndex);
+					}
+					OutCulledSection.Indices.Add(static_cast<uint32>(LocalVertexIndex));
+				}
+			}
+		}
+
+		// Skipped with a warning when the mesh can't be read or its socket bone is missing, the accessory is then not shown
+		void GatherRigidSource(const FRigidMeshToMergeData& RigidData, const USkeletalMesh* BaseMesh, FMeshMergeGatherData& InOutGatherData)
+		{
+			const UStaticMesh* StaticMesh = RigidData.StaticMesh;
+			const FStaticMeshRenderData* RenderData = StaticMesh ? StaticMesh->GetRenderData() : nullptr;
+			if (!RenderData || RenderData->LODResources.IsEmpty() || !StaticMesh->bAllowCPUAccess)
+			{
+				UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergeUtilities::GatherMergeData - Rigid mesh %s has no CPU accessible render data, enable 'Allow CPU Access' on the mesh"),
+					*GetNameSafe(StaticMesh));
+				return;
+			}
+
+			// Socket of the base mesh or its skeleton, a bone name works as well
+			FName BoneName = RigidData.SocketName;
+			FTransform SocketTransform = FTransform::Identity;
+			if (const USkeletalMeshSocket* Socket = BaseMesh->FindSocket(RigidData.SocketName))
+			{
+				BoneName = Socket->BoneName;
+				SocketTransform = Socket->GetSocketLocalTransform();
+			}
+
+			const int32 BoneIndex = InOutGatherData.RefSkeleton.FindRawBoneIndex(BoneName);
+			if (BoneIndex == INDEX_NONE)
+			{
+				UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergeUtilities::GatherMergeData - Rigid mesh %s socket %s has no bone in the merged skeleton"),
+					*GetNameSafe(StaticMesh), *RigidData.SocketName.ToString());
+				return;
+			}
+
+			// Static LODs don't line up with skeletal ones, merged LOD index picks the closest resident one
+			FMeshMergeRigidSource RigidSource;
+			RigidSource.Mesh = StaticMesh;
+			RigidSource.BoneIndex = static_cast<FBoneIndexType>(BoneIndex);
+			for (int32 LODIndex = 0; LODIndex < InOutGatherData.NumLODs; ++LODIndex)
+			{
+				const int32 StaticLODIndex = FMath::Clamp<int32>(InOutGatherData.FirstLODIndex + LODIndex, RenderData->CurrentFirstLODIdx, RenderData->LODResources.Num() - 1);
+				const FStaticMeshLODResources& LODResources = RenderData->LODResources[StaticLODIndex];
+				if (!LODResources.VertexBuffers.PositionVertexBuffer.GetAllowCPUAccess() || !LODResources.VertexBuffers.StaticMeshVertexBuffer.GetAllowCPUAccess())
+				{
+					UE_LOG(LogMeshMerge, Warning, TEXT("MeshMergeUtilities::GatherMergeData - Rigid mesh %s LOD %d has no CPU access"), *GetNameSafe(StaticMesh), StaticLODIndex);
+					return;
+				}
+				RigidSource.LODs.Add(&LODResources);
+			}
+
+			const FTransform MeshToComponent = RigidData.RelativeTransform * SocketTransform
+				* FAnimationRuntime::GetComponentSpaceTransformRefPose(InOutGatherData.RefSkeleton, BoneIndex);
+			RigidSource.MeshToComponent = FMatrix44f(MeshToComponent.ToMatrixWithScale());
+
+			// Accessory materials are never shared with part materials, skins don't apply to them
+			const TArray<FStaticMaterial>& StaticMaterials = StaticMesh->GetStaticMaterials();
+			for (int32 MaterialIndex = 0; MaterialIndex < FMath::Max(StaticMaterials.Num(), 1); ++MaterialIndex)
+			{
+				UMaterialInterface* Material = StaticMaterials.IsValidIndex(MaterialIndex) ? StaticMaterials[MaterialIndex].MaterialInterface.Get() : nullptr;
+				RigidSource.MaterialRemap.Add(InOutGatherData.Materials.Add(FSkeletalMaterial(Material)));
+			}
+
+			InOutGatherData.Bounds = InOutGatherData.Bounds + StaticMesh->GetBounds().TransformBy(MeshToComponent);
+			InOutGatherData.RigidSources.Add(MoveTemp(RigidSource));
+		}
+
+		// Whole static LOD is copied once, every static section becomes a merged section skinned to the one bone
+		void CopyRigidSource(const FMeshMergeRigidSource& RigidSource, int32 LODIndex, uint32 NumTexCoords, bool bHasVertexColors, uint32 VertexOffset, uint32 IndexOffset,
+			FSkeletalMeshLODRenderData& OutLODData, TArray<FSkinWeightInfo>& InOutSkinWeights, TArray<uint32>& InOutIndices)
+		{
+			const FStaticMeshLODResources& LODResources = *RigidSource.LODs[LODIndex];
+			const FStaticMeshVertexBuffers& Source = LODResources.VertexBuffers;
+			FStaticMeshVertexBuffers& Target = OutLODData.StaticVertexBuffers;
+			const uint32 NumVertices = Source.PositionVertexBuffer.GetNumVertices();
+			const uint32 SourceNumTexCoords = Source.StaticMeshVertexBuffer.GetNumTexCoords();
+			const bool bSourceHasColors = Source.ColorVertexBuffer.GetNumVertices() == NumVertices;
+
+			// Normals go through the inverse transpose so non-uniform scale keeps them perpendicular, mirroring flips the winding
+			const FMatrix44f& MeshToComponent = RigidSource.MeshToComponent;
+			const FMatrix44f NormalMatrix = MeshToComponent.Inverse().GetTransposed();
+			const bool bFlipWinding = MeshToComponent.Determinant() < 0.f;
+
+			FSkinWeightInfo RigidSkinWeight;
+			FMemory::Memzero(RigidSkinWeight);
+			RigidSkinWeight.InfluenceWeights[0] = MAX_uint16;
+
+			for (uint32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+			{
+				const uint32 MergedVertexIndex = VertexOffset + VertexIndex;
+
+				Target.PositionVertexBuffer.VertexPosition(MergedVertexIndex) = MeshToComponent.TransformPosition(Source.PositionVertexBuffer.VertexPosition(VertexIndex));
+
+				Target.StaticMeshVertexBuffer.SetVertexTangents(MergedVertexIndex,
+					MeshToComponent.TransformVector(FVector3f(Source.StaticMeshVertexBuffer.VertexTangentX(VertexIndex))).GetSafeNormal(),
+					MeshToComponent.TransformVector(Source.StaticMeshVertexBuffer.VertexTangentY(VertexIndex)).GetSafeNormal(),
+					NormalMatrix.TransformVector(FVector3f(Source.StaticMeshVertexBuffer.VertexTangentZ(VertexIndex))).GetSafeNormal());
+
+				for (uint32 UVIndex = 0; UVIndex < NumTexCoords; ++UVIndex)
+				{
+					Target.StaticMeshVertexBuffer.SetVertexUV(MergedVertexIndex, UVIndex,
+						UVIndex < SourceNumTexCoords ? Source.StaticMeshVertexBuffer.GetVertexUV(VertexIndex, UVIndex) : FVector2f::ZeroVector);
+				}
+
+				if (bHasVertexColors)
+				{
+					Target.ColorVertexBuffer.VertexColor(MergedVertexIndex) = bSourceHasColors ? Source.ColorVertexBuffer.VertexColor(VertexIndex) : FColor::White;
+				}
+
+				InOutSkinWeights.Add(RigidSkinWeight);
+			}
+
+			TArray<uint32> SourceIndices;
+			LODResources.IndexBuffer.GetCopy(SourceIndices);
+			for (const FStaticMeshSection& StaticSection : LODResources.Sections)
+			{
+				if (StaticSection.NumTriangles == 0)
+				{
+					continue;
+				}
+
+				const int32 MaterialIndex = RigidSource.MaterialRemap.IsValidIndex(StaticSection.MaterialIndex) ? StaticSection.MaterialIndex : 0;
+
+				FSkelMeshRenderSection& MergedSection = OutLODData.RenderSections.AddDefaulted_GetRef();
+				MergedSection.MaterialIndex = static_cast<uint16>(RigidSource.MaterialRemap[MaterialIndex]);
+				MergedSection.BaseIndex = IndexOffset;
+				MergedSection.NumTriangles = StaticSection.NumTriangles;
+				MergedSection.BaseVertexIndex = VertexOffset + StaticSection.MinVertexIndex;
+				MergedSection.NumVertices = StaticSection.MaxVertexIndex - StaticSection.MinVertexIndex + 1;
+				MergedSection.MaxBoneInfluences = 1;
+				MergedSection.bCastShadow = StaticSection.bCastShadow;
+				MergedSection.bVisibleInRayTracing = StaticSection.bVisibleInRayTracing;
+				MergedSection.BoneMap.Add(RigidSource.BoneIndex);
+				MergedSection.DuplicatedVerticesBuffer.Init(1, TMap<int, TArray<int32>>());
+
+				for (uint32 Index = StaticSection.FirstIndex; Index < StaticSection.FirstIndex + StaticSection.NumTriangles * 3; Index += 3)
+				{
+					InOutIndices.Add(VertexOffset + SourceIndices[Index]);
+					InOutIndices.Add(VertexOffset + SourceIndices[Index + (bFlipWinding ? 2 : 1)]);
+					InOutIndices.Add(VertexOffset + SourceIndices[Index + (bFlipWinding ? 1 : 2)]);
+				}
+				IndexOffset += StaticSection.NumTriangles * 3;
+			}
+		}
+
+		uint32 GetRigidNumIndices(const FStaticMeshLODResources& LODResources)
+		{
+			uint32 NumIndices = 0;
+			for (const FStaticMeshSection& StaticSection : LODResources.Sections)
+			{
+				NumIndices += StaticSection.NumTriangles * 3;
+			}
+			return NumIndices;
+		}
+
+		// Without consolidation every source section is a group of its own, in source order
+		void BuildSectionGroups(const FMeshMergeGatherData& GatherData, int32 LODIndex, TArray<FSectionGroup>& OutGroups)
+		{
+			TArray<FBoneIndexType> MergedBoneMap;
+			for (int32 SourceIndex = 0; SourceIndex < GatherData.Sources.Num(); ++SourceIndex)
+			{
+				const FMeshMergeSource& Source = GatherData.Sources[SourceIndex];
+				const TArray<FSkelMeshRenderSection>& Sections = Source.LODs[LODIndex]->RenderSections;
+				for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+				{
+					const FSkelMeshRenderSection& Section = Sections[SectionIndex];
+					const int32 MaterialIndex = Source.SectionMaterials[LODIndex][SectionIndex];
+
+					MergedBoneMap.Reset(Section.BoneMap.Num());
+					for (const FBoneIndexType SourceBoneIndex : Section.BoneMap)
+					{
+						MergedBoneMap.Add(Source.BoneRemap[SourceBoneIndex]);
+					}
+
+					bool bAdded = false;
+					for (int32 GroupIndex = 0; GroupIndex < OutGroups.Num() && GatherData.bConsolidateSections && !bAdded; ++GroupIndex)
+					{
+						FSectionGroup& Group = OutGroups[GroupIndex];
+						const FSectionGroupMember& First = Group.Members[0];
+						const FSkelMeshRenderSection& FirstSection = GatherData.Sources[First.SourceIndex].LODs[LODIndex]->RenderSections[First.SectionIndex];
+						bAdded = Group.MaterialIndex == MaterialIndex
+							&& HaveSameSectionFlags(FirstSection, Section)
+							&& TryAddToGroup(Group, SourceIndex, SectionIndex, MergedBoneMap, GatherData.MaxBonesPerSection);
+					}
+
+					if (!bAdded)
+					{
+						FSectionGroup& Group = OutGroups.AddDefaulted_GetRef();
+						Group.MaterialIndex = MaterialIndex;
+						TryAddToGroup(Group, SourceIndex, SectionIndex, MergedBoneMap, GatherData.MaxBonesPerSection);
+					}
+				}
+			}
+		}
+
+		// Compiles OutPlan, logs why the sources can't merge otherwise
+		bool CompileMergePlan(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergePlan& OutPlan);
+	}
+
+	bool HasCPUAccess(const FSkeletalMeshLODRenderData& LODData)
+	{
+		return LODData.StaticVertexBuffers.PositionVertexBuffer.GetAllowCPUAccess()
+			&& LODData.StaticVertexBuffers.StaticMeshVertexBuffer.GetAllowCPUAccess()
+			&& LODData.SkinWeightVertexBuffer.GetNeedsCPUAccess();
+	}
+
+	bool CanMergeNatively(const TArray<FMeshToMergeData>& MeshesToMergeData)
+	{
+		const USkeleton* Skeleton = nullptr;
+		TOptional<bool> bUse16BitBoneWeight;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			const USkeletalMesh* Mesh = Data.SkeletalMesh;
+			if (!IsValid(Mesh))
+			{
+				continue;
+			}
+
+			const FSkeletalMeshRenderData* RenderData = Mesh->GetResourceForRendering();
+			if (!RenderData || !Mesh->GetSkeleton() || (Skeleton && Mesh->GetSkeleton() != Skeleton))
+			{
+				return false;
+			}
+			Skeleton = Mesh->GetSkeleton();
+
+			for (int32 LODIndex = RenderData->CurrentFirstLODIdx; LODIndex < RenderData->LODRenderData.Num(); ++LODIndex)
+			{
+				const FSkeletalMeshLODRenderData& LODData = RenderData->LODRenderData[LODIndex];
+				if ((!HasCPUAccess(LODData) && !MeshMergeSourceScratch::IsEnabled()) || LODData.SkinWeightVertexBuffer.Use16BitBoneWeight() != bUse16BitBoneWeight.Get(LODData.SkinWeightVertexBuffer.Use16BitBoneWeight()))
+				{
+					return false;
+				}
+				bUse16BitBoneWeight = LODData.SkinWeightVertexBuffer.Use16BitBoneWeight();
+			}
+		}
+		return Skeleton != nullptr;
+	}
+
+	bool ShouldUseNativeMergeKernel()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetUseNativeMergeKernel();
+	}
+
+	void NormalizeMergeOrder(TArray<FMeshToMergeData>& InOutMeshesToMergeData)
+	{
+		if (InOutMeshesToMergeData.Num() < 3)
+		{
+			return;
+		}
+
+		TArrayView<FMeshToMergeData> Parts = MakeArrayView(InOutMeshesToMergeData).RightChop(1);
+		Algo::StableSort(Parts, [](const FMeshToMergeData& A, const FMeshToMergeData& B)
+		{
+			if (A.SkeletalMesh != B.SkeletalMesh)
+			{
+				return GetPathNameSafe(A.SkeletalMesh) < GetPathNameSafe(B.SkeletalMesh);
+			}
+			return A.SlotTag.GetTagName().LexicalLess(B.SlotTag.GetTagName());
+		});
+	}
+
+	FSkeletalMeshArrayKey MakeMergeKey(const TArray<FMeshToMergeData>& MeshesToMergeData)
+	{
+		TArray<USkeletalMesh*> Meshes;
+		Meshes.Reserve(MeshesToMergeData.Num());
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			if (Data.SkeletalMesh)
+			{
+				Meshes.Add(Data.SkeletalMesh);
+			}
+		}
+
+		// Without consolidation material layout follows from the meshes alone
+		TArray<int32> FlatMaterialRemap;
+		TArray<UMaterialInterface*> AtlasMaterials;
+		if (ShouldConsolidateMaterials() || ShouldAtlasMaterials())
+		{
+			FMeshMergeAtlasPlan AtlasPlan;
+			MeshMergeAtlas::PlanAtlas(MeshesToMergeData, AtlasPlan);
+
+			TArray<TArray<int32>> MaterialRemap;
+			BuildMaterialRemap(MeshesToMergeData, MaterialRemap, nullptr, &AtlasPlan);
+			for (const TArray<int32>& SourceRemap : MaterialRemap)
+			{
+				FlatMaterialRemap.Append(SourceRemap);
+			}
+
+			// Atlas texels are baked from the resolved materials
+			for (const FMeshMergeAtlasEntry& Entry : AtlasPlan.Entries)
+			{
+				AtlasMaterials.Add(Entry.Material);
+			}
+		}
+
+		// Without pruning every merge keeps the whole skeleton
+		TArray<FName> KeptSocketNames;
+		if (ShouldPruneBones())
+		{
+			KeptSocketNames = CollectKeptSocketNames(MeshesToMergeData);
+		}
+
+		// Culled skin is other geometry than the full one
+		TArray<int32> CulledRegionMasks;
+		if (ShouldCullCoveredSkin())
+		{
+			for (const FMeshToMergeData& Data : MeshesToMergeData)
+			{
+				if (Data.SkeletalMesh)
+				{
+					CulledRegionMasks.Add(GetCulledRegionMask(Data));
+				}
+			}
+		}
+
+		FSkeletalMeshArrayKey MergeKey(MoveTemp(Meshes), MoveTemp(FlatMaterialRemap), MoveTemp(KeptSocketNames), MoveTemp(AtlasMaterials), MoveTemp(CulledRegionMasks),
+			CollectRigidMeshes(MeshesToMergeData));
+
+		// Memory optimizer strips streams by the resolved materials, same derivation as GatherMergeData
+		if (ShouldOptimizeMeshMemory())
+		{
+			const Private::FMaterialStreamUsage StreamUsage = Private::GetPartsStreamUsage(MeshesToMergeData);
+			MergeKey.MaxTexCoords = static_cast<uint32>(FMath::Max(StreamUsage.NumTexCoords, 1));
+			MergeKey.bStripVertexColors = !StreamUsage.bReadsVertexColor;
+		}
+		return MergeKey;
+	}
+
+	FString MakePrebakeKey(const FSkeletalMeshArrayKey& MergeKey)
+	{
+		FSHA1 Hash;
+		auto UpdateString = [&Hash](const FString& Value)
+		{
+			Hash.UpdateWithString(*Value, Value.Len());
+		};
+
+		for (const USkeletalMesh* Mesh : MergeKey.MeshArray)
+		{
+			UpdateString(GetPathNameSafe(Mesh));
+		}
+		for (const int32 MaterialIndex : MergeKey.MaterialRemap)
+		{
+			Hash.Update(reinterpret_cast<const uint8*>(&MaterialIndex), sizeof(MaterialIndex));
+		}
+		for (const FName& SocketName : MergeKey.KeptSocketNames)
+		{
+			UpdateString(SocketName.ToString());
+		}
+		for (const UMaterialInterface* Material : MergeKey.AtlasMaterials)
+		{
+			UpdateString(GetPathNameSafe(Material));
+		}
+		for (const int32 CulledRegionMask : MergeKey.CulledRegionMasks)
+		{
+			Hash.Update(reinterpret_cast<const uint8*>(&CulledRegionMask), sizeof(CulledRegionMask));
+		}
+		for (const FRigidMeshToMergeData& RigidMesh : MergeKey.RigidMeshes)
+		{
+			UpdateString(GetPathNameSafe(RigidMesh.StaticMesh));
+			UpdateString(RigidMesh.SocketName.ToString());
+			UpdateString(RigidMesh.RelativeTransform.ToString());
+		}
+
+		Hash.Final();
+		uint8 Digest[FSHA1::DigestSize];
+		Hash.GetHash(Digest);
+		return BytesToHex(Digest, FSHA1::DigestSize);
+	}
+
+	uint32 MakeMergeSettingsHash()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		if (!Settings)
+		{
+			return 0;
+		}
+
+		uint32 Hash = GetTypeHash(ShouldConsolidateMaterials());
+		Hash = HashCombine(Hash, GetTypeHash(ShouldAtlasMaterials()));
+		Hash = HashCombine(Hash, GetTypeHash(ShouldPruneBones()));
+		Hash = HashCombine(Hash, GetTypeHash(ShouldCullCoveredSkin()));
+		Hash = HashCombine(Hash, GetTypeHash(ShouldBakeRigidAccessories()));
+		Hash = HashCombine(Hash, GetTypeHash(ShouldOptimizeVertexCache()));
+		Hash = HashCombine(Hash, GetTypeHash(ShouldOptimizeMeshMemory()));
+		if (ShouldOptimizeMeshMemory())
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Settings->GetMaxHalfPrecisionUVError()));
+		}
+		return Hash;
+	}
+
+	bool ShouldConsolidateMaterials()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetConsolidateMergedMaterials();
+	}
+
+	bool ShouldAtlasMaterials()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetAtlasMergedMaterials();
+	}
+
+	bool ShouldPruneBones()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetPruneMergedBones();
+	}
+
+	bool ShouldOptimizeMeshMemory()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetOptimizeMergedMeshMemory();
+	}
+
+	bool ShouldOptimizeVertexCache()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetOptimizeMergedVertexCache();
+	}
+
+	bool ShouldCullCoveredSkin()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetCullCoveredSkin();
+	}
+
+	int32 GetCulledRegionMask(const FMeshToMergeData& Data)
+	{
+		const USkinCoverageUserData* CoverageUserData = ShouldCullCoveredSkin() && Data.CoveredSkinMask != 0 ? USkinCoverageUserData::Find(Data.SkeletalMesh) : nullptr;
+		return CoverageUserData ? Data.CoveredSkinMask & CoverageUserData->GetRegionMask() : 0;
+	}
+
+	bool ShouldBakeRigidAccessories()
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetBakeRigidAccessories();
+	}
+
+	bool CanBakeRigidMesh(const UStaticMesh* StaticMesh)
+	{
+		return ShouldBakeRigidAccessories() && StaticMesh && StaticMesh->bAllowCPUAccess;
+	}
+
+	TArray<FRigidMeshToMergeData> CollectRigidMeshes(const TArray<FMeshToMergeData>& MeshesToMergeData)
+	{
+		TArray<FRigidMeshToMergeData> RigidMeshes;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			RigidMeshes.Append(Data.RigidMeshes);
+		}
+		return RigidMeshes;
+	}
+
+	TArray<FName> CollectKeptSocketNames(const TArray<FMeshToMergeData>& MeshesToMergeData)
+	{
+		TArray<FName> SocketNames;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			for (const FName& SocketName : Data.KeptSocketNames)
+			{
+				if (!SocketName.IsNone())
+				{
+					SocketNames.AddUnique(SocketName);
+				}
+			}
+		}
+
+		SocketNames.Sort(FNameLexicalLess());
+		return SocketNames;
+	}
+
+	UMaterialInterface* GetResolvedMaterial(const FMeshToMergeData& Data, int32 MaterialIndex)
+	{
+		if (Data.MaterialOverrides.IsValidIndex(MaterialIndex) && Data.MaterialOverrides[MaterialIndex])
+		{
+			return Data.MaterialOverrides[MaterialIndex];
+		}
+
+		const TArray<FSkeletalMaterial>& Materials = Data.SkeletalMesh->GetMaterials();
+		return Materials.IsValidIndex(MaterialIndex) ? Materials[MaterialIndex].MaterialInterface.Get() : nullptr;
+	}
+
+	int32 BuildMaterialRemap(const TArray<FMeshToMergeData>& MeshesToMergeData, TArray<TArray<int32>>& OutMaterialRemap,
+		int32* OutAtlasMaterialIndex, const FMeshMergeAtlasPlan* AtlasPlan)
+	{
+		const bool bConsolidate = ShouldConsolidateMaterials();
+
+		FMeshMergeAtlasPlan LocalAtlasPlan;
+		if (!AtlasPlan)
+		{
+			MeshMergeAtlas::PlanAtlas(MeshesToMergeData, LocalAtlasPlan);
+			AtlasPlan = &LocalAtlasPlan;
+		}
+		const bool bResolveMaterials = bConsolidate || !AtlasPlan->IsEmpty();
+
+		OutMaterialRemap.Reset(MeshesToMergeData.Num());
+		TArray<UMaterialInterface*, TInlineAllocator<16>> MergedMaterials;
+		int32 AtlasMaterialIndex = INDEX_NONE;
+
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			TArray<int32>& SourceRemap = OutMaterialRemap.AddDefaulted_GetRef();
+			if (!Data.SkeletalMesh)
+			{
+				continue;
+			}
+
+			const int32 NumMaterials = Data.SkeletalMesh->GetMaterials().Num();
+			SourceRemap.Reserve(NumMaterials);
+			for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+			{
+				// Null materials are never shared, their sections render with the default material each
+				UMaterialInterface* ResolvedMaterial = bResolveMaterials ? GetResolvedMaterial(Data, MaterialIndex) : nullptr;
+				int32 MergedIndex = INDEX_NONE;
+				if (AtlasPlan->FindEntry(ResolvedMaterial) != INDEX_NONE)
+				{
+					AtlasMaterialIndex = AtlasMaterialIndex != INDEX_NONE ? AtlasMaterialIndex : MergedMaterials.Add(nullptr);
+					MergedIndex = AtlasMaterialIndex;
+				}
+				else if (bConsolidate && ResolvedMaterial)
+				{
+					MergedIndex = MergedMaterials.Find(ResolvedMaterial);
+				}
+
+				if (MergedIndex == INDEX_NONE)
+				{
+					MergedIndex = MergedMaterials.Add(ResolvedMaterial);
+				}
+				SourceRemap.Add(MergedIndex);
+			}
+		}
+
+		if (OutAtlasMaterialIndex)
+		{
+			*OutAtlasMaterialIndex = AtlasMaterialIndex;
+		}
+		return MergedMaterials.Num();
+	}
+
+	void BuildMaterialSlotMap(const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>& OutMaterialMap)
+	{
+		TArray<TArray<int32>> MaterialRemap;
+		int32 AtlasMaterialIndex = INDEX_NONE;
+		BuildMaterialRemap(MeshesToMergeData, MaterialRemap, &AtlasMaterialIndex);
+
+		// Shared material belongs to the first slot using it. Its skin, or its mesh material, is what the whole group resolves to.
+		OutMaterialMap.Empty();
+		for (int32 DataIndex = 0; DataIndex < MeshesToMergeData.Num(); ++DataIndex)
+		{
+			for (const int32 MergedIndex : MaterialRemap[DataIndex])
+			{
+				if (MergedIndex != AtlasMaterialIndex && !OutMaterialMap.Contains(MergedIndex))
+				{
+					OutMaterialMap.Add(MergedIndex, MeshesToMergeData[DataIndex].SlotTag);
+				}
+			}
+		}
+	}
+
+	FSkeletalMeshArrayKey MakeMergePlanKey(const TArray<FMeshToMergeData>& MeshesToMergeData)
+	{
+		TArray<USkeletalMesh*> Meshes;
+		Meshes.Reserve(MeshesToMergeData.Num());
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			if (IsValid(Data.SkeletalMesh))
+			{
+				Meshes.Add(Data.SkeletalMesh);
+			}
+		}
+
+		// Pruned skeleton also depends on the sockets something attaches to, skins never change it
+		TArray<FName> KeptSocketNames;
+		if (ShouldPruneBones())
+		{
+			KeptSocketNames = Private::CollectPlanSocketNames(MeshesToMergeData);
+		}
+		return FSkeletalMeshArrayKey(MoveTemp(Meshes), TArray<int32>(), MoveTemp(KeptSocketNames));
+	}
+
+	bool IsMergePlanValid(const FMeshMergePlan& Plan, const TArray<FMeshToMergeData>& MeshesToMergeData)
+	{
+		int32 SourceIndex = 0;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			if (!IsValid(Data.SkeletalMesh))
+			{
+				continue;
+			}
+
+			if (!Plan.Sources.IsValidIndex(SourceIndex) || Plan.Sources[SourceIndex].Mesh.Get() != Data.SkeletalMesh)
+			{
+				return false;
+			}
+			++SourceIndex;
+		}
+
+		int32 FirstLODIndex = INDEX_NONE;
+		int32 LastLODIndex = INDEX_NONE;
+		if (!Private::GetResidentLODRange(MeshesToMergeData, FirstLODIndex, LastLODIndex))
+		{
+			// Failed plan of sources without a common LOD stays valid until they have one
+			return SourceIndex == Plan.Sources.Num() && Plan.bFailed && Plan.NumLODs == 0;
+		}
+		return SourceIndex == Plan.Sources.Num() && FirstLODIndex == Plan.FirstLODIndex && LastLODIndex - FirstLODIndex + 1 == Plan.NumLODs;
+	}
+
+	bool CompileMergePlan(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergePlan& OutPlan)
+	{
+		if (Private::CompileMergePlan(MeshesToMergeData, OutPlan))
+		{
+			return true;
+		}
+
+		// Sources and LOD range identify the failed part set, see IsMergePlanValid
+		OutPlan = FMeshMergePlan();
+		OutPlan.bFailed = true;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			if (IsValid(Data.SkeletalMesh))
+			{
+				OutPlan.Sources.AddDefaulted_GetRef().Mesh = Data.SkeletalMesh;
+			}
+		}
+
+		int32 FirstLODIndex = INDEX_NONE;
+		int32 LastLODIndex = INDEX_NONE;
+		if (Private::GetResidentLODRange(MeshesToMergeData, FirstLODIndex, LastLODIndex))
+		{
+			OutPlan.FirstLODIndex = FirstLODIndex;
+			OutPlan.NumLODs = LastLODIndex - FirstLODIndex + 1;
+		}
+		return false;
+	}
+
+	bool Private::CompileMergePlan(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergePlan& OutPlan)
+	{
+		check(IsInGameThread());
+
+		OutPlan = FMeshMergePlan();
+
+		// 1. Collect valid sources, all of them have to share one skeleton
+		const USkeleton* Skeleton = nullptr;
+		TArray<const USkeletalMesh*, TInlineAllocator<16>> Meshes;
+		for (const FMeshToMergeData& Data : MeshesToMergeData)
+		{
+			const USkeletalMesh* Mesh = Data.SkeletalMesh;
+			if (!IsValid(Mesh))
+			{
+				continue;
+			}
+
+			if (!Skeleton)
+			{
+				Skeleton = Mesh->GetSkeleton();
+			}
+			else if (Mesh->GetSkeleton() != Skeleton)
+			{
+				UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::CompileMergePlan - %s uses skeleton %s, expected %s"),
+					*GetNameSafe(Mesh), *GetNameSafe(Mesh->GetSkeleton()), *GetNameSafe(Skeleton));
+				return false;
+			}
+
+			const FSkeletalMeshRenderData* RenderData = Mesh->GetResourceForRendering();
+			if (!RenderData || RenderData->LODRenderData.IsEmpty())
+			{
+				UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::CompileMergePlan - %s has no render data"), *GetNameSafe(Mesh));
+				return false;
+			}
+
+			Meshes.Add(Mesh);
+			OutPlan.Sources.AddDefaulted_GetRef().Mesh = Mesh;
+		}
+
+		if (Meshes.IsEmpty() || !Skeleton)
+		{
+			UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::CompileMergePlan - Nothing to merge or base mesh has no skeleton"));
+			return false;
+		}
+
+		// 2. Merge only LODs resident for every source. Streamed out LODs have no buffers to copy.
+		int32 FirstLODIndex = INDEX_NONE;
+		int32 LastLODIndex = INDEX_NONE;
+		if (!Private::GetResidentLODRange(MeshesToMergeData, FirstLODIndex, LastLODIndex))
+		{
+			UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::CompileMergePlan - Sources have no common resident LOD"));
+			return false;
+		}
+		OutPlan.NumLODs = LastLODIndex - FirstLODIndex + 1;
+		OutPlan.FirstLODIndex = FirstLODIndex;
+
+		// 3. Merged ref skeleton: base mesh bones first, then bones only present in other parts
+		const USkeletalMesh* BaseMesh = Meshes[0];
+		OutPlan.RefSkeleton = BaseMesh->GetRefSkeleton();
+		for (int32 SourceIndex = 1; SourceIndex < Meshes.Num(); ++SourceIndex)
+		{
+			Private::AppendMissingBones(Meshes[SourceIndex]->GetRefSkeleton(), OutPlan.RefSkeleton, Skeleton);
+		}
+
+		if (ShouldPruneBones())
+		{
+			Private::PruneUnusedBones(OutPlan.RefSkeleton, Meshes, FirstLODIndex, Private::CollectPlanSocketNames(MeshesToMergeData), Skeleton);
+		}
+
+		// 4. Per source bone remaps and LOD resolved section materials
+		const bool bUse16BitBoneWeight = BaseMesh->GetResourceForRendering()->LODRenderData[FirstLODIndex].SkinWeightVertexBuffer.Use16BitBoneWeight();
+		for (int32 SourceIndex = 0; SourceIndex < Meshes.Num(); ++SourceIndex)
+		{
+			const USkeletalMesh* Mesh = Meshes[SourceIndex];
+			FMeshMergePlan::FSource& Source = OutPlan.Sources[SourceIndex];
+
+			const FReferenceSkeleton& SourceRefSkeleton = Mesh->GetRefSkeleton();
+			Source.BoneRemap.SetNumUninitialized(SourceRefSkeleton.GetRawBoneNum());
+			for (int32 BoneIndex = 0; BoneIndex < SourceRefSkeleton.GetRawBoneNum(); ++BoneIndex)
+			{
+				// Pruned bones carry no weights, they go to their closest kept parent
+				int32 MergedBoneIndex = INDEX_NONE;
+				for (int32 KeptBoneIndex = BoneIndex; KeptBoneIndex != INDEX_NONE && MergedBoneIndex == INDEX_NONE; KeptBoneIndex = SourceRefSkeleton.GetRawParentIndex(KeptBoneIndex))
+				{
+					MergedBoneIndex = OutPlan.RefSkeleton.FindRawBoneIndex(SourceRefSkeleton.GetBoneName(KeptBoneIndex));
+				}
+				check(MergedBoneIndex != INDEX_NONE);
+				Source.BoneRemap[BoneIndex] = static_cast<FBoneIndexType>(MergedBoneIndex);
+			}
+
+			const int32 NumMaterials = Mesh->GetMaterials().Num();
+			const FSkeletalMeshRenderData* RenderData = Mesh->GetResourceForRendering();
+			for (int32 LODIndex = FirstLODIndex; LODIndex <= LastLODIndex; ++LODIndex)
+			{
+				const FSkeletalMeshLODRenderData& LODData = RenderData->LODRenderData[LODIndex];
+				if (!HasCPUAccess(LODData) && !MeshMergeSourceScratch::IsEnabled())
+				{
+					UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::CompileMergePlan - %s LOD %d has no CPU access, enable 'Allow CPU Access' on the mesh or transient source copies on an RHI that can read them back"),
+						*GetNameSafe(Mesh), LODIndex);
+					return false;
+				}
+
+				if (LODData.SkinWeightVertexBuffer.Use16BitBoneWeight() != bUse16BitBoneWeight)
+				{
+					UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::CompileMergePlan - %s LOD %d bone weight precision differs from base mesh"),
+						*GetNameSafe(Mesh), LODIndex);
+					return false;
+				}
+
+				// Resolve LOD material overrides now, merged LODs don't carry a LODMaterialMap
+				const FSkeletalMeshLODInfo* LODInfo = Mesh->GetLODInfo(LODIndex);
+				TArray<int32>& SectionMaterials = Source.SectionMaterials.AddDefaulted_GetRef();
+				SectionMaterials.Reserve(LODData.RenderSections.Num());
+				for (int32 SectionIndex = 0; SectionIndex < LODData.RenderSections.Num(); ++SectionIndex)
+				{
+					int32 MaterialIndex = LODData.RenderSections[SectionIndex].MaterialIndex;
+					if (LODInfo && LODInfo->LODMaterialMap.IsValidIndex(SectionIndex) && LODInfo->LODMaterialMap[SectionIndex] != INDEX_NONE)
+					{
+						MaterialIndex = LODInfo->LODMaterialMap[SectionIndex];
+					}
+					SectionMaterials.Add(MaterialIndex >= 0 && MaterialIndex < NumMaterials ? MaterialIndex : 0);
+				}
+			}
+		}
+
+		// 5. LOD settings follow the base mesh
+		for (int32 LODIndex = FirstLODIndex; LODIndex <= LastLODIndex; ++LODIndex)
+		{
+			FSkeletalMeshLODInfo& LODInfo = OutPlan.LODInfos.AddDefaulted_GetRef();
+			if (const FSkeletalMeshLODInfo* BaseLODInfo = BaseMesh->GetLODInfo(LODIndex))
+			{
+				LODInfo = *BaseLODInfo;
+			}
+			LODInfo.LODMaterialMap.Empty();
+		}
+
+		UE_LOG(LogMeshMerge, Verbose, TEXT("MeshMergeUtilities::CompileMergePlan - Compiled plan of %d parts, %d bones, %d LODs"),
+			OutPlan.Sources.Num(), OutPlan.RefSkeleton.GetRawBoneNum(), OutPlan.NumLODs);
+		return true;
+	}
+
+	bool GatherMergeData(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergeGatherData& OutGatherData, const USkeletalMesh* PreviousMergedMesh, const FMeshMergePlan* Plan)
+	{
+		check(IsInGameThread());
+
+		OutGatherData = FMeshMergeGatherData();
+
+		// 1. Topology comes from the plan, compiled here when the caller has none or it went stale. Failed plan already logged why.
+		if (Plan && Plan->bFailed && IsMergePlanValid(*Plan, MeshesToMergeData))
+		{
+			return false;
+		}
+
+		FMeshMergePlan LocalPlan;
+		if (!Plan || Plan->bFailed || !IsMergePlanValid(*Plan, MeshesToMergeData))
+		{
+			if (!CompileMergePlan(MeshesToMergeData, LocalPlan))
+			{
+				return false;
+			}
+			Plan = &LocalPlan;
+		}
+
+		OutGatherData.RefSkeleton = Plan->RefSkeleton;
+		OutGatherData.LODInfos = Plan->LODInfos;
+		OutGatherData.NumLODs = Plan->NumLODs;
+		OutGatherData.FirstLODIndex = Plan->FirstLODIndex;
+		OutGatherData.bAllowCPUAccess = OutGatherData.LODInfos[0].bAllowCPUAccess;
+
+		// 2. Materials depend on skins, they are mapped for every merge
+		MeshMergeAtlas::PlanAtlas(MeshesToMergeData, OutGatherData.AtlasPlan);
+
+		TArray<TArray<int32>> MaterialRemap;
+		const int32 NumMergedMaterials = BuildMaterialRemap(MeshesToMergeData, MaterialRemap, &OutGatherData.AtlasMaterialIndex, &OutGatherData.AtlasPlan);
+		OutGatherData.Materials.SetNum(NumMergedMaterials);
+		OutGatherData.bConsolidateSections = ShouldConsolidateMaterials() || OutGatherData.AtlasMaterialIndex != INDEX_NONE;
+		OutGatherData.MaxBonesPerSection = FGPUBaseSkinVertexFactory::GetMaxGPUSkinBones();
+		OutGatherData.bOptimizeVertexCache = ShouldOptimizeVertexCache();
+		if (ShouldOptimizeMeshMemory())
+		{
+			OutGatherData.MaxHalfUVError = FMath::Max(UCustomizationSettings::Get()->GetMaxHalfPrecisionUVError(), 0.f);
+		}
+
+		// 3. Per source render data, materials and culled ranges. Plan sources follow valid parts in order.
+		for (int32 DataIndex = 0; DataIndex < MeshesToMergeData.Num(); ++DataIndex)
+		{
+			const FMeshToMergeData& Data = MeshesToMergeData[DataIndex];
+			if (!IsValid(Data.SkeletalMesh))
+			{
+				continue;
+			}
+
+			const FMeshMergePlan::FSource& PlanSource = Plan->Sources[OutGatherData.Sources.Num()];
+			FMeshMergeSource& Source = OutGatherData.Sources.AddDefaulted_GetRef();
+			Source.Mesh = Data.SkeletalMesh;
+			Source.SlotTag = Data.SlotTag;
+			Source.MaterialRemap = MoveTemp(MaterialRemap[DataIndex]);
+			Source.BoneRemap = PlanSource.BoneRemap;
+			Source.CulledRegionMask = GetCulledRegionMask(Data);
+
+			Source.MaterialAtlasEntries.Init(INDEX_NONE, Source.Mesh->GetMaterials().Num());
+			for (int32 MaterialIndex = 0; MaterialIndex < Source.MaterialAtlasEntries.Num() && !OutGatherData.AtlasPlan.IsEmpty(); ++MaterialIndex)
+			{
+				Source.MaterialAtlasEntries[MaterialIndex] = OutGatherData.AtlasPlan.FindEntry(GetResolvedMaterial(Data, MaterialIndex));
+			}
+
+			// Shared merged material takes the mesh material of its first user, see BuildMaterialSlotMap. Atlas material is created in phase 3.
+			const TArray<FSkeletalMaterial>& SourceMaterials = Source.Mesh->GetMaterials();
+			for (int32 MaterialIndex = 0; MaterialIndex < SourceMaterials.Num(); ++MaterialIndex)
+			{
+				const int32 MergedIndex = Source.MaterialRemap[MaterialIndex];
+				if (MergedIndex != OutGatherData.AtlasMaterialIndex && !OutGatherData.MaterialSlotMap.Contains(MergedIndex))
+				{
+					OutGatherData.MaterialSlotMap.Add(MergedIndex, Source.SlotTag);
+					OutGatherData.Materials[MergedIndex] = SourceMaterials[MaterialIndex];
+				}
+			}
+
+			// Authored regions use source LODs, merged LODs start at the first resident one
+			const USkinCoverageUserData* CoverageUserData = Source.CulledRegionMask != 0 ? USkinCoverageUserData::Find(Source.Mesh) : nullptr;
+			for (const FSkinCoverageRegion& Region : CoverageUserData ? CoverageUserData->Regions : TArray<FSkinCoverageRegion>())
+			{
+				const int32 MergedLODIndex = Region.LODIndex - OutGatherData.FirstLODIndex;
+				if ((Source.CulledRegionMask & (1 << static_cast<int32>(Region.Region))) != 0 && Region.NumTriangles > 0
+					&& MergedLODIndex >= 0 && MergedLODIndex < OutGatherData.NumLODs)
+				{
+					FMeshMergeCulledRange& Range = Source.CulledRanges.AddDefaulted_GetRef();
+					Range.LODIndex = MergedLODIndex;
+					Range.SectionIndex = Region.SectionIndex;
+					Range.FirstTriangle = Region.FirstTriangle;
+					Range.NumTriangles = Region.NumTriangles;
+				}
+			}
+
+			const FSkeletalMeshRenderData* RenderData = Source.Mesh->GetResourceForRendering();
+			for (int32 LODIndex = 0; LODIndex < OutGatherData.NumLODs; ++LODIndex)
+			{
+				Source.LODs.Add(&RenderData->LODRenderData[OutGatherData.FirstLODIndex + LODIndex]);
+
+				TArray<int32>& SectionMaterials = Source.SectionMaterials.AddDefaulted_GetRef();
+				TArray<int32>& SectionAtlasEntries = Source.SectionAtlasEntries.AddDefaulted_GetRef();
+				SectionMaterials.Reserve(PlanSource.SectionMaterials[LODIndex].Num());
+				SectionAtlasEntries.Reserve(PlanSource.SectionMaterials[LODIndex].Num());
+				for (const int32 MaterialIndex : PlanSource.SectionMaterials[LODIndex])
+				{
+					SectionMaterials.Add(Source.MaterialRemap[MaterialIndex]);
+					SectionAtlasEntries.Add(Source.MaterialAtlasEntries[MaterialIndex]);
+				}
+			}
+
+			OutGatherData.Bounds = OutGatherData.Bounds.SphereRadius > 0.f
+				? OutGatherData.Bounds + Source.Mesh->GetImportedBounds()
+				: Source.Mesh->GetImportedBounds();
+		}
+
+		// 4. Baked accessories, skinned to the ref pose of their socket bones
+		const USkeletalMesh* BaseMesh = OutGatherData.Sources[0].Mesh;
+		for (const FRigidMeshToMergeData& RigidData : CollectRigidMeshes(MeshesToMergeData))
+		{
+			Private::GatherRigidSource(RigidData, BaseMesh, OutGatherData);
+		}
+
+		// 5. Memory optimizer keeps the streams merged materials and the skins put on them later read. Atlas entries are resolved part materials.
+		if (ShouldOptimizeMeshMemory())
+		{
+			Private::FMaterialStreamUsage StreamUsage = Private::GetPartsStreamUsage(MeshesToMergeData);
+			for (const FSkeletalMaterial& Material : OutGatherData.Materials)
+			{
+				StreamUsage.Append(Private::GetMaterialStreamUsage(Material.MaterialInterface));
+			}
+			OutGatherData.MaxTexCoords = static_cast<uint32>(FMath::Max(StreamUsage.NumTexCoords, 1));
+			OutGatherData.bStripVertexColors = !StreamUsage.bReadsVertexColor;
+		}
+
+		// 6. Merged mesh this one replaces, parts both share are copied from it instead of rebuilt. Atlas mips are read on the worker.
+		Private::GatherPreviousMesh(PreviousMergedMesh, OutGatherData);
+		return true;
+	}
+
+	bool AcquireSourceCopies(FMeshMergeGatherData& InOutGatherData)
+	{
+		check(IsInGameThread());
+
+		// Source LODs without CPU access are read through transient copies gather data keeps alive
+		TArray<MeshMergeSourceScratch::FRequest> Requests;
+		for (const FMeshMergeSource& Source : InOutGatherData.Sources)
+		{
+			for (const FSkeletalMeshLODRenderData* LODData : Source.LODs)
+			{
+				if (!HasCPUAccess(*LODData))
+				{
+					Requests.Add({ Source.Mesh, LODData });
+				}
+			}
+		}
+
+		if (Requests.IsEmpty())
+		{
+			return true;
+		}
+
+		if (!MeshMergeSourceScratch::IsEnabled())
+		{
+			UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::AcquireSourceCopies - %s has no CPU access and transient source copies are unavailable"),
+				*GetNameSafe(Requests[0].Mesh));
+			return false;
+		}
+
+		MeshMergeSourceScratch::AcquireCopies(Requests);
+		int32 RequestIndex = 0;
+		for (FMeshMergeSource& Source : InOutGatherData.Sources)
+		{
+			for (const FSkeletalMeshLODRenderData*& LODData : Source.LODs)
+			{
+				if (HasCPUAccess(*LODData))
+				{
+					continue;
+				}
+
+				const MeshMergeSourceScratch::FScratchLODPtr& Copy = Requests[RequestIndex++].Copy;
+				if (!Copy)
+				{
+					return false;
+				}
+				LODData = Copy.Get();
+				InOutGatherData.ScratchLODs.Add(Copy);
+			}
+		}
+		return true;
+	}
+
+	bool BuildMergedLOD(const FMeshMergeGatherData& GatherData, int32 LODIndex, FSkeletalMeshLODRenderData& OutLODData, int64* OutNumSavedBytes)
+	{
+		// 1. Group sections and count totals and buffer formats up front so every buffer is allocated exactly once
+		TArray<Private::FSectionGroup> Groups;
+		Private::BuildSectionGroups(GatherData, LODIndex, Groups);
+
+		uint32 NumVertices = 0;
+		uint32 NumIndices = 0;
+		uint32 NumTexCoords = 1;
+		uint32 MaxBoneInfluences = 0;
+		bool bUseFullPrecisionUVs = false;
+		bool bUseHighPrecisionTangents = false;
+		bool bUse16BitBoneIndex = false;
+		bool bHasVertexColors = false;
+
+		TArray<TArray<uint32>, TInlineAllocator<8>> SourceIndices;
+		TArray<TArray<FSkinWeightInfo>, TInlineAllocator<8>> SourceSkinWeights;
+		SourceIndices.SetNum(GatherData.Sources.Num());
+		SourceSkinWeights.SetNum(GatherData.Sources.Num());
+
+		for (int32 SourceIndex = 0; SourceIndex < GatherData.Sources.Num(); ++SourceIndex)
+		{
+			const FSkeletalMeshLODRenderData& LODData = *GatherData.Sources[SourceIndex].LODs[LODIndex];
+			const FStaticMeshVertexBuffer& MeshVertexBuffer = LODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+
+			NumTexCoords = FMath::Max(NumTexCoords, MeshVertexBuffer.GetNumTexCoords());
+			MaxBoneInfluences = FMath::Max(MaxBoneInfluences, LODData.SkinWeightVertexBuffer.GetMaxBoneInfluences());
+			bUseFullPrecisionUVs |= MeshVertexBuffer.GetUseFullPrecisionUVs();
+			bUseHighPrecisionTangents |= MeshVertexBuffer.GetUseHighPrecisionTangentBasis();
+			bUse16BitBoneIndex |= LODData.SkinWeightVertexBuffer.Use16BitBoneIndex();
+			bHasVertexColors |= LODData.StaticVertexBuffers.ColorVertexBuffer.GetNumVertices() > 0;
+		}
+
+		for (const FMeshMergeRigidSource& RigidSource : GatherData.RigidSources)
+		{
+			const FStaticMeshVertexBuffers& VertexBuffers = RigidSource.LODs[LODIndex]->VertexBuffers;
+			NumTexCoords = FMath::Max(NumTexCoords, VertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords());
+			bUseFullPrecisionUVs |= VertexBuffers.StaticMeshVertexBuffer.GetUseFullPrecisionUVs();
+			bUseHighPrecisionTangents |= VertexBuffers.StaticMeshVertexBuffer.GetUseHighPrecisionTangentBasis();
+			bHasVertexColors |= VertexBuffers.ColorVertexBuffer.GetNumVertices() > 0;
+		}
+
+		// Memory optimizer drops streams merged materials don't read, the rest of the build follows the reduced format
+		const uint32 SourceUVAndColorStride = Private::GetUVAndColorStride(NumTexCoords, bUseFullPrecisionUVs, bHasVertexColors);
+		NumTexCoords = FMath::Min(NumTexCoords, GatherData.MaxTexCoords);
+		bHasVertexColors &= !GatherData.bStripVertexColors;
+		if (bUseFullPrecisionUVs && GatherData.MaxHalfUVError > 0.f)
+		{
+			bUseFullPrecisionUVs = !Private::FitHalfPrecisionUVs(GatherData, LODIndex, NumTexCoords);
+		}
+
+		// Culled sections need source indices before anything is counted
+		TArray<TArray<Private::FCulledSection>, TInlineAllocator<8>> CulledSections;
+		CulledSections.SetNum(GatherData.Sources.Num());
+		for (int32 SourceIndex = 0; SourceIndex < GatherData.Sources.Num(); ++SourceIndex)
+		{
+			const FMeshMergeSource& Source = GatherData.Sources[SourceIndex];
+			if (!Source.CulledRanges.ContainsByPredicate([LODIndex](const FMeshMergeCulledRange& Range) { return Range.LODIndex == LODIndex; }))
+			{
+				continue;
+			}
+
+			const FSkeletalMeshLODRenderData& LODData = *Source.LODs[LODIndex];
+			LODData.MultiSizeIndexContainer.GetIndexBuffer(SourceIndices[SourceIndex]);
+			CulledSections[SourceIndex].SetNum(LODData.RenderSections.Num());
+			for (int32 SectionIndex = 0; SectionIndex < LODData.RenderSections.Num(); ++SectionIndex)
+			{
+				Private::CullSection(LODData.RenderSections[SectionIndex], SourceIndices[SourceIndex], LODIndex, SectionIndex, Source.CulledRanges, CulledSections[SourceIndex][SectionIndex]);
+			}
+		}
+
+		auto FindCulledSection = [&CulledSections](int32 SourceIndex, int32 SectionIndex) -> const Private::FCulledSection*
+		{
+			const TArray<Private::FCulledSection>& SourceCulledSections = CulledSections[SourceIndex];
+			return SourceCulledSections.IsValidIndex(SectionIndex) && SourceCulledSections[SectionIndex].bCulled ? &SourceCulledSections[SectionIndex] : nullptr;
+		};
+
+		TArray<FMergedPartRange, TInlineAllocator<8>> SourceSizes;
+		SourceSizes.SetNum(GatherData.Sources.Num());
+		for (const Private::FSectionGroup& Group : Groups)
+		{
+			// Bone map slots past 255 don't fit 8 bit influence indices
+			bUse16BitBoneIndex |= Group.BoneMap.Num() > MAX_uint8 + 1;
+			for (const Private::FSectionGroupMember& Member : Group.Members)
+			{
+				const FSkelMeshRenderSection& Section = GatherData.Sources[Member.SourceIndex].LODs[LODIndex]->RenderSections[Member.SectionIndex];
+				const Private::FCulledSection* CulledSection = FindCulledSection(Member.SourceIndex, Member.SectionIndex);
+				FMergedPartRange& SourceSize = SourceSizes[Member.SourceIndex];
+				SourceSize.NumVertices += CulledSection ? CulledSection->Vertices.Num() : Section.NumVertices;
+				SourceSize.NumIndices += CulledSection ? CulledSection->Indices.Num() : Section.NumTriangles * 3;
+			}
+		}
+
+		for (const FMergedPartRange& SourceSize : SourceSizes)
+		{
+			NumVertices += SourceSize.NumVertices;
+			NumIndices += SourceSize.NumIndices;
+		}
+
+		for (const FMeshMergeRigidSource& RigidSource : GatherData.RigidSources)
+		{
+			NumVertices += RigidSource.LODs[LODIndex]->VertexBuffers.PositionVertexBuffer.GetNumVertices();
+			NumIndices += Private::GetRigidNumIndices(*RigidSource.LODs[LODIndex]);
+		}
+
+		if (NumVertices == 0 || NumIndices == 0)
+		{
+			UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::BuildMergedLOD - LOD %d has no geometry"), LODIndex);
+			return false;
+		}
+
+		if (OutNumSavedBytes)
+		{
+			*OutNumSavedBytes = static_cast<int64>(NumVertices) * (SourceUVAndColorStride - Private::GetUVAndColorStride(NumTexCoords, bUseFullPrecisionUVs, bHasVertexColors));
+		}
+
+		FPositionVertexBuffer& PositionBuffer = OutLODData.StaticVertexBuffers.PositionVertexBuffer;
+		FStaticMeshVertexBuffer& MeshVertexBuffer = OutLODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+		FColorVertexBuffer& ColorBuffer = OutLODData.StaticVertexBuffers.ColorVertexBuffer;
+
+		MeshVertexBuffer.SetUseFullPrecisionUVs(bUseFullPrecisionUVs);
+		MeshVertexBuffer.SetUseHighPrecisionTangentBasis(bUseHighPrecisionTangents);
+
+		PositionBuffer.Init(NumVertices, GatherData.bAllowCPUAccess);
+		MeshVertexBuffer.Init(NumVertices, NumTexCoords, GatherData.bAllowCPUAccess);
+		if (bHasVertexColors)
+		{
+			ColorBuffer.Init(NumVertices, GatherData.bAllowCPUAccess);
+		}
+
+		TArray<FSkinWeightInfo> MergedSkinWeights;
+		MergedSkinWeights.Reserve(NumVertices);
+
+		TArray<uint32> MergedIndices;
+		MergedIndices.Reserve(NumIndices);
+
+		// 2. Parts kept from the previous merged mesh are copied as a whole range, only their sections and BoneMaps are rebuilt
+		TArray<const FMergedPartRange*, TInlineAllocator<16>> PreviousRanges;
+		PreviousRanges.SetNumZeroed(GatherData.Sources.Num());
+		const int32 PreviousLODIndex = GatherData.FirstLODIndex + LODIndex - (GatherData.PreviousLayout ? GatherData.PreviousLayout->FirstLODIndex : 0);
+		const FSkeletalMeshLODRenderData* PreviousLOD = GatherData.PreviousLayout && GatherData.PreviousLODs.IsValidIndex(PreviousLODIndex) ? GatherData.PreviousLODs[PreviousLODIndex] : nullptr;
+		if (PreviousLOD && !GatherData.bConsolidateSections
+			&& Private::HasSameVertexFormat(*PreviousLOD, NumTexCoords, bUseFullPrecisionUVs, bUseHighPrecisionTangents, bHasVertexColors))
+		{
+			TBitArray<> UsedParts(false, GatherData.PreviousLayout->Parts.Num());
+			for (int32 SourceIndex = 0; SourceIndex < GatherData.Sources.Num(); ++SourceIndex)
+			{
+				PreviousRanges[SourceIndex] = Private::FindPreviousRange(GatherData, LODIndex, SourceIndex, SourceSizes[SourceIndex], UsedParts);
+			}
+		}
+
+		for (int32 SourceIndex = 0; SourceIndex < GatherData.Sources.Num(); ++SourceIndex)
+		{
+			if (!PreviousRanges[SourceIndex])
+			{
+				const FSkeletalMeshLODRenderData& LODData = *GatherData.Sources[SourceIndex].LODs[LODIndex];
+				if (SourceIndices[SourceIndex].IsEmpty())
+				{
+					LODData.MultiSizeIndexContainer.GetIndexBuffer(SourceIndices[SourceIndex]);
+				}
+				LODData.SkinWeightVertexBuffer.GetSkinWeights(SourceSkinWeights[SourceIndex]);
+			}
+		}
+
+		// 3. Copy every group as one contiguous vertex and index range. Skin weights reference section local
+		// BoneMap slots, so they are moved to the slots of the group BoneMap.
+		uint32 VertexOffset = 0;
+		uint32 IndexOffset = 0;
+		int32 NumReusedParts = 0;
+		for (const Private::FSectionGroup& Group : Groups)
+		{
+			const FSkelMeshRenderSection& TemplateSection = GatherData.Sources[Group.Members[0].SourceIndex].LODs[LODIndex]->RenderSections[Group.Members[0].SectionIndex];
+
+			FSkelMeshRenderSection& MergedSection = OutLODData.RenderSections.AddDefaulted_GetRef();
+			MergedSection.MaterialIndex = static_cast<uint16>(Group.MaterialIndex);
+			MergedSection.BaseIndex = IndexOffset;
+			MergedSection.BaseVertexIndex = VertexOffset;
+			MergedSection.bRecomputeTangent = TemplateSection.bRecomputeTangent;
+			MergedSection.RecomputeTangentsVertexMaskChannel = TemplateSection.RecomputeTangentsVertexMaskChannel;
+			MergedSection.bCastShadow = TemplateSection.bCastShadow;
+			MergedSection.bVisibleInRayTracing = TemplateSection.bVisibleInRayTracing;
+			MergedSection.bDisabled = TemplateSection.bDisabled;
+			MergedSection.BoneMap = Group.BoneMap;
+			MergedSection.DuplicatedVerticesBuffer.Init(1, TMap<int, TArray<int32>>());
+
+			for (const Private::FSectionGroupMember& Member : Group.Members)
+			{
+				const FSkeletalMeshLODRenderData& LODData = *GatherData.Sources[Member.SourceIndex].LODs[LODIndex];
+				const FSkelMeshRenderSection& SourceSection = LODData.RenderSections[Member.SectionIndex];
+				const FStaticMeshVertexBuffer& SourceMeshVertexBuffer = LODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+				const FPositionVertexBuffer& SourcePositionBuffer = LODData.StaticVertexBuffers.PositionVertexBuffer;
+				const FColorVertexBuffer& SourceColorBuffer = LODData.StaticVertexBuffers.ColorVertexBuffer;
+				const uint32 SourceNumTexCoords = SourceMeshVertexBuffer.GetNumTexCoords();
+				const bool bSourceHasColors = SourceColorBuffer.GetNumVertices() == LODData.GetNumVertices();
+				const uint32 SourceMaxBoneInfluences = LODData.SkinWeightVertexBuffer.GetMaxBoneInfluences();
+				const TArray<FSkinWeightInfo>& SkinWeights = SourceSkinWeights[Member.SourceIndex];
+				const FMergedPartRange* PreviousRange = PreviousRanges[Member.SourceIndex];
+				const int32 AtlasEntryIndex = GatherData.Sources[Member.SourceIndex].SectionAtlasEntries[LODIndex][Member.SectionIndex];
+				const FMeshMergeAtlasEntry* AtlasEntry = AtlasEntryIndex != INDEX_NONE ? &GatherData.AtlasPlan.Entries[AtlasEntryIndex] : nullptr;
+				const Private::FCulledSection* CulledSection = FindCulledSection(Member.SourceIndex, Member.SectionIndex);
+				const uint32 NumMemberVertices = CulledSection ? CulledSection->Vertices.Num() : SourceSection.NumVertices;
+				const uint32 NumMemberIndices = CulledSection ? CulledSection->Indices.Num() : SourceSection.NumTriangles * 3;
+
+				// Whole part is copied with its first section, the rest of its sections only advance the offsets
+				if (PreviousRange)
+				{
+					if (Member.SectionIndex == 0)
+					{
+						Private::CopyPreviousRange(*PreviousLOD, *PreviousRange, VertexOffset, OutLODData, MergedSkinWeights, MergedIndices);
+						++NumReusedParts;
+					}
+				}
+				else
+				{
+					auto GetSourceVertexIndex = [CulledSection, &SourceSection](uint32 LocalVertexIndex)
+					{
+						return CulledSection ? CulledSection->Vertices[LocalVertexIndex] : SourceSection.BaseVertexIndex + LocalVertexIndex;
+					};
+
+					// Contiguous section of the merged format goes as raw memory, the rest is converted per vertex
+					if (!CulledSection && !AtlasEntry && Private::HasSameStreamFormat(SourceMeshVertexBuffer, MeshVertexBuffer))
+					{
+						Private::CopyVertexStreams(LODData.StaticVertexBuffers, SourceSection.BaseVertexIndex, NumMemberVertices, OutLODData.StaticVertexBuffers, VertexOffset);
+					}
+					else
+					{
+						for (uint32 LocalVertexIndex = 0; LocalVertexIndex < NumMemberVertices; ++LocalVertexIndex)
+						{
+							const uint32 VertexIndex = GetSourceVertexIndex(LocalVertexIndex);
+							const uint32 MergedVertexIndex = VertexOffset + LocalVertexIndex;
+
+							PositionBuffer.VertexPosition(MergedVertexIndex) = SourcePositionBuffer.VertexPosition(VertexIndex);
+
+							MeshVertexBuffer.SetVertexTangents(MergedVertexIndex,
+								FVector3f(SourceMeshVertexBuffer.VertexTangentX(VertexIndex)),
+								SourceMeshVertexBuffer.VertexTangentY(VertexIndex),
+								FVector3f(SourceMeshVertexBuffer.VertexTangentZ(VertexIndex)));
+
+							for (uint32 UVIndex = 0; UVIndex < NumTexCoords; ++UVIndex)
+							{
+								FVector2f UV = UVIndex < SourceNumTexCoords ? SourceMeshVertexBuffer.GetVertexUV(VertexIndex, UVIndex) : FVector2f::ZeroVector;
+								if (UVIndex == 0 && AtlasEntry)
+								{
+									UV = AtlasEntry->RemapUV(UV);
+								}
+								MeshVertexBuffer.SetVertexUV(MergedVertexIndex, UVIndex, UV);
+							}
+
+							if (bHasVertexColors)
+							{
+								ColorBuffer.VertexColor(MergedVertexIndex) = bSourceHasColors ? SourceColorBuffer.VertexColor(VertexIndex) : FColor::White;
+							}
+						}
+					}
+
+					// Written in place, both arrays were reserved for the whole LOD
+					FSkinWeightInfo* MemberSkinWeights = MergedSkinWeights.GetData() + MergedSkinWeights.AddUninitialized(NumMemberVertices);
+					for (uint32 LocalVertexIndex = 0; LocalVertexIndex < NumMemberVertices; ++LocalVertexIndex)
+					{
+						MemberSkinWeights[LocalVertexIndex] = SkinWeights[GetSourceVertexIndex(LocalVertexIndex)];
+						Private::RemapInfluences(MemberSkinWeights[LocalVertexIndex], Member.LocalBoneRemap, SourceMaxBoneInfluences);
+					}
+
+					// Indices are rebased from the source section range onto the group range
+					uint32* MemberIndices = MergedIndices.GetData() + MergedIndices.AddUninitialized(NumMemberIndices);
+					if (CulledSection)
+					{
+						Private::RebaseIndices(CulledSection->Indices.GetData(), NumMemberIndices, static_cast<int32>(VertexOffset), MemberIndices);
+					}
+					else
+					{
+						Private::RebaseIndices(SourceIndices[Member.SourceIndex].GetData() + SourceSection.BaseIndex, NumMemberIndices,
+							static_cast<int32>(VertexOffset) - static_cast<int32>(SourceSection.BaseVertexIndex), MemberIndices);
+					}
+				}
+
+				MergedSection.NumTriangles += NumMemberIndices / 3;
+				MergedSection.NumVertices += NumMemberVertices;
+				MergedSection.MaxBoneInfluences = FMath::Max(MergedSection.MaxBoneInfluences, SourceSection.MaxBoneInfluences);
+				VertexOffset += NumMemberVertices;
+				IndexOffset += NumMemberIndices;
+			}
+
+			// Section fully under clothing stays in place for the 1:1 layout but is not drawn
+			MergedSection.bDisabled |= MergedSection.NumTriangles == 0;
+		}
+
+		// Baked accessories go after all parts, so part sections stay 1:1 with the layout
+		for (const FMeshMergeRigidSource& RigidSource : GatherData.RigidSources)
+		{
+			const FStaticMeshLODResources& LODResources = *RigidSource.LODs[LODIndex];
+			Private::CopyRigidSource(RigidSource, LODIndex, NumTexCoords, bHasVertexColors, VertexOffset, IndexOffset, OutLODData, MergedSkinWeights, MergedIndices);
+			VertexOffset += LODResources.VertexBuffers.PositionVertexBuffer.GetNumVertices();
+			IndexOffset += Private::GetRigidNumIndices(LODResources);
+			OutLODData.ActiveBoneIndices.AddUnique(RigidSource.BoneIndex);
+			OutLODData.RequiredBones.AddUnique(RigidSource.BoneIndex);
+		}
+
+		UE_CLOG(NumReusedParts > 0, LogMeshMerge, Verbose, TEXT("MeshMergeUtilities::BuildMergedLOD - LOD %d copied %d of %d parts from previous merge"),
+			LODIndex, NumReusedParts, GatherData.Sources.Num());
+
+		for (const FMeshMergeSource& Source : GatherData.Sources)
+		{
+			const FSkeletalMeshLODRenderData& LODData = *Source.LODs[LODIndex];
+			Private::RemapBoneIndices(LODData.ActiveBoneIndices, Source.BoneRemap, OutLODData.ActiveBoneIndices);
+			Private::RemapBoneIndices(LODData.RequiredBones, Source.BoneRemap, OutLODData.RequiredBones);
+		}
+
+		// 4. Skin weights and indices
+		FSkinWeightVertexBuffer& SkinWeightBuffer = OutLODData.SkinWeightVertexBuffer;
+		SkinWeightBuffer.SetNeedsCPUAccess(GatherData.bAllowCPUAccess);
+		SkinWeightBuffer.SetMaxBoneInfluences(MaxBoneInfluences);
+		SkinWeightBuffer.SetUse16BitBoneIndex(bUse16BitBoneIndex);
+		SkinWeightBuffer.SetUse16BitBoneWeight(GatherData.Sources[0].LODs[LODIndex]->SkinWeightVertexBuffer.Use16BitBoneWeight());
+		SkinWeightBuffer = MergedSkinWeights;
+
+		// Parts keep their own triangle order, reordering within a section keeps every part inside its ranges
+		if (GatherData.bOptimizeVertexCache)
+		{
+			const float ACMRBefore = MeshMergeVertexCache::ComputeACMR(MergedIndices);
+			for (const FSkelMeshRenderSection& Section : OutLODData.RenderSections)
+			{
+				MeshMergeVertexCache::OptimizeTriangleOrder(MakeArrayView(MergedIndices).Slice(Section.BaseIndex, Section.NumTriangles * 3), Section.BaseVertexIndex, Section.NumVertices);
+			}
+			UE_LOG(LogMeshMerge, Verbose, TEXT("MeshMergeUtilities::BuildMergedLOD - LOD %d vertex cache ACMR %.3f -> %.3f"),
+				LODIndex, ACMRBefore, MeshMergeVertexCache::ComputeACMR(MergedIndices));
+		}
+
+		const uint8 IndexDataTypeSize = NumVertices > MAX_uint16 ? sizeof(uint32) : sizeof(uint16);
+		OutLODData.MultiSizeIndexContainer.RebuildIndexBuffer(IndexDataTypeSize, MergedIndices);
+
+		// 5. Bones used by any part, parents included, in hierarchy order
+		FAnimationRuntime::EnsureParentsPresent(OutLODData.ActiveBoneIndices, GatherData.RefSkeleton);
+		FAnimationRuntime::EnsureParentsPresent(OutLODData.RequiredBones, GatherData.RefSkeleton);
+		OutLODData.ActiveBoneIndices.Sort();
+		OutLODData.RequiredBones.Sort();
+
+		return true;
+	}
+
+	void BuildMergedMeshData(const FMeshMergeGatherData& GatherData, FMergedMeshBuildData& OutBuildData)
+	{
+		// Sources without CPU access are unread until AcquireSourceCopies, e.g. after a disk cache entry failed to load
+		for (const FMeshMergeSource& Source : GatherData.Sources)
+		{
+			for (const FSkeletalMeshLODRenderData* LODData : Source.LODs)
+			{
+				if (!HasCPUAccess(*LODData))
+				{
+					UE_LOG(LogMeshMerge, Error, TEXT("MeshMergeUtilities::BuildMergedMeshData - %s has no CPU readable render data, source copies were not acquired"),
+						*GetNameSafe(Source.Mesh));
+					OutBuildData.LODs.Reset();
+					OutBuildData.bSucceeded = false;
+					return;
+				}
+			}
+		}
+
+		OutBuildData.LODs.Reset(GatherData.NumLODs);
+		for (int32 LODIndex = 0; LODIndex < GatherData.NumLODs; ++LODIndex)
+		{
+			OutBuildData.LODs.Add(MakeUnique<FSkeletalMeshLODRenderData>());
+		}
+
+		// Every LOD and the atlas only read gather data and write their own output, each is built on its own task and joined here
+		const bool bBuildAtlas = GatherData.AtlasMaterialIndex != INDEX_NONE;
+		const int32 NumTasks = GatherData.NumLODs + (bBuildAtlas ? 1 : 0);
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		const bool bParallel = NumTasks > 1 && Settings && Settings->GetBuildMergedLODsInParallel();
+
+		TArray<bool, TInlineAllocator<8>> LODSucceeded;
+		TArray<int64, TInlineAllocator<8>> LODSavedBytes;
+		LODSucceeded.SetNumZeroed(GatherData.NumLODs);
+		LODSavedBytes.SetNumZeroed(GatherData.NumLODs);
+		bool bAtlasSucceeded = true;
+		ParallelFor(TEXT("MeshMergeUtilities::BuildMergedMeshData"), NumTasks, 1, [&GatherData, &OutBuildData, &LODSucceeded, &LODSavedBytes, &bAtlasSucceeded](int32 TaskIndex)
+		{
+			if (TaskIndex < GatherData.NumLODs)
+			{
+				LODSucceeded[TaskIndex] = BuildMergedLOD(GatherData, TaskIndex, *OutBuildData.LODs[TaskIndex], &LODSavedBytes[TaskIndex]);
+			}
+			else
+			{
+				bAtlasSucceeded = MeshMergeAtlas::BuildAtlasData(GatherData, OutBuildData.AtlasMips);
+			}
+		}, bParallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+		OutBuildData.bSucceeded = GatherData.NumLODs > 0 && !LODSucceeded.Contains(false) && bAtlasSucceeded;
+		OutBuildData.NumSavedBytes = 0;
+		for (const int64 SavedBytes : LODSavedBytes)
+		{
+			OutBuildData.NumSavedBytes += SavedBytes;
+		}
+		if (OutBuildData.bSucceeded)
+		{
+			INC_MEMORY_STAT_BY(STAT_MeshMerge_MemoryOptimizerSavedBytes, OutBuildData.NumSavedBytes);
+		}
+		UE_CLOG(OutBuildData.bSucceeded && OutBuildData.NumSavedBytes > 0, LogMeshMerge, Verbose, TEXT("MeshMergeUtilities::BuildMergedMeshData - Memory optimizer saved %lld bytes over %d LODs"),
+			OutBuildData.NumSavedBytes, GatherData.NumLODs);
+		if (!OutBuildData.bSucceeded)
+		{
+			OutBuildData.AtlasMips.Empty();
+		}
+	}
+
+	USkeletalMesh* CreateMergedMesh(const FMeshMergeGatherData& GatherData, FMergedMeshBuildData& BuildData, USkeleton* Skeleton, USkeletalMesh* PooledMesh)
+	{
+		check(IsInGameThread());
+
+		if (!BuildData.bSucceeded || BuildData.LODs.Num() != GatherData.NumLODs || !Skeleton)
+		{
+			return nullptr;
+		}
+
+		USkeletalMesh* MergedMesh = PooledMesh ? PooledMesh : NewObject<USkeletalMesh>(GetTransientPackage(), NAME_None, RF_Transient);
+		MergedMesh->SetSkeleton(Skeleton);
+		MergedMesh->SetRefSkeleton(GatherData.RefSkeleton);
+		if (GatherData.AtlasMaterialIndex != INDEX_NONE)
+		{
+			TArray<FSkeletalMaterial> Materials = GatherData.Materials;
+			Materials[GatherData.AtlasMaterialIndex] = FSkeletalMaterial(MeshMergeAtlas::CreateAtlasMaterial(GatherData, BuildData.AtlasMips, MergedMesh));
+			MergedMesh->SetMaterials(Materials);
+		}
+		else
+		{
+			MergedMesh->SetMaterials(GatherData.Materials);
+		}
+		MergedMesh->SetHasVertexColors(BuildData.LODs[0]->StaticVertexBuffers.ColorVertexBuffer.GetNumVertices() > 0);
+		MergedMesh->ResetLODInfo();
+		MergedMesh->AllocateResourceForRendering();
+
+		// Ownership of the LOD render data goes to the mesh render data
+		FSkeletalMeshRenderData* RenderData = MergedMesh->GetResourceForRendering();
+		for (int32 LODIndex = 0; LODIndex < GatherData.NumLODs; ++LODIndex)
+		{
+			RenderData->LODRenderData.Add(BuildData.LODs[LODIndex].Release());
+			MergedMesh->AddLODInfo(GatherData.LODInfos[LODIndex]);
+		}
+		RenderData->NumInlinedLODs = static_cast<uint8>(GatherData.NumLODs);
+		RenderData->NumNonOptionalLODs = static_cast<uint8>(GatherData.NumLODs);
+		RenderData->CurrentFirstLODIdx = 0;
+		RenderData->PendingFirstLODIdx = 0;
+		BuildData.LODs.Reset();
+
+		MergedMesh->CalculateInvRefMatrices();
+		MergedMesh->SetImportedBounds(GatherData.Bounds);
+		MergedMesh->RebuildSocketMap();
+		MergedMesh->InitResources();
+
+		// Consolidated sections mix parts, their ranges can't be reused
+		if (!GatherData.bConsolidateSections)
+		{
+			UMergedMeshLayoutUserData* LayoutUserData = NewObject<UMergedMeshLayoutUserData>(MergedMesh);
+			LayoutUserData->Layout = Private::MakeMergedMeshLayout(GatherData, *RenderData);
+			MergedMesh->AddAssetUserData(LayoutUserData);
+		}
+
+		return MergedMesh;
+	}
+
+	USkeletalMesh* MergeImmediate(const TArray<FMeshToMergeData>& MeshesToMergeData, const USkeletalMesh* PreviousMergedMesh, USkeletalMesh* PooledMesh,
+		const FMeshMergePlan* Plan)
+	{
+		FMeshMergeGatherData GatherData;
+		if (!GatherMergeData(MeshesToMergeData, GatherData, PreviousMergedMesh, Plan) || !AcquireSourceCopies(GatherData))
+		{
+			return nullptr;
+		}
+
+		const FMeshToMergeData* BaseData = MeshesToMergeData.FindByPredicate([](const FMeshToMergeData& Data)
+		{
+			return IsValid(Data.SkeletalMesh);
+		});
+
+		FMergedMeshBuildData BuildData;
+		BuildMergedMeshData(GatherData, BuildData);
+		return CreateMergedMesh(GatherData, BuildData, BaseData->SkeletalMesh->GetSkeleton(), PooledMesh);
+	}
+
+	bool CanMergeIncrementally(const USkeletalMesh* PreviousMergedMesh)
+	{
+		const UCustomizationSettings* Settings = UCustomizationSettings::Get();
+		return Settings && Settings->GetEnableIncrementalMeshMerge() && UMergedMeshLayoutUserData::Find(PreviousMergedMesh) != nullptr;
+	}
+}
@@ -0,0 +1,227 @@
+#include "Utilities/MeshMerger/MeshMergeVertexCache.h"
+
+namespace MeshMergeVertexCache
+{
+	namespace Private
+	{
+		// Simulated LRU cache, scores are tuned for it rather than for a specific GPU
+		constexpr int32 MaxCacheSize = 32;
+		constexpr float CacheDecayPower = 1.5f;
+		constexpr float LastTriangleScore = 0.75f;
+		constexpr float ValenceBoostScale = 2.0f;
+		constexpr float ValenceBoostPower = 0.5f;
+
+		struct FVertexData
+		{
+			// Offset into the vertex triangle lists
+			int32 FirstTriangle = 0;
+			int32 NumActiveTriangles = 0;
+			int32 CachePosition = INDEX_NONE;
+			float Score = 0.f;
+		};
+
+		float GetVertexScore(const FVertexData& Vertex)
+		{
+			if (Vertex.NumActiveTriangles == 0)
+			{
+				return -1.f;
+			}
+
+			float Score = 0.f;
+			if (Vertex.CachePosition != INDEX_NONE)
+			{
+				// Vertices of the last triangle get a fixed score, so the next one doesn't just reuse the same edge
+				if (Vertex.CachePosition < 3)
+				{
+					Score = LastTriangleScore;
+				}
+				else
+				{
+					const float Scaler = 1.f / (MaxCacheSize - 3);
+					Score = FMath::Pow(1.f - (Vertex.CachePosition - 3) * Scaler, CacheDecayPower);
+				}
+			}
+
+			// Vertices with few triangles left are finished first, so they don't linger in the cache
+			return Score + ValenceBoostScale * FMath::Pow(static_cast<float>(Vertex.NumActiveTriangles), -ValenceBoostPower);
+		}
+	}
+
+	float ComputeACMR(TConstArrayView<uint32> Indices, int32 CacheSize)
+	{
+		const int32 NumTriangles = Indices.Num() / 3;
+		if (NumTriangles == 0 || CacheSize <= 0)
+		{
+			return 0.f;
+		}
+
+		uint32 MaxIndex = 0;
+		for (const uint32 Index : Indices)
+		{
+			MaxIndex = FMath::Max(MaxIndex, Index);
+		}
+
+		// Vertex is cached while fewer than CacheSize misses happened since it was loaded
+		TArray<int64> LoadedAtMiss;
+		LoadedAtMiss.Init(INDEX_NONE, MaxIndex + 1);
+		int64 NumMisses = 0;
+		for (const uint32 Index : Indices)
+		{
+			if (LoadedAtMiss[Index] == INDEX_NONE || NumMisses - LoadedAtMiss[Index] >= CacheSize)
+			{
+				LoadedAtMiss[Index] = NumMisses++;
+			}
+		}
+		return static_cast<float>(NumMisses) / NumTriangles;
+	}
+
+	void OptimizeTriangleOrder(TArrayView<uint32> Indices, uint32 FirstVertex, uint32 NumVertices)
+	{
+		const int32 NumTriangles = Indices.Num() / 3;
+		if (NumTriangles < 2 || NumVertices == 0)
+		{
+			return;
+		}
+
+		// 1. Triangles of every vertex
+		TArray<Private::FVertexData> Vertices;
+		Vertices.SetNum(NumVertices);
+		for (const uint32 Index : Indices)
+		{
+			// Section referencing vertices outside its range keeps its order
+			if (Index < FirstVertex || Index - FirstVertex >= NumVertices)
+			{
+				return;
+			}
+			++Vertices[Index - FirstVertex].NumActiveTriangles;
+		}
+
+		int32 NumVertexTriangles = 0;
+		for (Private::FVertexData& Vertex : Vertices)
+		{
+			Vertex.FirstTriangle = NumVertexTriangles;
+			NumVertexTriangles += Vertex.NumActiveTriangles;
+			Vertex.NumActiveTriangles = 0;
+		}
+
+		TArray<int32> VertexTriangles;
+		VertexTriangles.SetNumUninitialized(NumVertexTriangles);
+		for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+		{
+			for (int32 Corner = 0; Corner < 3; ++Corner)
+			{
+				Private::FVertexData& Vertex = Vertices[Indices[TriangleIndex * 3 + Corner] - FirstVertex];
+				VertexTriangles[Vertex.FirstTriangle + Vertex.NumActiveTriangles++] = TriangleIndex;
+			}
+		}
+
+		// 2. Initial scores
+		for (Private::FVertexData& Vertex : Vertices)
+		{
+			Vertex.Score = Private::GetVertexScore(Vertex);
+		}
+
+		TArray<float> TriangleScores;
+		TriangleScores.SetNumUninitialized(NumTriangles);
+		for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+		{
+			TriangleScores[TriangleIndex] = Vertices[Indices[TriangleIndex * 3] - FirstVertex].Score
+				+ Vertices[Indices[TriangleIndex * 3 + 1] - FirstVertex].Score
+				+ Vertices[Indices[TriangleIndex * 3 + 2] - FirstVertex].Score;
+		}
+
+		// 3. Greedily emit the best scored triangle, only triangles around cached vertices change their score
+		TBitArray<> AddedTriangles(false, NumTriangles);
+		TArray<uint32> OrderedIndices;
+		OrderedIndices.Reserve(Indices.Num());
+
+		TArray<int32, TInlineAllocator<Private::MaxCacheSize + 3>> Cache;
+		TArray<int32, TInlineAllocator<Private::MaxCacheSize + 3>> NewCache;
+
+		int32 BestTriangle = INDEX_NONE;
+		float BestScore = -1.f;
+		for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+		{
+			if (TriangleScores[TriangleIndex] > BestScore)
+			{
+				BestScore = TriangleScores[TriangleIndex];
+				BestTriangle = TriangleIndex;
+			}
+		}
+
+		int32 ScanCursor = 0;
+		while (BestTriangle != INDEX_NONE)
+		{
+			AddedTriangles[BestTriangle] = true;
+
+			// Emitted triangle goes to the front of the cache, the rest keeps its order
+			NewCache.Reset();
+			for (int32 Corner = 0; Corner < 3; ++Corner)
+			{
+				const uint32 Index = Indices[BestTriangle * 3 + Corner];
+				OrderedIndices.Add(Index);
+				NewCache.AddUnique(Index - FirstVertex);
+
+				Private::FVertexData& Vertex = Vertices[Index - FirstVertex];
+				int32* VertexTriangleList = VertexTriangles.GetData() + Vertex.FirstTriangle;
+				for (int32 ListIndex = 0; ListIndex < Vertex.NumActiveTriangles; ++ListIndex)
+				{
+					if (VertexTriangleList[ListIndex] == BestTriangle)
+					{
+						Swap(VertexTriangleList[ListIndex], VertexTriangleList[Vertex.NumActiveTriangles - 1]);
+						break;
+					}
+				}
+				--Vertex.NumActiveTriangles;
+			}
+
+			for (const int32 CachedVertex : Cache)
+			{
+				if (!NewCache.Contains(CachedVertex))
+				{
+					NewCache.Add(CachedVertex);
+				}
+			}
+
+			for (int32 CachePosition = 0; CachePosition < NewCache.Num(); ++CachePosition)
+			{
+				Vertices[NewCache[CachePosition]].CachePosition = CachePosition < Private::MaxCacheSize ? CachePosition : INDEX_NONE;
+			}
+
+			// Score changes are picked up by the triangles of every vertex that was or is in the cache
+			BestTriangle = INDEX_NONE;
+			BestScore = -1.f;
+			for (const int32 CachedVertex : NewCache)
+			{
+				Private::FVertexData& Vertex = Vertices[CachedVertex];
+				const float NewScore = Private::GetVertexScore(Vertex);
+				const float ScoreDelta = NewScore - Vertex.Score;
+				Vertex.Score = NewScore;
+
+				for (int32 ListIndex = 0; ListIndex < Vertex.NumActiveTriangles; ++ListIndex)
+				{
+					const int32 TriangleIndex = VertexTriangles[Vertex.FirstTriangle + ListIndex];
+					TriangleScores[TriangleIndex] += ScoreDelta;
+					if (TriangleScores[TriangleIndex] > BestScore)
+					{
+						BestScore = TriangleScores[TriangleIndex];
+						BestTriangle = TriangleIndex;
+					}
+				}
+			}
+
+			NewCache.SetNum(FMath::Min(NewCache.Num(), Private::MaxCacheSize), EAllowShrinking::No);
+			Swap(Cache, NewCache);
+
+			// Cache ran dry, continue with the next triangle not emitted yet
+			if (BestTriangle == INDEX_NONE)
+			{
+				ScanCursor = AddedTriangles.FindFrom(false, ScanCursor);
+				BestTriangle = ScanCursor;
+			}
+		}
+
+		check(OrderedIndices.Num() == NumTriangles * 3);
+		FMemory::Memcpy(Indices.GetData(), OrderedIndices.GetData(), OrderedIndices.Num() * sizeof(uint32));
+	}
+}
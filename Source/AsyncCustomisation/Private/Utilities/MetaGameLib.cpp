@@ -125,3 +125,25 @@ FInventoryEquippedItemData UMetaGameLib::ConvertEquippedMapCloak(const TMap<FGam
 {
 	return GetItemFromEquippedMapByTagInternal(InMap, FGameplayTag::RequestGameplayTag(FName("Slot.UI.Cloak")));
 }
+
+TMap<FGameplayTag, FName> UMetaGameLib::GetEquippedBodyPartSlugs(const FCustomizationContextData& State)
+{
+	return GetSlugsInternal(State.EquippedBodyPartsItems);
+}
+
+TMap<FGameplayTag, FName> UMetaGameLib::GetEquippedMaterialSlugs(const FCustomizationContextData& State)
+{
+	return GetSlugsInternal(State.EquippedMaterialsMap);
+}
+
+TMap<FGameplayTag, FName> UMetaGameLib::GetSlugsInternal(const TMap<FGameplayTag, FCustomizationItemHandle>& InMap)
+{
+	const FCustomizationItemRegistry& ItemRegistry = FCustomizationItemRegistry::Get();
+	TMap<FGameplayTag, FName> Slugs;
+	Slugs.Reserve(InMap.Num());
+	for (const auto& Pair : InMap)
+	{
+		Slugs.Add(Pair.Key, ItemRegistry.GetSlug(Pair.Value));
+	}
+	return Slugs;
+}
@@ -7,6 +7,8 @@
 #include "Engine/DataAsset.h"
 #include "CustomizationDataAsset.generated.h"
 
+class UStaticMesh;
+
 USTRUCT(BlueprintType)
 struct FCustomizationComplect
 {
@@ -20,6 +22,10 @@ struct FCustomizationComplect
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	FName SocketName;
+
+	// Purely cosmetic static mesh, no physics or logic. Baked into the merged mesh instead of spawning ActorClass when accessory baking is on.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TObjectPtr<UStaticMesh> RigidMesh = nullptr;
 };
 
 UCLASS(HideCategories = "CustomizationCondition")
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "NativeGameplayTags.h"
+#include "Utilities/CustomizationItemRegistry.h"
+
+class USlotMappingAsset;
+struct FCustomizationContextData;
+
+namespace CustomizationSlots
+{
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Slot);
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Slot_Item_BodySkin);
+
+	// Slot tags the table can index, one bit each in a slot mask
+	inline constexpr int32 MaxSlots = 64;
+	using FSlotMask = uint64;
+
+	template <typename FuncType>
+	void ForEachSlot(FSlotMask Mask, FuncType&& Func)
+	{
+		for (; Mask != 0; Mask &= Mask - 1)
+		{
+			Func(static_cast<int32>(FMath::CountTrailingZeros64(Mask)));
+		}
+	}
+
+	// Technical slots of each UI slot, indexed by the UI slot's index
+	using FSlotMappingMasks = TStaticArray<FSlotMask, MaxSlots>;
+
+	/**
+	 * Dense indices of every slot tag under Slot (technical Slot.Item.* and UI Slot.UI.*), compiled once from the tag tree.
+	 */
+	class ASYNCCUSTOMISATION_API FSlotTable
+	{
+	public:
+		static const FSlotTable& Get();
+
+		// INDEX_NONE for tags outside the table
+		[[nodiscard]] int32 GetSlotIndex(const FGameplayTag& SlotTag) const;
+		[[nodiscard]] const FGameplayTag& GetSlotTag(int32 SlotIndex) const { return SlotTags[SlotIndex]; }
+
+		// UI-to-technical masks of a slot mapping, compiled once per loaded mapping.
+		// UI slots mapping to a technical slot outside the table are set in OutIncompleteUISlots, their masks can't clear every slot.
+		[[nodiscard]] FSlotMappingMasks CompileSlotMapping(const USlotMappingAsset* SlotMapping, FSlotMask& OutIncompleteUISlots) const;
+
+	private:
+		void Build();
+
+		TArray<FGameplayTag> SlotTags;
+		TMap<FGameplayTag, int32> SlotTagToIndex;
+	};
+
+	/**
+	 * Equipped items of a customization context laid out by slot index, diffed slot mask by slot mask.
+	 * Kept by FCustomizationContextData next to its tag maps and written only through the context's mutators.
+	 * Written slots stay dirty until ClearDirty stamps the state as a base, copies of one base then only differ in their dirty slots.
+	 */
+	struct ASYNCCUSTOMISATION_API FSlotState
+	{
+		TStaticArray<FCustomizationItemHandle, MaxSlots> BodyParts;
+		TStaticArray<FCustomizationItemHandle, MaxSlots> Materials;
+		// Items with actors in each slot, sorted
+		TStaticArray<TArray<FCustomizationItemHandle, TInlineAllocator<2>>, MaxSlots> ActorItems;
+
+		FSlotMask BodyPartMask = 0;
+		FSlotMask MaterialMask = 0;
+		// Empty slot entries still count as occupied, the maps compare them that way
+		FSlotMask ActorMask = 0;
+		FSlotMask DirtyMask = 0;
+
+		// Base this state was copied from, 0 for none
+		uint32 BaseStamp = 0;
+
+		// Compiled from the maps and kept by mutators since. Maps filled directly, from Blueprint or by serialization, leave it unset.
+		bool bSynced = false;
+
+		// Maps hold tags outside the table, diffs of this state fall back to them
+		bool bHasUnindexedSlots = false;
+
+		void Compile(const FCustomizationContextData& Context);
+		void ClearDirty();
+
+		void SetBodyPart(const FGameplayTag& SlotTag, FCustomizationItemHandle Item);
+		void SetMaterial(const FGameplayTag& SlotTag, FCustomizationItemHandle Item);
+		void AddActorItem(const FGameplayTag& SlotTag, FCustomizationItemHandle Item);
+		void RemoveActorItem(const FGameplayTag& SlotTag, FCustomizationItemHandle Item);
+		// Marks the slot occupied even without items
+		void AddActorSlot(const FGameplayTag& SlotTag);
+		void RemoveBodyPart(const FGameplayTag& SlotTag);
+		void RemoveMaterial(const FGameplayTag& SlotTag);
+		void RemoveActorSlot(const FGameplayTag& SlotTag);
+		void RemoveAllActorSlots();
+		void RemoveAllBodyParts();
+		void RemoveAllMaterials();
+
+		[[nodiscard]] bool CanDiff(const FSlotState& Other) const
+		{
+			return bSynced && Other.bSynced && !bHasUnindexedSlots && !Other.bHasUnindexedSlots;
+		}
+
+		// Slots whose entry was added, removed or replaced
+		[[nodiscard]] FSlotMask DiffBodyParts(const FSlotState& Other) const;
+		[[nodiscard]] FSlotMask DiffMaterials(const FSlotState& Other) const;
+		[[nodiscard]] FSlotMask DiffActors(const FSlotState& Other) const;
+
+		[[nodiscard]] bool EqualSlots(const FSlotState& Other) const;
+
+	private:
+		// INDEX_NONE for tags outside the table, those set bHasUnindexedSlots
+		int32 IndexSlot(const FGameplayTag& SlotTag);
+
+		// Slots that can differ from the other state, only the dirty ones for copies of one base
+		[[nodiscard]] FSlotMask GetCandidateSlots(const FSlotState& Other) const;
+	};
+} // namespace CustomizationSlots
@@ -123,6 +123,17 @@ namespace CustomizationSlots
 			return ResultData;
 		}
 
+		// Registered items were read from the same tags at startup
+		if (const UCustomizationAssetManager* CustomizationAssetManager = UCustomizationAssetManager::GetCustomizationAssetManager())
+		{
+			if (const FCustomizationItemInfo* ItemInfo = CustomizationAssetManager->GetItemRegistry().FindBySlug(ItemSlug))
+			{
+				ResultData.ItemType = ItemInfo->ItemType;
+				ResultData.InUISlotCategoryTag = ItemInfo->UISlotCategoryTag;
+				return ResultData;
+			}
+		}
+
 		FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 		auto* AssetManager = UCustomizationAssetManager::GetCustomizationAssetManager();
 		if(!AssetManager)
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCustomizationStatePool, Log, All);
+
+struct FCustomizationContextData;
+class FInternedCustomizationState;
+
+/**
+ * Shared, immutable loadout of a committed customization state. Attached actors are stripped, so one interned state
+ * serves every character wearing the same loadout. Handles of the pool compare by pointer in O(1).
+ */
+struct ASYNCCUSTOMISATION_API FCustomizationStateHandle
+{
+	bool IsValid() const { return State.IsValid(); }
+
+	// Precomputed when interned, independent of map insertion order
+	uint32 GetHash() const { return Hash; }
+
+	// Empty state for invalid handles
+	const FCustomizationContextData& Get() const;
+
+	void Reset() { *this = FCustomizationStateHandle(); }
+
+	bool operator==(const FCustomizationStateHandle& Other) const { return State == Other.State; }
+	bool operator!=(const FCustomizationStateHandle& Other) const { return State != Other.State; }
+
+	friend uint32 GetTypeHash(const FCustomizationStateHandle& Handle) { return Handle.Hash; }
+
+private:
+	friend class FCustomizationStatePool;
+
+	TSharedPtr<const FInternedCustomizationState> State;
+	uint32 Hash = 0;
+};
+
+/**
+ * Interns customization states on the game thread. A state nobody holds any more is dropped with its last handle.
+ */
+class ASYNCCUSTOMISATION_API FCustomizationStatePool
+{
+public:
+	static FCustomizationStatePool& Get();
+
+	// Handle of the existing equal loadout, or of a new stripped copy of the state
+	FCustomizationStateHandle Intern(const FCustomizationContextData& State);
+
+	[[nodiscard]] int32 GetNumStates() const;
+
+	// Logs live states, their holders, how many interns reused a state and the memory the live states take
+	void LogStats() const;
+
+	static uint32 HashLoadout(const FCustomizationContextData& State);
+	static SIZE_T GetAllocatedSize(const FCustomizationContextData& State);
+
+private:
+	void Compact();
+
+	TMultiMap<uint32, TWeakPtr<const FInternedCustomizationState>> States;
+
+	int32 NumInternCalls = 0;
+	int32 NumReused = 0;
+};
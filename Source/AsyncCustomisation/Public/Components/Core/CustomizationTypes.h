@@ -2,11 +2,13 @@
 
 #include "BodyPartTypes.h"
 //#include "Utilities/CommonUtilities.h"
+#include "CustomizationSlotTable.h"
 #include "CustomizationSlotTypes.h"
 #include "Data.h"
 #include "GameplayTagContainer.h"
 #include "Somatotypes.h"
 #include "UObject/StrongObjectPtr.h"
+#include "Utilities/CustomizationItemRegistry.h"
 #include "CustomizationTypes.generated.h"
 
 struct FEquippedItemsInSlotInfo;
@@ -16,10 +18,10 @@ struct FEquippedItemActorsInfo
 {
 	GENERATED_BODY()
 
-	FName ItemSlug = NAME_None;
+	FCustomizationItemHandle Item;
 	TArray<TWeakObjectPtr<AActor>> ItemRelatedActors;
 
-	bool operator==(const FEquippedItemActorsInfo& Other) const { return this->ItemSlug == Other.ItemSlug; }
+	bool operator==(const FEquippedItemActorsInfo& Other) const { return this->Item == Other.Item; }
 	bool operator!=(const FEquippedItemActorsInfo& Other) const { return !(*this == Other); }
 
 	void Clear()
@@ -30,7 +32,7 @@ struct FEquippedItemActorsInfo
 			{
 				if (IsValid(ValidActor) && !ValidActor->IsGarbageEliminationEnabled())
 				{
-					// UE_LOG(LogTemp, Log, TEXT("FCustomizationContextData::ClearAttachedActors: Destroying actor %s from item %s"), *ValidActor->GetName(), *ItemInfo.ItemSlug.ToString());
+					// UE_LOG(LogTemp, Log, TEXT("FCustomizationContextData::ClearAttachedActors: Destroying actor %s from item %s"), *ValidActor->GetName(), *ItemInfo.Item.ToString());
 					ValidActor->Destroy();
 				}
 			}
@@ -62,12 +64,12 @@ struct FEquippedItemActorsInfo
 			}
 		}
 
-		return FString::Printf(TEXT("ItemSlug: %s, Actors: [%s]"), *ItemSlug.ToString(), *ActorNames);
+		return FString::Printf(TEXT("ItemSlug: %s, Actors: [%s]"), *Item.ToString(), *ActorNames);
 	}
 };
 
-bool operator==(const TMap<FGameplayTag, FName>& LHS, const TMap<FGameplayTag, FName>& RHS);
-bool operator!=(const TMap<FGameplayTag, FName>& LHS, const TMap<FGameplayTag, FName>& RHS);
+bool operator==(const TMap<FGameplayTag, FCustomizationItemHandle>& LHS, const TMap<FGameplayTag, FCustomizationItemHandle>& RHS);
+bool operator!=(const TMap<FGameplayTag, FCustomizationItemHandle>& LHS, const TMap<FGameplayTag, FCustomizationItemHandle>& RHS);
 
 bool operator==(const TMap<FGameplayTag, FEquippedItemsInSlotInfo>& LHS, const TMap<FGameplayTag, FEquippedItemsInSlotInfo>& RHS);
 bool operator!=(const TMap<FGameplayTag, FEquippedItemsInSlotInfo>& LHS, const TMap<FGameplayTag, FEquippedItemsInSlotInfo>& RHS);
@@ -147,14 +149,14 @@ public:
 	// [Body] Type of body. Base type of skeletal
 	ESomatotype Somatotype = ESomatotype::None;
 	
-	//[Materials by slot] <Slug, BodyTartType>
+	//[Materials by slot] Item handles, UMetaGameLib::GetEquippedMaterialSlugs resolves them for Blueprint
 	UPROPERTY(BlueprintReadOnly, Category = "Customization")
-	TMap<FGameplayTag, FName> EquippedMaterialsMap;
+	TMap<FGameplayTag, FCustomizationItemHandle> EquippedMaterialsMap;
 	// TMap<FName, EBodyPartType> EquippedMaterialsMap{};
 	
-	//[Body] Mapping item slug on BodyPartType
+	//[Body] Mapping item handle on body part slot, UMetaGameLib::GetEquippedBodyPartSlugs resolves them for Blueprint
 	UPROPERTY(BlueprintReadOnly, Category = "Customization")
-	TMap<FGameplayTag, FName> EquippedBodyPartsItems;
+	TMap<FGameplayTag, FCustomizationItemHandle> EquippedBodyPartsItems;
 	// TMap<FName, EBodyPartType> EquippedBodyPartsItems = {};
 	
 	//[Actors] Mapping SlotType on item id and Attached actors
@@ -166,6 +168,9 @@ public:
 	//[Skin] VFX customization
 	FCharacterVFXCustomization VFXCustomization = {};
 
+	// Dense form of the three maps, kept in step by the mutators below. Diffs and comparisons fall back to the maps while it isn't synced.
+	CustomizationSlots::FSlotState SlotState;
+
 	void ClearAttachedActors()
 	{
 		UE_LOG(LogTemp, Warning, TEXT("FCustomizationContextData::ClearAttachedActors - Clearing %d slots."), EquippedCustomizationItemActors.Num());
@@ -175,40 +180,157 @@ public:
 			SlotPair.Value.Clear();
 		}
 
-		 EquippedCustomizationItemActors.Empty();
+		SyncSlotState();
+		EquippedCustomizationItemActors.Empty();
+		SlotState.RemoveAllActorSlots();
+	}
+
+	// Compiles the slot state once for maps filled directly, mutators keep it from then on
+	void SyncSlotState()
+	{
+		if (!SlotState.bSynced)
+		{
+			SlotState.Compile(*this);
+		}
+	}
+
+	// Committed states are the base later edits are diffed against
+	void MarkSlotStateBase()
+	{
+		SyncSlotState();
+		SlotState.ClearDirty();
+	}
+
+	void SetBodyPart(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		SyncSlotState();
+		EquippedBodyPartsItems.Add(SlotTag, Item);
+		SlotState.SetBodyPart(SlotTag, Item);
+	}
+
+	bool RemoveBodyPart(const FGameplayTag& SlotTag)
+	{
+		SyncSlotState();
+		SlotState.RemoveBodyPart(SlotTag);
+		return EquippedBodyPartsItems.Remove(SlotTag) > 0;
+	}
+
+	void EmptyBodyParts()
+	{
+		SyncSlotState();
+		EquippedBodyPartsItems.Empty();
+		SlotState.RemoveAllBodyParts();
+	}
+
+	void SetMaterial(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		SyncSlotState();
+		EquippedMaterialsMap.Add(SlotTag, Item);
+		SlotState.SetMaterial(SlotTag, Item);
+	}
+
+	bool RemoveMaterial(const FGameplayTag& SlotTag, FCustomizationItemHandle* OutItem = nullptr)
+	{
+		SyncSlotState();
+		SlotState.RemoveMaterial(SlotTag);
+		return OutItem ? EquippedMaterialsMap.RemoveAndCopyValue(SlotTag, *OutItem) : EquippedMaterialsMap.Remove(SlotTag) > 0;
+	}
+
+	void SetMaterials(const TMap<FGameplayTag, FCustomizationItemHandle>& InMaterials)
+	{
+		SyncSlotState();
+		EquippedMaterialsMap = InMaterials;
+		SlotState.RemoveAllMaterials();
+		for (const auto& Pair : InMaterials)
+		{
+			SlotState.SetMaterial(Pair.Key, Pair.Value);
+		}
+	}
+
+	void SetActorSlot(const FGameplayTag& SlotTag, const FEquippedItemsInSlotInfo& SlotInfo)
+	{
+		SyncSlotState();
+		EquippedCustomizationItemActors.Emplace(SlotTag, SlotInfo);
+		SlotState.RemoveActorSlot(SlotTag);
+		SlotState.AddActorSlot(SlotTag);
+		for (const FEquippedItemActorsInfo& ActorInfo : SlotInfo.EquippedItemActors)
+		{
+			SlotState.AddActorItem(SlotTag, ActorInfo.Item);
+		}
+	}
+
+	// Slot entry goes away with its last item
+	bool RemoveActorItem(const FGameplayTag& SlotTag, FCustomizationItemHandle Item)
+	{
+		FEquippedItemsInSlotInfo* SlotInfo = EquippedCustomizationItemActors.Find(SlotTag);
+		if (!SlotInfo)
+		{
+			return false;
+		}
+
+		SyncSlotState();
+		const int32 NumRemoved = SlotInfo->EquippedItemActors.RemoveAll([Item](const FEquippedItemActorsInfo& Info) { return Info.Item == Item; });
+		SlotState.RemoveActorItem(SlotTag, Item);
+		if (SlotInfo->EquippedItemActors.IsEmpty())
+		{
+			RemoveActorSlot(SlotTag);
+			return true;
+		}
+		return NumRemoved > 0;
+	}
+
+	bool RemoveActorSlot(const FGameplayTag& SlotTag)
+	{
+		SyncSlotState();
+		SlotState.RemoveActorSlot(SlotTag);
+		return EquippedCustomizationItemActors.Remove(SlotTag) > 0;
+	}
+
+	void RemoveSlot(const FGameplayTag& SlotTag)
+	{
+		RemoveBodyPart(SlotTag);
+		RemoveMaterial(SlotTag);
+		RemoveActorSlot(SlotTag);
 	}
 	
-	TArray<FName> GetEquippedSlugs() const
+	TArray<FCustomizationItemHandle> GetEquippedItems() const
 	{
-		TArray<FName> Slugs;
+		TArray<FCustomizationItemHandle> Items;
 		for (const auto& Pair : EquippedMaterialsMap)
 		{
-			Slugs.Add(Pair.Value);
+			Items.Add(Pair.Value);
 		}
 		
-		TArray<FName> ItemBodyPartSlugs;
-		EquippedBodyPartsItems.GenerateValueArray(ItemBodyPartSlugs);
-		Slugs.Append(MoveTempIfPossible(ItemBodyPartSlugs));
+		TArray<FCustomizationItemHandle> ItemBodyParts;
+		EquippedBodyPartsItems.GenerateValueArray(ItemBodyParts);
+		Items.Append(MoveTempIfPossible(ItemBodyParts));
 
 		for (const auto& Pair : EquippedCustomizationItemActors)
 		{
 			for (const auto& ActorsInfo : Pair.Value.EquippedItemActors)
 			{
-				Slugs.Add(ActorsInfo.ItemSlug);
+				Items.Add(ActorsInfo.Item);
 			}
 		}
 
-		return Slugs;
+		return Items;
 	}
 	
 	bool operator==(const FCustomizationContextData& Other) const
 	{
-		return Somatotype == Other.Somatotype &&
-			   EquippedMaterialsMap == Other.EquippedMaterialsMap &&
+		if (Somatotype != Other.Somatotype || !(SkinVisibilityFlags == Other.SkinVisibilityFlags) || VFXCustomization != Other.VFXCustomization)
+		{
+			return false;
+		}
+
+		if (SlotState.CanDiff(Other.SlotState))
+		{
+			return SlotState.EqualSlots(Other.SlotState);
+		}
+
+		return EquippedMaterialsMap == Other.EquippedMaterialsMap &&
 			   EquippedBodyPartsItems == Other.EquippedBodyPartsItems &&
-			   EquippedCustomizationItemActors == Other.EquippedCustomizationItemActors &&
-			   SkinVisibilityFlags == Other.SkinVisibilityFlags &&
-			   VFXCustomization == Other.VFXCustomization;
+			   EquippedCustomizationItemActors == Other.EquippedCustomizationItemActors;
 	}
 
 	bool operator!=(const FCustomizationContextData& Other) const
@@ -217,12 +339,12 @@ public:
 	}
 
 	
-	void ReplaceOrAddSpawnedActors(const FName& InItemSlug, const FGameplayTag& InSlotTag, const TArray<TWeakObjectPtr<AActor>>& InActors)
+	void ReplaceOrAddSpawnedActors(FCustomizationItemHandle InItem, const FGameplayTag& InSlotTag, const TArray<TWeakObjectPtr<AActor>>& InActors)
 	{
 		if (!InSlotTag.IsValid()) return;
 		FEquippedItemsInSlotInfo& SlotInfo = EquippedCustomizationItemActors.FindOrAdd(InSlotTag);
 		FEquippedItemActorsInfo* FoundItem = SlotInfo.EquippedItemActors.FindByPredicate(
-			[&InItemSlug](const FEquippedItemActorsInfo& Info){ return Info.ItemSlug == InItemSlug; });
+			[InItem](const FEquippedItemActorsInfo& Info){ return Info.Item == InItem; });
 		
 		if (FoundItem)
 		{
@@ -230,7 +352,9 @@ public:
 		}
 		else
 		{
-			SlotInfo.EquippedItemActors.Add({InItemSlug, InActors});
+			SyncSlotState();
+			SlotInfo.EquippedItemActors.Add({InItem, InActors});
+			SlotState.AddActorItem(InSlotTag, InItem);
 		}
 	}
 
@@ -273,7 +397,7 @@ ENUM_CLASS_FLAGS(ECustomizationInvalidationReason);
 ENUM_RANGE_BY_FIRST_AND_LAST(
 	ECustomizationInvalidationReason, ECustomizationInvalidationReason::None, ECustomizationInvalidationReason::All)
 
-inline bool operator==(const TMap<FGameplayTag, FName>& LHS, const TMap<FGameplayTag, FName>& RHS)
+inline bool operator==(const TMap<FGameplayTag, FCustomizationItemHandle>& LHS, const TMap<FGameplayTag, FCustomizationItemHandle>& RHS)
 {
 	if (LHS.Num() != RHS.Num())
 	{
@@ -282,7 +406,7 @@ inline bool operator==(const TMap<FGameplayTag, FName>& LHS, const TMap<FGamepla
 
 	for (const auto& Pair : LHS)
 	{
-		const FName* RhsValue = RHS.Find(Pair.Key);
+		const FCustomizationItemHandle* RhsValue = RHS.Find(Pair.Key);
 		if (!RhsValue || *RhsValue != Pair.Value)
 		{
 			return false;
@@ -292,7 +416,7 @@ inline bool operator==(const TMap<FGameplayTag, FName>& LHS, const TMap<FGamepla
 	return true;
 }
 
-inline bool operator!=(const TMap<FGameplayTag, FName>& LHS, const TMap<FGameplayTag, FName>& RHS)
+inline bool operator!=(const TMap<FGameplayTag, FCustomizationItemHandle>& LHS, const TMap<FGameplayTag, FCustomizationItemHandle>& RHS)
 {
 	return !(LHS == RHS);
 }
@@ -398,31 +522,58 @@ void CheckDiff(const FCustomizationContextData& NewState, const FCustomizationCo
 	       OldStateToCompareAgainst.EquippedBodyPartsItems.Num(),
 	       NewState.EquippedBodyPartsItems.Num());
 
+	// Slot states kept by the mutators diff slot masks, only changed slots are walked. States filled directly walk the maps.
+	const CustomizationSlots::FSlotTable& SlotTable = CustomizationSlots::FSlotTable::Get();
+	const CustomizationSlots::FSlotState& NewSlots = NewState.SlotState;
+	const CustomizationSlots::FSlotState& OldSlots = OldStateToCompareAgainst.SlotState;
+	const bool bDenseDiff = NewSlots.CanDiff(OldSlots);
+
 	// --- Body Parts Diff ---
-	for (const auto& NewPair : NewState.EquippedBodyPartsItems)
+	if (bDenseDiff)
 	{
-		const FName* OldSlugPtr = OldStateToCompareAgainst.EquippedBodyPartsItems.Find(NewPair.Key);
-		// If slot didn't exist before, or the slug in the slot is different, it's an "add".
-		if (!OldSlugPtr || *OldSlugPtr != NewPair.Value)
+		CustomizationSlots::ForEachSlot(NewSlots.DiffBodyParts(OldSlots), [&](int32 SlotIndex)
 		{
-			Added.EquippedBodyPartsItems.Add(NewPair.Key, NewPair.Value);
-			UE_LOG(LogTemp, Warning, TEXT("CheckDiff: Added/Replaced BodyPart. Tag: %s, Slug: %s"), *NewPair.Key.ToString(), *NewPair.Value.ToString());
-		}
+			const FGameplayTag& SlotTag = SlotTable.GetSlotTag(SlotIndex);
+			const CustomizationSlots::FSlotMask SlotBit = CustomizationSlots::FSlotMask(1) << SlotIndex;
+			if (NewSlots.BodyPartMask & SlotBit)
+			{
+				Added.EquippedBodyPartsItems.Add(SlotTag, NewSlots.BodyParts[SlotIndex]);
+				UE_LOG(LogTemp, Warning, TEXT("CheckDiff: Added/Replaced BodyPart. Tag: %s, Slug: %s"), *SlotTag.ToString(), *NewSlots.BodyParts[SlotIndex].ToString());
+			}
+			if (OldSlots.BodyPartMask & SlotBit)
+			{
+				Removed.EquippedBodyPartsItems.Add(SlotTag, OldSlots.BodyParts[SlotIndex]);
+				UE_LOG(LogTemp, Warning, TEXT("CheckDiff: Removed/Replaced BodyPart. Tag: %s, Slug: %s"), *SlotTag.ToString(), *OldSlots.BodyParts[SlotIndex].ToString());
+			}
+		});
 	}
-
-	for (const auto& OldPair : OldStateToCompareAgainst.EquippedBodyPartsItems)
+	else
 	{
-		const FName* NewSlugPtr = NewState.EquippedBodyPartsItems.Find(OldPair.Key);
-		// If slot doesn't exist in the new state, or the slug is different, it's a "remove".
-		if (!NewSlugPtr || *NewSlugPtr != OldPair.Value)
+		for (const auto& NewPair : NewState.EquippedBodyPartsItems)
+		{
+			const FCustomizationItemHandle* OldItemPtr = OldStateToCompareAgainst.EquippedBodyPartsItems.Find(NewPair.Key);
+			// If slot didn't exist before, or the item in the slot is different, it's an "add".
+			if (!OldItemPtr || *OldItemPtr != NewPair.Value)
+			{
+				Added.EquippedBodyPartsItems.Add(NewPair.Key, NewPair.Value);
+				UE_LOG(LogTemp, Warning, TEXT("CheckDiff: Added/Replaced BodyPart. Tag: %s, Slug: %s"), *NewPair.Key.ToString(), *NewPair.Value.ToString());
+			}
+		}
+
+		for (const auto& OldPair : OldStateToCompareAgainst.EquippedBodyPartsItems)
 		{
-			Removed.EquippedBodyPartsItems.Add(OldPair.Key, OldPair.Value);
-			UE_LOG(LogTemp, Warning, TEXT("CheckDiff: Removed/Replaced BodyPart. Tag: %s, Slug: %s"), *OldPair.Key.ToString(), *OldPair.Value.ToString());
+			const FCustomizationItemHandle* NewItemPtr = NewState.EquippedBodyPartsItems.Find(OldPair.Key);
+			// If slot doesn't exist in the new state, or the item is different, it's a "remove".
+			if (!NewItemPtr || *NewItemPtr != OldPair.Value)
+			{
+				Removed.EquippedBodyPartsItems.Add(OldPair.Key, OldPair.Value);
+				UE_LOG(LogTemp, Warning, TEXT("CheckDiff: Removed/Replaced BodyPart. Tag: %s, Slug: %s"), *OldPair.Key.ToString(), *OldPair.Value.ToString());
+			}
 		}
 	}
 
 	// --- Attached Actors Diff ---
-	if (OldStateToCompareAgainst.EquippedCustomizationItemActors != NewState.EquippedCustomizationItemActors)
+	if (bDenseDiff ? NewSlots.DiffActors(OldSlots) != 0 : OldStateToCompareAgainst.EquippedCustomizationItemActors != NewState.EquippedCustomizationItemActors)
 	{
 		TMap<FGameplayTag, FEquippedItemsInSlotInfo> AddedActors;
 		TMap<FGameplayTag, FEquippedItemsInSlotInfo> RemovedActors;
@@ -440,7 +591,7 @@ void CheckDiff(const FCustomizationContextData& NewState, const FCustomizationCo
 				for (const auto& NewItemActorInfo : NewPair.Value.EquippedItemActors)
 				{
 					if (!OldSlotInfo->EquippedItemActors.ContainsByPredicate(
-						[&](const FEquippedItemActorsInfo& OldItem) { return OldItem.ItemSlug == NewItemActorInfo.ItemSlug; }))
+						[&](const FEquippedItemActorsInfo& OldItem) { return OldItem.Item == NewItemActorInfo.Item; }))
 					{
 						TempAddedItems.EquippedItemActors.Add(NewItemActorInfo);
 					}
@@ -461,7 +612,7 @@ void CheckDiff(const FCustomizationContextData& NewState, const FCustomizationCo
 				for (const auto& OldItemActorInfo : OldPair.Value.EquippedItemActors)
 				{
 					if (!NewSlotInfo->EquippedItemActors.ContainsByPredicate(
-						[&](const FEquippedItemActorsInfo& NewItem) { return NewItem.ItemSlug == OldItemActorInfo.ItemSlug; }))
+						[&](const FEquippedItemActorsInfo& NewItem) { return NewItem.Item == OldItemActorInfo.Item; }))
 					{
 						TempRemovedItems.EquippedItemActors.Add(OldItemActorInfo);
 					}
@@ -479,7 +630,27 @@ void CheckDiff(const FCustomizationContextData& NewState, const FCustomizationCo
 	}
 
 	// --- Materials Diff ---
-	if (OldStateToCompareAgainst.EquippedMaterialsMap != NewState.EquippedMaterialsMap)
+	if (bDenseDiff)
+	{
+		CustomizationSlots::ForEachSlot(NewSlots.DiffMaterials(OldSlots), [&](int32 SlotIndex)
+		{
+			const FGameplayTag& SlotTag = SlotTable.GetSlotTag(SlotIndex);
+			const CustomizationSlots::FSlotMask SlotBit = CustomizationSlots::FSlotMask(1) << SlotIndex;
+			if (NewSlots.MaterialMask & SlotBit)
+			{
+				Added.EquippedMaterialsMap.Add(SlotTag, NewSlots.Materials[SlotIndex]);
+			}
+			if (OldSlots.MaterialMask & SlotBit)
+			{
+				Removed.EquippedMaterialsMap.Add(SlotTag, OldSlots.Materials[SlotIndex]);
+			}
+		});
+		if (Added.EquippedMaterialsMap.Num() > 0 || Removed.EquippedMaterialsMap.Num() > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("CheckDiff: EquippedMaterialsMap changed. Added: %d, Removed: %d"), Added.EquippedMaterialsMap.Num(), Removed.EquippedMaterialsMap.Num());
+		}
+	}
+	else if (OldStateToCompareAgainst.EquippedMaterialsMap != NewState.EquippedMaterialsMap)
 	{
 		for (const auto& NewMatPair : NewState.EquippedMaterialsMap)
 		{
@@ -489,10 +660,10 @@ void CheckDiff(const FCustomizationContextData& NewState, const FCustomizationCo
 			}
 			else
 			{
-				const FName& OldSlug = OldStateToCompareAgainst.EquippedMaterialsMap.FindChecked(NewMatPair.Key);
-				if (OldSlug != NewMatPair.Value)
+				const FCustomizationItemHandle& OldItem = OldStateToCompareAgainst.EquippedMaterialsMap.FindChecked(NewMatPair.Key);
+				if (OldItem != NewMatPair.Value)
 				{
-					Removed.EquippedMaterialsMap.Add(NewMatPair.Key, OldSlug);
+					Removed.EquippedMaterialsMap.Add(NewMatPair.Key, OldItem);
 					Added.EquippedMaterialsMap.Add(NewMatPair.Key, NewMatPair.Value);
 				}
 			}
@@ -5,15 +5,21 @@
 #include "AsyncCustomisation/Public/Utilities/TimerComponent.h"
 #include "Constants/GlobalConstants.h"
 #include "Core/CharacterComponentBase.h"
+#include "Core/CustomizationSlotTable.h"
+#include "Core/CustomizationStatePool.h"
 #include "Core/CustomizationTypes.h"
+#include "Utilities/CustomizationItemRegistry.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
 #include "CustomizationComponent.generated.h"
 
 struct FGameplayTag;
+struct FCustomizationComplect;
 class UCustomizationDataAsset;
 struct FBodyPartVariant;
 class UCustomizationAssetManager;
 class USomatotypeDataAsset;
 class USlotMappingAsset;
+struct FStreamableHandle;
 DECLARE_LOG_CATEGORY_EXTERN(LogCustomizationComponent, Log, All);
 
 class UBodyPartAsset;
@@ -22,19 +28,41 @@ class UMaterialPackCustomizationDA;
 	
 struct FAttachedActorChanges
 {
-	TMap<FName, TArray<TWeakObjectPtr<AActor>>> ActorsToDestroy;
+	TMap<FCustomizationItemHandle, TArray<TWeakObjectPtr<AActor>>> ActorsToDestroy;
 	TArray<FPrimaryAssetId> AssetIdsToLoad;
-	TMap<FPrimaryAssetId, FName> AssetIdToSlugMapForLoad;
-	TMap<FName, FGameplayTag> SlugToSlotMapForLoad;
+	TMap<FPrimaryAssetId, FCustomizationItemHandle> AssetIdToItemMapForLoad;
+	TMap<FCustomizationItemHandle, FGameplayTag> ItemToSlotMapForLoad;
 };
 struct FResolvedVariantInfo
 {
-    TMap<FGameplayTag, FName> FinalSlotAssignment; 
+    TMap<FGameplayTag, FCustomizationItemHandle> FinalSlotAssignment; 
     TMap<FName, const FBodyPartVariant*> SlugToResolvedVariantMap;
 	TMap<FName, FGameplayTag> SlugToSlotTagMap;
     TArray<FName> InitialSlugsInTargetState;
 };
 
+// How bursts of equip requests are collapsed into one invalidation pipeline
+USTRUCT(BlueprintType)
+struct FInvalidationCoalescingPolicy
+{
+	GENERATED_BODY()
+
+	// Off flushes every request at the end of its frame, requests of one frame are always collapsed
+	UPROPERTY(EditAnywhere, Category = "Coalescing")
+	bool bAdaptiveWindow = true;
+
+	// Shortest quiet time that ends a burst
+	UPROPERTY(EditAnywhere, Category = "Coalescing", meta = (EditCondition = "bAdaptiveWindow", ClampMin = "0.0", Units = "s"))
+	float MinQuietSeconds = 0.05f;
+
+	// Burst ends once no request came for this many of its average request gaps
+	UPROPERTY(EditAnywhere, Category = "Coalescing", meta = (EditCondition = "bAdaptiveWindow", ClampMin = "1.0"))
+	float QuietGapMultiplier = 2.f;
+
+	// Longest a burst holds back its pipeline. A request further than this from the previous one is isolated and runs immediately
+	UPROPERTY(EditAnywhere, Category = "Coalescing", meta = (EditCondition = "bAdaptiveWindow", ClampMin = "0.0", Units = "s"))
+	float MaxLatencySeconds = 0.3f;
+};
 
 UCLASS()
 class ASYNCCUSTOMISATION_API UCustomizationComponent : public UCharacterComponentBase
@@ -57,16 +85,35 @@ public:
 	void EquipItem(const FName& ItemSlug);
 	void EquipItems(const TArray<FName>& Items);
 	void UnequipItem(const FName& ItemSlug);
+
+	// Slug overloads above convert to registry handles, the form the customization state stores
+	void EquipItem(FCustomizationItemHandle ItemHandle);
+	void EquipItems(const TArray<FCustomizationItemHandle>& ItemHandles);
+	void UnequipItem(FCustomizationItemHandle ItemHandle);
 	bool RequestUnequipSlot(const FGameplayTag& InSlotToUnequip);
 	
 	void ResetAll();
 	void HardRefreshAll();
 
+	// Merges the outfit equipping the item would result in ahead of time, EquipItem of it then gets the ready mesh
+	void RequestSpeculativeMerge(const FName& ItemSlug);
+	void DiscardSpeculativeMerges();
+
 	void SetCustomizationContext(const FCustomizationContextData& InContext);
 	
 	UFUNCTION(BlueprintPure, Category = "Customization")
 	const FCustomizationContextData& GetCurrentCustomizationState();
 
+	// Interned loadout of the current state, equal for every character wearing the same items
+	const FCustomizationStateHandle& GetCurrentLoadout() const { return CurrentLoadout; }
+
+	// Invalidations requested versus pipelines they actually ran, the gap is what coalescing and no-op diffs saved
+	UFUNCTION(BlueprintPure, Category = "Customization")
+	int32 GetNumInvalidationRequests() const { return NumInvalidationRequests; }
+
+	UFUNCTION(BlueprintPure, Category = "Customization")
+	int32 GetNumInvalidationPipelinesRun() const { return NumInvalidationPipelinesRun; }
+
 	const TMap<FGameplayTag, TObjectPtr<USkeletalMeshComponent>>& GetSpawnedMeshComponents();
 	
 	// public just cz customization utilities TODO:: fix 
@@ -86,6 +133,12 @@ protected:
 	                const bool bDeffer = true,
 	                ECustomizationInvalidationReason ExplicitReason = ECustomizationInvalidationReason::None);
 
+	// Deferred state if a burst is being collapsed, so its requests build on each other
+	const FCustomizationContextData& GetLatestTargetState() const;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Customization|Settings")
+	FInvalidationCoalescingPolicy CoalescingPolicy;
+
 	//Deffer Invalidation context
 	ECustomizationInvalidationReason DeferredReason = ECustomizationInvalidationReason::None;
 
@@ -99,6 +152,7 @@ protected:
 	void ApplyFallbackMaterialToBodySkinMesh();
 	
 	void OnDefferInvalidationTimerExpired();
+	void InvalidateImmediate(const FCustomizationContextData& TargetState, ECustomizationInvalidationReason ExplicitReason);
 
 	//Allowed only to be called in Invalidate(...) method or other Invalidate*
 	void InvalidateColoration(FCustomizationContextData& TargetState);
@@ -106,16 +160,25 @@ protected:
 	void InvalidateAttachedActors(FCustomizationContextData& TargetState);
 
 	void StartInvalidationTimer(const FCustomizationContextData& TargetState); 
+	// First request after a quiet window runs on the leading edge, only the ones following it are collapsed
+	bool TryInvalidateLeadingEdge(const FCustomizationContextData& TargetState, ECustomizationInvalidationReason ExplicitReason);
 	void CreateTimerIfNeeded();
 
+	// Steps and loads of an older pipeline carry its generation and are skipped once a newer one starts
+	[[nodiscard]] bool IsInvalidationCurrent(uint32 Generation) const { return Generation == InvalidationGeneration; }
+	void TrackInvalidationLoad(const TSharedPtr<FStreamableHandle>& LoadHandle);
+	void CancelInFlightInvalidation();
+	// Actors spawned by a superseded pipeline that the shown state doesn't reference
+	void DestroySupersededActors();
+
 	// Helpers
 
 	FAttachedActorChanges DetermineAttachedActorChanges(const FCustomizationContextData& CurrentState, const FCustomizationContextData& TargetState);
-	void DestroyAttachedActors(const TMap<FName, TArray<TWeakObjectPtr<AActor>>>& ActorsToDestroy);
+	void DestroyAttachedActors(const TMap<FCustomizationItemHandle, TArray<TWeakObjectPtr<AActor>>>& ActorsToDestroy);
 	void ResetUnusedBodyParts(const TSet<FGameplayTag>& FinalUsedSlotTags);
 	void SpawnAndAttachActorsForItem(
 		UCustomizationDataAsset* DataAsset,
-		FName ItemSlug,
+		FCustomizationItemHandle Item,
 		ABaseCharacter* CharOwner,
 		UWorld* WorldContext,
 		TArray<TWeakObjectPtr<AActor>>& OutSpawnedActorPtrs,
@@ -134,7 +197,7 @@ protected:
 
 	FResolvedVariantInfo ResolveBodyPartVariantsAndInitialAssignments(
 		const FCustomizationContextData& FullTargetContext,
-		const TArray<FName>& BodyPartSlugsToResolve,
+		const TArray<FCustomizationItemHandle>& BodyPartsToResolve,
 		const TMap<FName, UBodyPartAsset*>& SlugToAssetMap);
 
 	void ApplyBodyPartsMasterPose(
@@ -148,6 +211,43 @@ protected:
 		USomatotypeDataAsset* LoadedSomatotypeDataAsset,
 		const TArray<FName>& FinalActiveSlugs,
 		const TMap<FName, const FBodyPartVariant*>& SlugToResolvedVariantMap);
+
+	// Skin mesh with coverage of the resolved variants, then every part. False if the somatotype has no skin mesh for them.
+	bool BuildMeshesToMergeData(
+		const FCustomizationContextData& TargetStateContext,
+		USomatotypeDataAsset* LoadedSomatotypeDataAsset,
+		const TArray<FName>& FinalActiveSlugs,
+		const TMap<FName, const FBodyPartVariant*>& SlugToResolvedVariantMap,
+		TArray<FMeshToMergeData>& OutMeshesToMergeData) const;
+
+	// HeldInvalidationGeneration is set for re-merges that hold the pipeline of that generation until they complete
+	void RequestBodyPartsMerge(const TArray<FMeshToMergeData>& MeshesToMergeData, TOptional<uint32> HeldInvalidationGeneration = {});
+	// Re-merge of a skin or attachment step. Pipelines merging body parts skip it, their merge is built from the whole target state.
+	void RequestInvalidationStepMerge(const TArray<FMeshToMergeData>& MeshesToMergeData);
+	[[nodiscard]] bool IsBodyMergeInFlight() const { return EnumHasAnyFlags(InFlightInvalidationReason, ECustomizationInvalidationReason::Body); }
+
+	void RequestPredictedMerge(FCustomizationContextData& PredictedState, USomatotypeDataAsset* LoadedSomatotypeDataAsset, const TArray<UBodyPartAsset*>& LoadedBodyPartAssets);
+
+	// Skin material every part renders with, merge consolidates sections sharing one and bakes atlased ones
+	void FillMergeMaterialOverrides(const FCustomizationContextData& TargetState, TArray<FMeshToMergeData>& InOutMeshesToMergeData) const;
+
+	// Sockets equipped actors attach to, merge keeps their bones when pruning
+	void FillMergeKeptSockets(const FCustomizationContextData& TargetState, TArray<FMeshToMergeData>& InOutMeshesToMergeData) const;
+
+	// Complects baked into the merged mesh as rigid accessories instead of spawning their actors
+	bool ShouldBakeComplect(const FCustomizationComplect& Complect) const;
+	void FillMergeRigidMeshes(const FCustomizationContextData& TargetState, TArray<FMeshToMergeData>& InOutMeshesToMergeData) const;
+
+	// Merges again when the current merge pruned bones newly equipped actors attach to or misses their baked accessories.
+	// Runs inside the attached actors step and holds its pipeline until the merge completes.
+	void RefreshMergeItemAttachments(const FCustomizationContextData& TargetState);
+
+	UMaterialInterface* ResolveSlotSkinMaterial(const FCustomizationContextData& TargetState, const FGameplayTag& SlotTag) const;
+
+	// Changed parts are shown as leader pose followers and hidden in the merged mesh on display until the new one arrives.
+	// Skipped while an atlased mesh is on display, its atlas section can't be split by part.
+	void ShowMergeBridge(const FCustomizationContextData& TargetState, const TArray<FMeshToMergeData>& MeshesToMergeData);
+	void TearDownMergeBridge();
 	
 	void ApplyBodyPartMeshesAndSkin(
 		FCustomizationContextData& TargetStateContext,
@@ -170,11 +270,28 @@ protected:
 	void ProcessColoration(FCustomizationContextData& TargetStateToModify, TArray<UObject*> LoadedMaterialAssets);
 	void ApplyMergedMaterials();
 	void HandleInvalidationPipelineCompleted();
+	// Commits ProcessingTargetState as the current state and notifies listeners
+	void CommitProcessingTargetState();
+	// Every direct change of CurrentCustomizationState re-interns it, CurrentLoadout must never go stale
+	void InternCurrentLoadout();
 
 	TStrongObjectPtr<UTimerComponent> InvalidationTimer = nullptr;
+
+	// Coalescing window of deferred invalidations, in world time like the timer
+	double LastInvalidationRequestTime = -UE_BIG_NUMBER;
+	uint64 LastInvalidationRequestFrame = 0;
+	double CoalescingDeadline = 0.0;
+	float SmoothedRequestGap = 0.f;
+
+	int32 NumInvalidationRequests = 0;
+	int32 NumInvalidationPipelinesRun = 0;
 	
 	UPROPERTY()
 	FCustomizationContextData CurrentCustomizationState;
+
+	// Interned CurrentCustomizationState for listeners comparing loadouts. The pipeline states stay by value,
+	// they are edited in place and hold this character's actors
+	FCustomizationStateHandle CurrentLoadout;
 	
 	UPROPERTY()
 	FCustomizationContextData ProcessingTargetState;
@@ -193,6 +310,13 @@ protected:
 	
 	FCounterComponent PendingInvalidationCounter;
 
+	uint32 InvalidationGeneration = 0;
+
+	// Reason of the pipeline in flight, a newer one takes it over since its steps may have partly applied
+	ECustomizationInvalidationReason InFlightInvalidationReason = ECustomizationInvalidationReason::None;
+
+	TArray<TSharedPtr<FStreamableHandle>> InvalidationLoadHandles;
+
 	UPROPERTY(EditDefaultsOnly, Category = "Customization|Settings")
 	TSoftObjectPtr<USlotMappingAsset> SlotMappingAsset;
 private:
@@ -226,7 +350,7 @@ private:
 			BlockText += "-------------------";
 			return BlockText;
 		}
-		static FString FormatData(const TMap<FGameplayTag, FName>& Items)
+		static FString FormatData(const TMap<FGameplayTag, FCustomizationItemHandle>& Items)
 		{
 			FString FormattedText;
 			for (const auto& Pair : Items)
@@ -265,10 +389,16 @@ private:
 	FCustomizationDebugInfo DebugInfo;
 	FTimerHandle TimerHandle;
 
-	void AddItemToTargetState(const FName& ItemSlug, FCustomizationContextData& InOutTargetState);
+	FCustomizationItemHandle FindItemHandle(const FName& ItemSlug) const;
+	void AddItemToTargetState(FCustomizationItemHandle ItemHandle, FCustomizationContextData& InOutTargetState);
 
 	UPROPERTY()
 	TObjectPtr<USlotMappingAsset> LoadedSlotMapping = nullptr;
+
+	// Technical slots of each UI slot of the loaded mapping
+	CustomizationSlots::FSlotMappingMasks LoadedSlotMappingMasks = CustomizationSlots::FSlotMappingMasks(InPlace, 0);
+	// UI slots with technical slots outside the slot table, cleared through LoadedSlotMapping instead
+	CustomizationSlots::FSlotMask IncompleteSlotMappingUISlots = 0;
 	
 	UPROPERTY()
 	TMap<FName, FGameplayTag> SlugToSlotTagCache;
@@ -278,8 +408,35 @@ private:
 	void UpdateDebugInfo();
 	void DrawDebugTextBlock(const FVector& Location, const FString& Text, AActor* OwningActor, const FColor& Color);
 	
-	void OnMergeCompleted(USkeletalMesh* MergedMesh);
+	void OnMergeCompleted(USkeletalMesh* MergedMesh, uint32 Generation, TOptional<uint32> HeldInvalidationGeneration);
+	// Body merges complete the pipeline, step re-merges release the hold they put on it
+	void FinishMerge(TOptional<uint32> HeldInvalidationGeneration);
+
+	// Shows the mesh on the owner's main mesh, retains it and releases the replaced merged mesh
+	void SetShownMergedMesh(USkeletalMesh* MergedMesh);
 
 	UPROPERTY()
 	TMap<int32, FGameplayTag> MergedMaterialMap;
+
+	// Part set of the last merge request, re-merged when a skin change alters the consolidated layout
+	UPROPERTY()
+	TArray<FMeshToMergeData> LastMeshesToMergeData;
+
+	// Part set and material slots of the merged mesh on display
+	UPROPERTY()
+	TArray<FMeshToMergeData> ShownMeshesToMergeData;
+
+	UPROPERTY()
+	TMap<int32, FGameplayTag> ShownMaterialMap;
+
+	// Slots currently shown through follower components instead of the merged mesh
+	TSet<FGameplayTag> MergeBridgeSlots;
+
+	bool bMergeRequestPending = false;
+
+	// A step re-merge pushed PendingInvalidationCounter, newer re-merges of the same pipeline take the hold over
+	bool bStepMergeHoldsPipeline = false;
+
+	// Bumped by each merge request and body invalidation, older merge results are dropped
+	uint32 MergeGeneration = 0;
 };
\ No newline at end of file
@@ -90,7 +90,8 @@ protected:
     UFUNCTION()
     void HandleRequestColorPalette(FName ItemSlug);
     void OnMainListItemObjectSet(UUserWidget& InEntryWidget);
- //   void OnItemIsHoveredChanged(UObject* InEntryWidget, bool InIsHovered);
+    void OnItemIsHoveredChanged(UObject* ItemObject, bool bIsHovered);
+    void OnListItemSelectionChanged(UObject* ItemObject);
 
     void OnPaletteItemClicked(UObject* Item);
 
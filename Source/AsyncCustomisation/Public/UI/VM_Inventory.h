@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "MVVMViewModelBase.h"
+#include "Components/Core/CustomizationStatePool.h"
 #include "Components/Core/CustomizationTypes.h"
 #include "VM_Inventory.generated.h"
 
@@ -170,6 +171,13 @@ protected:
     UFUNCTION(BlueprintCallable, Category = "ViewModel|Actions")
     void OnEntryItemClicked(const FName& InItemSlug);
 
+    // Hovered or selected entry, its outfit is merged ahead in case it gets equipped
+    UFUNCTION(BlueprintCallable, Category = "ViewModel|Actions")
+    void OnEntryItemPreviewed(const FName& InItemSlug);
+
+    UFUNCTION(BlueprintCallable, Category = "ViewModel|Actions")
+    void ClearItemPreviews();
+
     UFUNCTION(BlueprintCallable, Category = "ViewModel|Actions")
     void RequestUnequipSlot(FGameplayTag SlotToUnequip);
 
@@ -232,8 +240,8 @@ protected:
     UPROPERTY(Transient)
 	TMap<FPrimaryAssetId, int32> LastKnownOwnedItems;
 
-    UPROPERTY(Transient)
-    FCustomizationContextData LastKnownCustomizationState;
+    // Interned, compared by pointer on refresh
+    FCustomizationStateHandle LastKnownCustomizationState;
 
     virtual void BeginDestroy() override;
 
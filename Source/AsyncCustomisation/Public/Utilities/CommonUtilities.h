@@ -14,6 +14,17 @@ namespace CommonUtilities
 	inline FPrimaryAssetId ItemSlugToCustomizationAssetId(const FName& InSlug)
 	{
 		UAssetManager& AssetManager = UAssetManager::Get();
+
+		// 0. Registered items resolve from their registry tags without loading the meta asset
+		if (const UCustomizationAssetManager* CustomizationAssetManager = Cast<UCustomizationAssetManager>(&AssetManager))
+		{
+			const FCustomizationItemInfo* ItemInfo = CustomizationAssetManager->GetItemRegistry().FindBySlug(InSlug);
+			if (ItemInfo && ItemInfo->CustomizationAssetId.IsValid())
+			{
+				return ItemInfo->CustomizationAssetId;
+			}
+		}
+
 		UObject* FoundObject = nullptr;
 
 		// 1. Find or load asset if it is base item type
@@ -66,6 +77,16 @@ namespace CommonUtilities
 		return FPrimaryAssetId();
 	}
 
+	inline FPrimaryAssetId ItemHandleToCustomizationAssetId(FCustomizationItemHandle InHandle)
+	{
+		const FCustomizationItemInfo* ItemInfo = UCustomizationAssetManager::GetCustomizationAssetManager()->GetItemRegistry().Find(InHandle);
+		if (!ItemInfo)
+		{
+			return FPrimaryAssetId();
+		}
+		return ItemInfo->CustomizationAssetId.IsValid() ? ItemInfo->CustomizationAssetId : ItemSlugToCustomizationAssetId(ItemInfo->Slug);
+	}
+
 	inline FPrimaryAssetId ItemSlugToAssetId(const FName& InSlug)
 	{
 		FPrimaryAssetId AssetId = {};
@@ -14,6 +14,11 @@ public:
 	void Push();
 	void Pop();
 
+	// Drops every pending push without triggering, pops of the dropped ones must not follow
+	void Reset() { Counter = 0; }
+
+	bool IsPending() const { return Counter > 0; }
+
 private:
 	uint64 Counter = 0;
 };
@@ -4,6 +4,7 @@
 
 #include "Engine/AssetManager.h"
 #include "Utilities/Cache.h"
+#include "Utilities/CustomizationItemRegistry.h"
 #include "CustomizationAssetManager.generated.h"
 
 struct FGameplayTag;
@@ -33,6 +34,12 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	static UCustomizationAssetManager* GetCustomizationAssetManager();
 
+	virtual void PostInitialAssetScan() override;
+	virtual void BeginDestroy() override;
+
+	// In the editor the registry is rebuilt on the first lookup after an item meta asset was added, saved, renamed or removed
+	const FCustomizationItemRegistry& GetItemRegistry() const;
+
 
 	virtual UBodyPartAsset* LoadBodyPartAssetSync(FPrimaryAssetId InBodyPartId);
 	virtual void LoadBodyPartAssetAsync(FPrimaryAssetId InBodyPartId, FOnBodyPartLoaded OnLoadDelegate);
@@ -117,15 +124,16 @@ public:
 		return Result;
 	}
 
+	// Returned handle is only valid while the load is in flight, cancelling it drops the callback
 	template <typename TAssetType>
-	void AsyncLoadAssetList(const TArray<FPrimaryAssetId>& AssetIds, TFunction<void(TArray<TAssetType*>)>&& Callback)
+	TSharedPtr<FStreamableHandle> AsyncLoadAssetList(const TArray<FPrimaryAssetId>& AssetIds, TFunction<void(TArray<TAssetType*>)>&& Callback)
 	{
 		static_assert(TIsDerivedFrom<TAssetType, UPrimaryDataAsset>::Value, "TAssetType should be derived from UPrimaryDataAsset.");
 		auto CallbackLambda = [this, AssetIds, Callback = MoveTemp(Callback)]() {
 			TArray<TAssetType*> Assets = GetAssetsListFromAssetIds<TAssetType>(AssetIds);
 			Callback(MoveTemp(Assets));
 		};
-		AsyncLoadAssetsInternal(AssetIds, MoveTemp(CallbackLambda));
+		return AsyncLoadAssetsInternal(AssetIds, MoveTemp(CallbackLambda));
 	}
 
 	template <typename TAssetType>
@@ -140,11 +148,11 @@ public:
 	}
 
 	template <typename TAssetType>
-	static void StaticAsyncLoadAssetList(const TArray<FPrimaryAssetId>& AssetIds, TFunction<void(TArray<TAssetType*>)>&& Callback)
+	static TSharedPtr<FStreamableHandle> StaticAsyncLoadAssetList(const TArray<FPrimaryAssetId>& AssetIds, TFunction<void(TArray<TAssetType*>)>&& Callback)
 	{
 		auto* AssetManager = GetCustomizationAssetManager();
 		ensure(AssetManager);
-		AssetManager->AsyncLoadAssetList<TAssetType>(AssetIds, MoveTemp(Callback));
+		return AssetManager->AsyncLoadAssetList<TAssetType>(AssetIds, MoveTemp(Callback));
 	}
 
 	template <typename TAssetType>
@@ -172,7 +180,7 @@ public:
 		AsyncLoadAssetsInternal(AssetIds, MoveTemp(CallbackLambda));
 	}
 
-	template <typename TAssetType> void AsyncLoadAsset(const FPrimaryAssetId& AssetId, TFunction<void(TAssetType*)>&& Callback)
+	template <typename TAssetType> TSharedPtr<FStreamableHandle> AsyncLoadAsset(const FPrimaryAssetId& AssetId, TFunction<void(TAssetType*)>&& Callback)
 	{
 		static_assert(TIsDerivedFrom<TAssetType, UPrimaryDataAsset>::Value, "TAssetType should be derived from UPrimaryDataAsset.");
 		auto CallbackLambda = [this, AssetId, Callback = MoveTemp(Callback)]() {
@@ -185,7 +193,7 @@ public:
 			TAssetType* Asset = !Assets.IsEmpty() ? Assets[0] : nullptr;
 			Callback(MoveTemp(Asset));
 		};
-		AsyncLoadAssetsInternal({ AssetId }, MoveTemp(CallbackLambda));
+		return AsyncLoadAssetsInternal({ AssetId }, MoveTemp(CallbackLambda));
 	}
 
 	template <typename TAssetType> void SyncLoadAsset(const FPrimaryAssetId& AssetId, TFunction<void(TAssetType*)>&& Callback)
@@ -204,11 +212,11 @@ public:
 		SyncLoadAssetsInternal({ AssetId }, MoveTemp(CallbackLambda));
 	}
 
-	template <typename TAssetType> static void StaticAsyncLoadAsset(const FPrimaryAssetId& AssetId, TFunction<void(TAssetType*)>&& Callback)
+	template <typename TAssetType> static TSharedPtr<FStreamableHandle> StaticAsyncLoadAsset(const FPrimaryAssetId& AssetId, TFunction<void(TAssetType*)>&& Callback)
 	{
 		auto* AssetManager = GetCustomizationAssetManager();
 		ensure(AssetManager);
-		AssetManager->AsyncLoadAsset<TAssetType>(AssetId, MoveTemp(Callback));
+		return AssetManager->AsyncLoadAsset<TAssetType>(AssetId, MoveTemp(Callback));
 	}
 
 	template <typename TAssetType> static void StaticSyncLoadAsset(const FPrimaryAssetId& AssetId, TFunction<void(TAssetType*)>&& Callback)
@@ -276,24 +284,34 @@ protected:
 	void OnMaterialPackCustomizationAssetLoaded(TSharedPtr<FStreamableHandle> LoadHandle, FOnMaterialPackLoaded DelegateToCall) const;
 
 private:
-	template <typename TCallbackType> void AsyncLoadAssetsInternal(const TArray<FPrimaryAssetId>& AssetIds, TCallbackType&& Callback)
+	mutable FCustomizationItemRegistry ItemRegistry;
+
+#if WITH_EDITOR
+	void OnItemAssetChanged(const FAssetData& AssetData);
+	void OnItemAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath) { OnItemAssetChanged(AssetData); }
+
+	mutable bool bItemRegistryDirty = false;
+#endif
+
+	template <typename TCallbackType> TSharedPtr<FStreamableHandle> AsyncLoadAssetsInternal(const TArray<FPrimaryAssetId>& AssetIds, TCallbackType&& Callback)
 	{
 		const TSharedPtr<FStreamableHandle> LoadHandle = LoadPrimaryAssets(AssetIds, TArray<FName>());
 		if (!LoadHandle.IsValid())
 		{
 			Callback();
-			return;
+			return nullptr;
 		}
 
 		if (LoadHandle->HasLoadCompleted())
 		{
 			Callback();
-			return;
+			return nullptr;
 		}
 
 		FStreamableDelegate OnLoadDelegate;
 		OnLoadDelegate.BindLambda(Forward<TCallbackType>(Callback));
 		LoadHandle->BindCompleteDelegate(OnLoadDelegate);
+		return LoadHandle;
 	}
 
 	template <typename TCallbackType> void SyncLoadAssetsInternal(const TArray<FPrimaryAssetId>& AssetIds, TCallbackType&& Callback)
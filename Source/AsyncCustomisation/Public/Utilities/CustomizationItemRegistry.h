@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Components/Core/Data.h"
+#include "CustomizationItemRegistry.generated.h"
+
+class UAssetManager;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCustomizationItemRegistry, Log, All);
+
+// Compact handle of a registered item, what customization states store instead of slugs. 0 is invalid
+USTRUCT(BlueprintType)
+struct ASYNCCUSTOMISATION_API FCustomizationItemHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint32 Value = 0;
+
+	FCustomizationItemHandle() = default;
+	explicit FCustomizationItemHandle(uint32 InValue) : Value(InValue) {}
+
+	bool IsValid() const { return Value != 0; }
+
+	// Slug of the item, for logs
+	FString ToString() const;
+
+	bool operator==(const FCustomizationItemHandle& Other) const { return Value == Other.Value; }
+	bool operator!=(const FCustomizationItemHandle& Other) const { return Value != Other.Value; }
+	bool operator<(const FCustomizationItemHandle& Other) const { return Value < Other.Value; }
+
+	friend uint32 GetTypeHash(const FCustomizationItemHandle& Handle) { return Handle.Value; }
+};
+
+// Everything the pipeline resolves per item, read from asset registry tags without loading the meta asset
+struct FCustomizationItemInfo
+{
+	FName Slug = NAME_None;
+	FPrimaryAssetId MetaAssetId;
+	FPrimaryAssetId CustomizationAssetId;
+	FGameplayTag UISlotCategoryTag;
+	EItemType ItemType = EItemType::None;
+};
+
+/**
+ * Every item meta asset mapped to a 32-bit handle. Built by the asset manager after its initial scan and, in the editor,
+ * again after item meta assets change. Rebuilds keep the handles of known slugs, so states holding them stay valid.
+ */
+class ASYNCCUSTOMISATION_API FCustomizationItemRegistry
+{
+public:
+	// Registry of the customization asset manager
+	static const FCustomizationItemRegistry& Get();
+
+	void Build(const UAssetManager& AssetManager);
+
+	[[nodiscard]] bool IsBuilt() const { return !Items.IsEmpty(); }
+	[[nodiscard]] int32 Num() const { return Items.Num(); }
+
+	[[nodiscard]] FCustomizationItemHandle FindHandle(const FName& Slug) const;
+
+	// nullptr for invalid or stale handles
+	[[nodiscard]] const FCustomizationItemInfo* Find(FCustomizationItemHandle Handle) const
+	{
+		return Handle.IsValid() && Items.IsValidIndex(Handle.Value - 1) ? &Items[Handle.Value - 1] : nullptr;
+	}
+
+	[[nodiscard]] FName GetSlug(FCustomizationItemHandle Handle) const
+	{
+		const FCustomizationItemInfo* Info = Find(Handle);
+		return Info ? Info->Slug : NAME_None;
+	}
+
+	[[nodiscard]] const FCustomizationItemInfo* FindBySlug(const FName& Slug) const { return Find(FindHandle(Slug)); }
+
+private:
+	TArray<FCustomizationItemInfo> Items;
+	TMap<FName, uint32> SlugToHandle;
+};
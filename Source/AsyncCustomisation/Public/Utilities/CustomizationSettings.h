@@ -4,6 +4,9 @@
 #include "Engine/DeveloperSettings.h"
 #include "CustomizationSettings.generated.h"
 
+class UMaterialInterface;
+class UMeshMergePrebakeManifest;
+
 UENUM(BlueprintType)
 enum class EMeshMergeMethod : uint8
 {
@@ -11,8 +14,8 @@ enum class EMeshMergeMethod : uint8
 	MasterPose UMETA(DisplayName = "Master Pose"),
 	SyncMeshMerge UMETA(DisplayName = "Synch Skeletal Mesh Merge"),
 
-	// /** Three-phase asynchronous merger*/
-	// AsyncMeshMerge UMETA(DisplayName = "Three-Phase Async Mesh Merge")
+	/** Three-phase asynchronous merger*/
+	AsyncMeshMerge UMETA(DisplayName = "Three-Phase Async Mesh Merge")
 };
 
 UCLASS(Config = Game, defaultconfig, meta = (DisplayName = "Customization Settings"))
@@ -31,6 +34,135 @@ protected:
 		meta = (DisplayName = "Mesh Merge Method", 
 		       ToolTip = "Choose method how customization will be working."))
 	EMeshMergeMethod MeshMergeMethod = EMeshMergeMethod::SyncMeshMerge;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ClampMin = "0.0", Units = "Milliseconds",
+		       ToolTip = "Game thread time per frame spent on queued merge jobs. 0 runs every merge right away."))
+	float MeshMergeFrameBudgetMs = 2.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Show changed parts as Master Pose followers until their merged mesh arrives. Hides merge latency on equip."))
+	bool bBridgePendingMergeWithMasterPose = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Merge sections of parts that end up with the same material after skins are applied. Fewer draw calls, but skin changes may need a new merge."))
+	bool bConsolidateMergedMaterials = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Drop body skin triangles of regions covered by equipped parts. Regions are authored with Skin Coverage user data on the skin mesh."))
+	bool bCullCoveredSkin = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Pack base textures of part materials into one atlas and render them with one material instance. Packed on CPU, UVs outside 0-1 are clamped."))
+	bool bAtlasMergedMaterials = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bAtlasMergedMaterials",
+		       ToolTip = "Base material part materials need to be atlased, samples Atlas Texture Parameter Name with UV0. Only instances sharing parent, static switches and every other parameter value are packed together, the atlas instance is created from the first of them."))
+	TSoftObjectPtr<UMaterialInterface> AtlasParentMaterial;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bAtlasMergedMaterials",
+		       ToolTip = "Texture parameter read from part materials and set on the atlas material instance."))
+	FName AtlasTextureParameterName = TEXT("BaseColor");
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bAtlasMergedMaterials", ClampMin = "64", ClampMax = "8192",
+		       ToolTip = "Largest atlas side. Textures that don't fit keep their own material."))
+	int32 MaxAtlasSize = 2048;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bAtlasMergedMaterials", ClampMin = "4", ClampMax = "8192",
+		       ToolTip = "Largest tile side. Each texture is packed with its first mip not larger than this."))
+	int32 MaxAtlasTileSize = 512;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Copy parts unchanged since the previous merge of the character from its merged mesh instead of rebuilding them. Needs CPU access on merged LODs."))
+	bool bEnableIncrementalMeshMerge = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Synchronous merges use the native kernel whenever it can read every part. FSkeletalMeshMerge is kept for parts without CPU access or with mixed skeletons. Compare both with MeshMerge.Benchmark."))
+	bool bUseNativeMergeKernel = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Build every merged LOD and the atlas on its own worker task, joined before the mesh is created."))
+	bool bBuildMergedLODsInParallel = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Reorder triangles of every merged section for the post-transform vertex cache on the merge worker. ACMR before and after is logged with LogMeshMerge Verbose."))
+	bool bOptimizeMergedVertexCache = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Strip UV channels and vertex colors merged materials don't read and store UVs in half precision where the error allows. Material usage is analyzed in editor builds and prebakes, cooked runtime merges keep every channel. Bytes saved are logged with LogMeshMerge Verbose."))
+	bool bOptimizeMergedMeshMemory = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bOptimizeMergedMeshMemory", ClampMin = "0",
+		       ToolTip = "Largest UV error half precision may add. LOD keeps full precision UVs if any UV exceeds it, 0 always keeps source precision. 0.000244 holds every UV in 0-1."))
+	float MaxHalfPrecisionUVError = 0.000244f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Merge source parts without 'Allow CPU Access'. Their vertex data is read back from the GPU for the merge, which blocks the game thread on a render flush, and released afterwards. Unavailable on OpenGL and mobile feature levels, parts there need 'Allow CPU Access'."))
+	bool bUseTransientSourceCopies = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bUseTransientSourceCopies", ClampMin = "0",
+		       ToolTip = "Megabytes of read back source data kept for later merges. 0 releases it as soon as merges finish."))
+	int32 SourceScratchPoolBudgetMB = 32;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Outfits baked by the MeshMergePrebake commandlet. Part sets matching a baked one load its mesh instead of merging. Add the manifest to the assets to cook."))
+	TSoftObjectPtr<UMeshMergePrebakeManifest> PrebakeManifest;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Drop bones no merged part is skinned to. Their parents and bones of sockets equipped actors attach to are kept. Master Pose followers of pruned bones stay in ref pose."))
+	bool bPruneMergedBones = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Bake complects with a Rigid Mesh into the merged mesh, skinned to their socket bone, instead of spawning their actors. Rigid meshes need 'Allow CPU Access'."))
+	bool bBakeRigidAccessories = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ClampMin = "0",
+		       ToolTip = "Number of replaced merged meshes kept for reuse by later merges. Their render resources are released right away."))
+	int32 MeshMergePoolSize = 8;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ClampMin = "0",
+		       ToolTip = "Number of compiled merge plans kept. A plan holds merged skeleton and bone remaps of one part set, merges that only change skins reuse it. Outlives the merged mesh."))
+	int32 MaxCachedMergePlans = 64;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Reuse merged meshes for identical part sets."))
+	bool bEnableMeshMergeCache = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bEnableMeshMergeCache", ClampMin = "0", Units = "Megabytes",
+		       ToolTip = "Memory budget of cached merged meshes. Least recently used meshes are evicted above it."))
+	int32 MeshMergeCacheBudgetMB = 256;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Store merged meshes under Saved/MeshMergeCache and reuse them across sessions."))
+	bool bEnableMeshMergeDiskCache = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bEnableMeshMergeDiskCache", ClampMin = "0",
+		       ToolTip = "Number of merged meshes kept on disk. Least recently used ones are removed on startup."))
+	int32 MeshMergeDiskCacheMaxEntries = 256;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (ToolTip = "Merge the outfit an item hovered in the inventory would result in at low priority, so equipping it hands out a ready mesh. Hit rate is logged by MeshMerge.SpeculationStats."))
+	bool bEnableSpeculativeMerges = false;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bEnableSpeculativeMerges", ClampMin = "0", Units = "Megabytes",
+		       ToolTip = "Memory budget of merged meshes nobody has equipped yet. Oldest speculations are discarded above it."))
+	int32 SpeculativeMergeBudgetMB = 32;
+
+	UPROPERTY(config, EditAnywhere, Category = "Customization Settings|Mesh Merge",
+		meta = (EditCondition = "bEnableSpeculativeMerges", ClampMin = "0", Units = "Seconds",
+		       ToolTip = "Speculation not hovered again or equipped within this time is discarded."))
+	float SpeculativeMergeLifetimeSeconds = 20.f;
 	
 public:
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "Customization Settings"))
@@ -39,5 +171,34 @@ public:
 
 	[[nodiscard]] bool GetEnableDebug() const;
 	[[nodiscard]] EMeshMergeMethod GetMeshMergeMethod() const;
+	[[nodiscard]] float GetMeshMergeFrameBudgetMs() const;
+	[[nodiscard]] bool GetBridgePendingMergeWithMasterPose() const;
+	[[nodiscard]] bool GetConsolidateMergedMaterials() const;
+	[[nodiscard]] bool GetCullCoveredSkin() const;
+	[[nodiscard]] bool GetAtlasMergedMaterials() const;
+	[[nodiscard]] UMaterialInterface* GetAtlasParentMaterial() const;
+	[[nodiscard]] FName GetAtlasTextureParameterName() const;
+	[[nodiscard]] int32 GetMaxAtlasSize() const;
+	[[nodiscard]] int32 GetMaxAtlasTileSize() const;
+	[[nodiscard]] bool GetEnableIncrementalMeshMerge() const;
+	[[nodiscard]] bool GetUseNativeMergeKernel() const;
+	[[nodiscard]] bool GetBuildMergedLODsInParallel() const;
+	[[nodiscard]] bool GetOptimizeMergedVertexCache() const;
+	[[nodiscard]] bool GetOptimizeMergedMeshMemory() const;
+	[[nodiscard]] float GetMaxHalfPrecisionUVError() const;
+	[[nodiscard]] bool GetUseTransientSourceCopies() const;
+	[[nodiscard]] int32 GetSourceScratchPoolBudgetMB() const;
+	[[nodiscard]] UMeshMergePrebakeManifest* GetPrebakeManifest() const;
+	[[nodiscard]] bool GetPruneMergedBones() const;
+	[[nodiscard]] bool GetBakeRigidAccessories() const;
+	[[nodiscard]] int32 GetMeshMergePoolSize() const;
+	[[nodiscard]] int32 GetMaxCachedMergePlans() const;
+	[[nodiscard]] bool GetEnableMeshMergeCache() const;
+	[[nodiscard]] int64 GetMeshMergeCacheBudgetBytes() const;
+	[[nodiscard]] bool GetEnableMeshMergeDiskCache() const;
+	[[nodiscard]] int32 GetMeshMergeDiskCacheMaxEntries() const;
+	[[nodiscard]] bool GetEnableSpeculativeMerges() const;
+	[[nodiscard]] int64 GetSpeculativeMergeBudgetBytes() const;
+	[[nodiscard]] float GetSpeculativeMergeLifetimeSeconds() const;
 	void Clear();
 };
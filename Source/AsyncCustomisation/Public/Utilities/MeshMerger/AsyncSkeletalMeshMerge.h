@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+#include "AsyncSkeletalMeshMerge.generated.h"
+
+/**
+ * Three-phase skeletal mesh merge:
+ * 1. Game thread - gather source render data, merged ref skeleton and materials
+ * 2. Worker      - build merged vertex, index and skin weight buffers
+ * 3. Game thread - create merged USkeletalMesh and its render resources
+ * Owned and polled by UMeshMergeSubsystem.
+ */
+UCLASS()
+class ASYNCCUSTOMISATION_API UAsyncSkeletalMeshMerge : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Runs phase 1 and launches phase 2. On failure completion delegate is executed with nullptr right away.
+	bool Start(const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& InOnMeshMergeComplete, const USkeletalMesh* InPreviousMergedMesh = nullptr,
+		const FMeshMergePlan* Plan = nullptr);
+
+	// Runs phase 3 once the worker is done. Returns true when merge is over and the object can be dropped.
+	bool TryFinish();
+
+	// Waits for the worker and drops the result. Completion delegate is executed with nullptr, so waiters never hang.
+	void Cancel();
+
+	bool IsBuildCompleted() const { return BuildTask.IsCompleted(); }
+
+	// Worker may still read buffers of this mesh
+	bool IsReadingMesh(const USkeletalMesh* Mesh) const { return Mesh && PreviousMergedMesh == Mesh; }
+
+private:
+	void Complete(USkeletalMesh* MergedMesh);
+
+	// Source meshes must outlive the worker reading their render data
+	UPROPERTY()
+	TArray<TObjectPtr<USkeletalMesh>> SourceMeshes;
+
+	UPROPERTY()
+	TObjectPtr<USkeleton> Skeleton = nullptr;
+
+	// Worker reads atlas entry mips from their platform data
+	UPROPERTY()
+	TArray<TObjectPtr<UTexture2D>> AtlasTextures;
+
+	// Worker copies unchanged parts from its buffers
+	UPROPERTY()
+	TObjectPtr<USkeletalMesh> PreviousMergedMesh = nullptr;
+
+	TSharedPtr<FMeshMergeGatherData, ESPMode::ThreadSafe> GatherData;
+	TSharedPtr<FMergedMeshBuildData, ESPMode::ThreadSafe> BuildData;
+
+	UE::Tasks::FTask BuildTask;
+
+	FOnMeshMergeCompleteDelegate OnMeshMergeComplete;
+
+	double StartTime = 0.0;
+};
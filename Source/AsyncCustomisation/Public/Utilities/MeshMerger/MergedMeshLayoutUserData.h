@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+#include "MergedMeshLayoutUserData.generated.h"
+
+/**
+ * Part layout attached to a merged mesh, lives and dies with it.
+ * Next merge of the same character reads it to copy unchanged parts instead of rebuilding them.
+ */
+UCLASS()
+class ASYNCCUSTOMISATION_API UMergedMeshLayoutUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	static const UMergedMeshLayoutUserData* Find(const USkeletalMesh* MergedMesh)
+	{
+		return MergedMesh ? const_cast<USkeletalMesh*>(MergedMesh)->GetAssetUserData<UMergedMeshLayoutUserData>() : nullptr;
+	}
+
+	TSharedPtr<const FMergedMeshLayout, ESPMode::ThreadSafe> Layout;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+
+struct FMeshToMergeData;
+class USkeletalMesh;
+
+/**
+ * Base textures of part materials packed into one texture, so the merged mesh renders them with a single material instance.
+ * Tiles are copied as compressed blocks, all packed textures share one pixel format.
+ */
+namespace MeshMergeAtlas
+{
+	// [Game thread] Atlas of the resolved part materials, empty if fewer than two textures fit. Only instances of the atlas parent that differ
+	// from the first one in nothing but the atlas texture, and whose parts keep UV0 in 0-1, are packed. Plans are cached by those materials.
+	void PlanAtlas(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergeAtlasPlan& OutPlan);
+
+	// [Any thread] Reads entry mips and copies them into their tiles of every atlas mip
+	bool BuildAtlasData(const FMeshMergeGatherData& GatherData, TArray<TArray64<uint8>>& OutAtlasMips);
+
+	// [Game thread] Transient atlas texture and the material instance sampling it, atlas mips are consumed
+	UMaterialInterface* CreateAtlasMaterial(const FMeshMergeGatherData& GatherData, TArray<TArray64<uint8>>& AtlasMips, USkeletalMesh* MergedMesh);
+}
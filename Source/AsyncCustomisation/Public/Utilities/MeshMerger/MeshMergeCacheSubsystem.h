@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "MeshMergeCacheSubsystem.generated.h"
+
+USTRUCT()
+struct FMergedMeshCacheEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<USkeletalMesh> Mesh = nullptr;
+
+	int64 SizeBytes = 0;
+
+	// Value of the access counter at the last hit, smallest one is evicted first
+	uint64 LastAccess = 0;
+};
+
+/**
+ * Merged meshes keyed by normalized part set. Lives in game instance to survive map travel.
+ * Identical part sets requested while the merge is still running share the one result.
+ */
+UCLASS()
+class ASYNCCUSTOMISATION_API UMeshMergeCacheSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UMeshMergeCacheSubsystem* Get(const UWorld* World);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Returns cached mesh and marks it as recently used
+	USkeletalMesh* FindMesh(const FSkeletalMeshArrayKey& Key);
+
+	// Returns true if merge of this part set is already running, delegate is queued then and will be executed on its completion.
+	// Otherwise registers the delegate as the first waiter, caller has to start the merge with MakeMergeCompleteDelegate.
+	bool AddPendingRequest(const FSkeletalMeshArrayKey& Key, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete);
+
+	// Delegate for the merge started after AddPendingRequest, stores the result and notifies every waiter
+	FOnMeshMergeCompleteDelegate MakeMergeCompleteDelegate(const FSkeletalMeshArrayKey& Key);
+
+	void Clear();
+
+	// Stored meshes only, results still on their way to dedup waiters are not tracked here
+	bool ContainsMesh(const USkeletalMesh* Mesh) const;
+
+	[[nodiscard]] int64 GetCachedBytes() const { return CachedBytes; }
+	[[nodiscard]] int32 GetNumCachedMeshes() const { return CachedMeshes.Num(); }
+
+private:
+	void OnMergeCompleted(USkeletalMesh* MergedMesh, FSkeletalMeshArrayKey Key);
+
+	void AddMesh(const FSkeletalMeshArrayKey& Key, USkeletalMesh* MergedMesh);
+
+	void EvictToBudget(int64 BudgetBytes);
+
+	UPROPERTY()
+	TMap<FSkeletalMeshArrayKey, FMergedMeshCacheEntry> CachedMeshes;
+
+	TMap<FSkeletalMeshArrayKey, TArray<FOnMeshMergeCompleteDelegate>> PendingRequests;
+
+	int64 CachedBytes = 0;
+
+	uint64 AccessCounter = 0;
+};
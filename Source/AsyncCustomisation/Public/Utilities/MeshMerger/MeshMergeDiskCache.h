@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+
+/**
+ * Merged LOD buffers stored under Saved/MeshMergeCache, one file per fingerprint.
+ * Fingerprint covers source packages, their versions and resident geometry, so any source change maps to another file.
+ */
+namespace MeshMergeDiskCache
+{
+	FString GetCacheDirectory();
+
+	// [Game thread] Empty if disk cache is disabled in settings
+	FString MakeFingerprint(const FMeshMergeGatherData& GatherData);
+
+	// [Any thread] Entry file exists, Load may still drop it as stale
+	bool Contains(const FString& Fingerprint);
+
+	// [Any thread] Reads merged LODs, fails on missing, stale or corrupted entry
+	bool Load(const FMeshMergeGatherData& GatherData, FMergedMeshBuildData& OutBuildData);
+
+	// [Any thread] Must be called before the LODs are handed over to the merged mesh
+	bool Save(const FMeshMergeGatherData& GatherData, const FMergedMeshBuildData& BuildData);
+
+	// Removes least recently used entries above MaxEntries
+	void Trim(int32 MaxEntries);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MeshMergePrebakeCommandlet.generated.h"
+
+/**
+ * -run=MeshMergePrebake [-Manifest=/Game/Path/Manifest] [-OutputPath=/Game/MeshMerge/Prebaked]
+ * Merges every outfit of the manifest with the native kernel and current merge settings, saves the results as skeletal mesh
+ * assets and records them in the manifest. Manifest defaults to the one in settings. Atlased merges are skipped,
+ * their material instance is transient.
+ */
+UCLASS()
+class ASYNCCUSTOMISATION_API UMeshMergePrebakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMeshMergePrebakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
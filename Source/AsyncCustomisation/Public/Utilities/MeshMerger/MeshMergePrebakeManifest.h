@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Engine/DataAsset.h"
+#include "MeshMergePrebakeManifest.generated.h"
+
+class UMaterialInterface;
+class USkeletalMesh;
+class UStaticMesh;
+struct FMeshToMergeData;
+
+USTRUCT()
+struct FMeshMergePrebakeRigidPart
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
+
+	UPROPERTY(EditAnywhere)
+	FName SocketName;
+
+	// Relative to the socket
+	UPROPERTY(EditAnywhere)
+	FTransform RelativeTransform;
+};
+
+// Resolved part as UCustomizationComponent hands it to the merge, see FMeshToMergeData
+USTRUCT()
+struct FMeshMergePrebakePart
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftObjectPtr<USkeletalMesh> SkeletalMesh;
+
+	UPROPERTY(EditAnywhere)
+	FGameplayTag SlotTag;
+
+	// Skin material of the slot per source material, only matters with consolidation or atlasing
+	UPROPERTY(EditAnywhere)
+	TArray<TSoftObjectPtr<UMaterialInterface>> MaterialOverrides;
+
+	UPROPERTY(EditAnywhere)
+	TArray<FName> KeptSocketNames;
+
+	// Bits as in FSkinFlagCombination::FlagMask
+	UPROPERTY(EditAnywhere)
+	int32 CoveredSkinMask = 0;
+
+	UPROPERTY(EditAnywhere)
+	TArray<FMeshMergePrebakeRigidPart> RigidMeshes;
+};
+
+// Default skin of a somatotype or an NPC loadout, skin part first
+USTRUCT()
+struct FMeshMergePrebakeOutfit
+{
+	GENERATED_BODY()
+
+	// Names the baked mesh asset
+	UPROPERTY(EditAnywhere)
+	FName Name;
+
+	UPROPERTY(EditAnywhere)
+	TArray<FMeshMergePrebakePart> Parts;
+
+	// Loads the parts synchronously, empty if any part mesh is missing
+	TArray<FMeshToMergeData> LoadMeshesToMergeData() const;
+};
+
+USTRUCT()
+struct FMeshMergePrebakedMesh
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	FName OutfitName;
+
+	// MeshMergeUtilities::MakePrebakeKey of the outfit part set
+	UPROPERTY(VisibleAnywhere)
+	FString PartSetKey;
+
+	UPROPERTY(VisibleAnywhere)
+	TSoftObjectPtr<USkeletalMesh> Mesh;
+
+	// Material index -> slot, as BuildMaterialSlotMap fills it for a merge
+	UPROPERTY(VisibleAnywhere)
+	TMap<int32, FGameplayTag> MaterialSlotMap;
+
+	// MeshMergeUtilities::MakeMergeSettingsHash at bake time, entry is ignored under other merge settings
+	UPROPERTY(VisibleAnywhere)
+	uint32 MergeSettingsHash = 0;
+
+	// Vertex streams the baked mesh kept. Cooked runs can't tell which ones materials read, entries that stripped any are merged instead.
+	UPROPERTY(VisibleAnywhere)
+	uint32 MaxTexCoords = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	bool bStripVertexColors = true;
+};
+
+/**
+ * Outfits baked offline by the MeshMergePrebake commandlet. Part sets matching a baked one load its mesh instead of merging.
+ * Outfits are editor only, cooked manifest carries baked meshes as soft references. Entries of other merge settings are ignored, bake again after they change.
+ */
+UCLASS()
+class ASYNCCUSTOMISATION_API UMeshMergePrebakeManifest : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+	// Entries baked under other merge settings are not returned
+	const FMeshMergePrebakedMesh* FindBakedMesh(const FString& PartSetKey, uint32 MergeSettingsHash) const;
+
+	// Entries baked under other merge settings, logged once when the manifest is picked up
+	[[nodiscard]] int32 GetNumStaleBakedMeshes(uint32 MergeSettingsHash) const;
+
+	[[nodiscard]] const TArray<FMeshMergePrebakedMesh>& GetBakedMeshes() const { return BakedMeshes; }
+
+	void SetBakedMeshes(TArray<FMeshMergePrebakedMesh>&& InBakedMeshes);
+
+#if WITH_EDITORONLY_DATA
+	UPROPERTY(EditAnywhere, Category = "Prebake")
+	TArray<FMeshMergePrebakeOutfit> Outfits;
+#endif
+
+private:
+	void RebuildLookup();
+
+	UPROPERTY(VisibleAnywhere, Category = "Prebake")
+	TArray<FMeshMergePrebakedMesh> BakedMeshes;
+
+	// Part set key -> index in BakedMeshes
+	TMap<FString, int32> BakedMeshLookup;
+};
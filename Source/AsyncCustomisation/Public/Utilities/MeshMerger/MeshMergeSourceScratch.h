@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+
+/**
+ * Transient CPU readable copies of source LODs that don't keep their buffers on CPU. Copies are read back from the GPU buffers
+ * for a merge and held in a scratch pool bounded by the settings budget, so source meshes never need 'Allow CPU Access'.
+ * Game thread only, merges keep the copies they read alive through gather data.
+ */
+namespace MeshMergeSourceScratch
+{
+	using FScratchLODPtr = TSharedPtr<const FSkeletalMeshLODRenderData, ESPMode::ThreadSafe>;
+
+	struct FRequest
+	{
+		const USkeletalMesh* Mesh = nullptr;
+		const FSkeletalMeshLODRenderData* LODData = nullptr;
+
+		// Filled by AcquireCopies, nullptr if read back failed
+		FScratchLODPtr Copy;
+	};
+
+	// RHI can lock static GPU buffers for reading. Not on OpenGL, mobile feature levels or null RHI.
+	bool IsReadBackSupported();
+
+	// Transient copies are enabled in settings and the RHI can read them back
+	bool IsEnabled();
+
+	// [Game thread] Pooled copies are reused, missing ones are read back from the GPU in one render thread flush
+	void AcquireCopies(TArray<FRequest>& InOutRequests);
+
+	// [Game thread] Drops copies no merge reads, least recently used first, until the pool fits its budget
+	void Trim();
+
+	// [Game thread] Drops every copy no merge reads
+	void Empty();
+
+	// CPU bytes held by the scratch pool
+	int64 GetPooledBytes();
+
+	// CPU bytes of loaded source LODs keeping their buffers resident, merged meshes not included
+	int64 GetResidentMeshCPUBytes();
+}
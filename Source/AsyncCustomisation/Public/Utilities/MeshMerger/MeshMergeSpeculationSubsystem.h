@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Utilities/MeshMerger/MeshMergeSubsystem.h"
+#include "MeshMergeSpeculationSubsystem.generated.h"
+
+USTRUCT()
+struct FSpeculativeMerge
+{
+	GENERATED_BODY()
+
+	// nullptr while the merge runs
+	UPROPERTY()
+	TObjectPtr<USkeletalMesh> Mesh = nullptr;
+
+	int64 SizeBytes = 0;
+
+	// Component browsing the outfit, its commits count as hits or misses
+	TWeakObjectPtr<const UObject> Owner;
+
+	// Last time the outfit was hovered, older than the lifetime setting is stale
+	double LastRequestTime = 0.0;
+
+	// Commits that arrived while the merge was still running
+	TArray<FOnMeshMergeCompleteDelegate> Waiters;
+};
+
+/**
+ * Merges outfits players preview in the inventory at low priority, before they equip them.
+ * One speculation runs at a time, the newest hover replaces the one waiting to start. Finished ones are kept
+ * within the memory budget until equipped, hovered out of their lifetime or discarded by their owner.
+ */
+UCLASS()
+class ASYNCCUSTOMISATION_API UMeshMergeSpeculationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// nullptr if speculative merges are disabled
+	static UMeshMergeSpeculationSubsystem* Get(const UWorld* World);
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject implementation Begin
+	virtual UWorld* GetTickableGameObjectWorld() const override final { return GetWorld(); }
+	virtual bool IsAllowedToTick() const override final { return !IsTemplate(); };
+	virtual bool IsTickable() const override final { return !Speculations.IsEmpty(); };
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UMeshMergeSpeculationSubsystem, STATGROUP_Tickables); }
+	// FTickableGameObject implementation End
+
+	// Part set the owner will likely commit to next
+	void RequestSpeculativeMerge(const UObject* Owner, const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Called by MergeMeshesWithSettings. Returns true if the speculation of this part set takes the request,
+	// the delegate is executed with its mesh then or once its merge completes.
+	bool ClaimSpeculation(const FSkeletalMeshArrayKey& MergeKey, const FMeshMergeRequestParams& RequestParams, FOnMeshMergeCompleteDelegate& OnMeshMergeComplete);
+
+	// Owner stopped browsing, its unclaimed meshes are released
+	void DiscardSpeculations(const UObject* Owner);
+
+	[[nodiscard]] int64 GetSpeculativeBytes() const { return SpeculativeBytes; }
+	[[nodiscard]] int32 GetNumHits() const { return NumHits; }
+	[[nodiscard]] int32 GetNumMisses() const { return NumMisses; }
+
+	// Share of owners' commits a speculation took, 0 before the first commit
+	[[nodiscard]] float GetHitRate() const;
+
+	void LogStats() const;
+
+private:
+	void StartNextSpeculation();
+
+	void OnSpeculativeMergeCompleted(USkeletalMesh* MergedMesh, FSkeletalMeshArrayKey MergeKey);
+
+	void Discard(const FSkeletalMeshArrayKey& MergeKey);
+
+	// Oldest finished speculations go first
+	void DiscardToBudget(int64 BudgetBytes);
+
+	UPROPERTY()
+	TMap<FSkeletalMeshArrayKey, FSpeculativeMerge> Speculations;
+
+	// Part set waiting for the running speculation to finish
+	UPROPERTY()
+	TArray<FMeshToMergeData> NextMeshesToMergeData;
+
+	TWeakObjectPtr<const UObject> NextOwner;
+
+	TOptional<FSkeletalMeshArrayKey> RunningKey;
+
+	int64 SpeculativeBytes = 0;
+
+	int32 NumSpeculativeMerges = 0;
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+	int32 NumDiscarded = 0;
+};
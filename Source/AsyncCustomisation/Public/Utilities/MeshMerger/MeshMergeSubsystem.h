@@ -2,12 +2,45 @@
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
+#include "RenderCommandFence.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "Utilities/CustomizationSettings.h"
 #include "MeshMergeSubsystem.generated.h"
 
 struct FGameplayTag;
+struct FMeshMergePlan;
 class UAsyncSkeletalMeshMerge;
+class UMeshMergePrebakeManifest;
+class UMaterialInterface;
+class UStaticMesh;
+
+// Static accessory baked into the merged mesh, follows the bone of its socket
+USTRUCT()
+struct FRigidMeshToMergeData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UStaticMesh> StaticMesh = nullptr;
+
+	UPROPERTY()
+	FName SocketName;
+
+	// Relative to the socket
+	UPROPERTY()
+	FTransform RelativeTransform;
+
+	bool operator==(const FRigidMeshToMergeData& Other) const
+	{
+		return StaticMesh == Other.StaticMesh && SocketName == Other.SocketName && RelativeTransform.Equals(Other.RelativeTransform, 0.0);
+	}
+};
+
+FORCEINLINE uint32 GetTypeHash(const FRigidMeshToMergeData& Data)
+{
+	return HashCombine(GetTypeHash(Data.StaticMesh), GetTypeHash(Data.SocketName));
+}
 
 USTRUCT()
 struct FSkeletalMeshArrayKey
@@ -20,29 +53,70 @@ struct FSkeletalMeshArrayKey
 		: MeshArray(MoveTemp(InMeshArray))
 	{}
 	
+	FSkeletalMeshArrayKey(TArray<USkeletalMesh*>&& InMeshArray, TArray<int32>&& InMaterialRemap, TArray<FName>&& InKeptSocketNames = TArray<FName>(),
+		TArray<UMaterialInterface*>&& InAtlasMaterials = TArray<UMaterialInterface*>(), TArray<int32>&& InCulledRegionMasks = TArray<int32>(),
+		TArray<FRigidMeshToMergeData>&& InRigidMeshes = TArray<FRigidMeshToMergeData>())
+		: MeshArray(MoveTemp(InMeshArray))
+		, MaterialRemap(MoveTemp(InMaterialRemap))
+		, KeptSocketNames(MoveTemp(InKeptSocketNames))
+		, AtlasMaterials(MoveTemp(InAtlasMaterials))
+		, CulledRegionMasks(MoveTemp(InCulledRegionMasks))
+		, RigidMeshes(MoveTemp(InRigidMeshes))
+	{}
+	
 	FSkeletalMeshArrayKey(const FSkeletalMeshArrayKey& Other)
 		: MeshArray(Other.MeshArray)
+		, MaterialRemap(Other.MaterialRemap)
+		, KeptSocketNames(Other.KeptSocketNames)
+		, AtlasMaterials(Other.AtlasMaterials)
+		, CulledRegionMasks(Other.CulledRegionMasks)
+		, RigidMeshes(Other.RigidMeshes)
+		, MaxTexCoords(Other.MaxTexCoords)
+		, bStripVertexColors(Other.bStripVertexColors)
 	{}
 
 	FSkeletalMeshArrayKey(FSkeletalMeshArrayKey&& Other) noexcept
 		: MeshArray(MoveTemp(Other.MeshArray))
+		, MaterialRemap(MoveTemp(Other.MaterialRemap))
+		, KeptSocketNames(MoveTemp(Other.KeptSocketNames))
+		, AtlasMaterials(MoveTemp(Other.AtlasMaterials))
+		, CulledRegionMasks(MoveTemp(Other.CulledRegionMasks))
+		, RigidMeshes(MoveTemp(Other.RigidMeshes))
+		, MaxTexCoords(Other.MaxTexCoords)
+		, bStripVertexColors(Other.bStripVertexColors)
 	{}
 
 	FSkeletalMeshArrayKey& operator=(const FSkeletalMeshArrayKey& Other) noexcept
 	{
 		MeshArray = Other.MeshArray;
+		MaterialRemap = Other.MaterialRemap;
+		KeptSocketNames = Other.KeptSocketNames;
+		AtlasMaterials = Other.AtlasMaterials;
+		CulledRegionMasks = Other.CulledRegionMasks;
+		RigidMeshes = Other.RigidMeshes;
+		MaxTexCoords = Other.MaxTexCoords;
+		bStripVertexColors = Other.bStripVertexColors;
 		return *this;
 	}
 
 	FSkeletalMeshArrayKey& operator=(FSkeletalMeshArrayKey&& Other) noexcept
 	{
 		MeshArray = MoveTemp(Other.MeshArray);
+		MaterialRemap = MoveTemp(Other.MaterialRemap);
+		KeptSocketNames = MoveTemp(Other.KeptSocketNames);
+		AtlasMaterials = MoveTemp(Other.AtlasMaterials);
+		CulledRegionMasks = MoveTemp(Other.CulledRegionMasks);
+		RigidMeshes = MoveTemp(Other.RigidMeshes);
+		MaxTexCoords = Other.MaxTexCoords;
+		bStripVertexColors = Other.bStripVertexColors;
 		return *this;
 	}
 
 	bool operator==(const FSkeletalMeshArrayKey& Other) const
 	{
-		if (MeshArray.Num() != Other.MeshArray.Num())
+		if (MeshArray.Num() != Other.MeshArray.Num() || MaterialRemap != Other.MaterialRemap || KeptSocketNames != Other.KeptSocketNames
+			|| AtlasMaterials != Other.AtlasMaterials || CulledRegionMasks != Other.CulledRegionMasks || RigidMeshes != Other.RigidMeshes
+			|| MaxTexCoords != Other.MaxTexCoords || bStripVertexColors != Other.bStripVertexColors)
 		{
 			return false;
 		}
@@ -60,6 +134,33 @@ struct FSkeletalMeshArrayKey
 	
 	UPROPERTY()
 	TArray<USkeletalMesh*> MeshArray;
+
+	// Merged material index of every source material, only filled when materials are consolidated
+	UPROPERTY()
+	TArray<int32> MaterialRemap;
+
+	// Sockets whose bones survive pruning, sorted, only filled when bones are pruned
+	UPROPERTY()
+	TArray<FName> KeptSocketNames;
+
+	// Resolved materials baked into the atlas, only filled when materials are atlased
+	UPROPERTY()
+	TArray<UMaterialInterface*> AtlasMaterials;
+
+	// Skin regions dropped per mesh, only filled when covered skin is culled
+	UPROPERTY()
+	TArray<int32> CulledRegionMasks;
+
+	// Baked accessories of all parts
+	UPROPERTY()
+	TArray<FRigidMeshToMergeData> RigidMeshes;
+
+	// Vertex streams the resolved part materials read, only set when the memory optimizer is on. Skins reading other streams take another merge.
+	UPROPERTY()
+	uint32 MaxTexCoords = MAX_uint32;
+
+	UPROPERTY()
+	bool bStripVertexColors = false;
 };
 
 USTRUCT()
@@ -72,6 +173,23 @@ struct FMeshToMergeData
 
 	UPROPERTY()
 	FGameplayTag SlotTag;
+
+	// Material each source material resolves to after skins are applied, nullptr keeps the mesh material.
+	// Only used to consolidate sections and pick atlas textures, merged mesh itself keeps mesh materials.
+	UPROPERTY()
+	TArray<TObjectPtr<UMaterialInterface>> MaterialOverrides;
+
+	// Sockets something attaches to on the merged mesh, their bones survive bone pruning
+	UPROPERTY()
+	TArray<FName> KeptSocketNames;
+
+	// Skin regions covered by other parts, bits as in FSkinFlagCombination::FlagMask. Authored skin triangles of them are dropped.
+	UPROPERTY()
+	int32 CoveredSkinMask = 0;
+
+	// Accessories baked into the merged mesh instead of spawned as actors
+	UPROPERTY()
+	TArray<FRigidMeshToMergeData> RigidMeshes;
 };
 
 FORCEINLINE uint32 GetTypeHash(const FSkeletalMeshArrayKey& Key)
@@ -83,11 +201,97 @@ FORCEINLINE uint32 GetTypeHash(const FSkeletalMeshArrayKey& Key)
 		Hash = HashCombine(Hash, GetTypeHash(Mesh));
 	}
 
+	for (const int32 MaterialIndex : Key.MaterialRemap)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(MaterialIndex));
+	}
+
+	for (const FName& SocketName : Key.KeptSocketNames)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(SocketName));
+	}
+
+	for (const UMaterialInterface* Material : Key.AtlasMaterials)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Material));
+	}
+
+	for (const int32 CulledRegionMask : Key.CulledRegionMasks)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(CulledRegionMask));
+	}
+
+	for (const FRigidMeshToMergeData& RigidMesh : Key.RigidMeshes)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(RigidMesh));
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(Key.MaxTexCoords));
+	Hash = HashCombine(Hash, GetTypeHash(Key.bStripVertexColors));
 	return Hash;
 }
 
 DECLARE_DELEGATE_OneParam(FOnMeshMergeCompleteDelegate, USkeletalMesh*);
 
+UENUM()
+enum class EMeshMergePriority : uint8
+{
+	Low,
+	Normal,
+	// Locally controlled characters
+	High
+};
+
+struct FMeshMergeRequestParams
+{
+	// Newer request of the same requester supersedes its queued or in-flight one, the older completion is never executed
+	const UObject* Requester = nullptr;
+
+	EMeshMergePriority Priority = EMeshMergePriority::Normal;
+
+	// Merged mesh the result replaces, parts both share are copied from it instead of rebuilt
+	const USkeletalMesh* PreviousMergedMesh = nullptr;
+};
+
+USTRUCT()
+struct FMeshMergeJob
+{
+	GENERATED_BODY()
+
+	// Normalized part set, keeps source meshes alive while the job waits in the queue
+	UPROPERTY()
+	TArray<FMeshToMergeData> MeshesToMergeData;
+
+	TWeakObjectPtr<const UObject> Requester;
+
+	EMeshMergePriority Priority = EMeshMergePriority::Normal;
+
+	TWeakObjectPtr<const USkeletalMesh> PreviousMergedMesh;
+
+	FOnMeshMergeCompleteDelegate OnMeshMergeComplete;
+
+	double EnqueueTime = 0.0;
+};
+
+struct FCachedMergePlan
+{
+	TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> Plan;
+
+	double LastUseTime = 0.0;
+};
+
+USTRUCT()
+struct FPendingMeshRelease
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<USkeletalMesh> Mesh = nullptr;
+
+	// Passed once render thread has released the mesh resources
+	TSharedPtr<FRenderCommandFence> ReleaseFence;
+};
+
 UCLASS()
 class ASYNCCUSTOMISATION_API UMeshMergeSubsystem : public UWorldSubsystem, public FTickableGameObject
 {
@@ -95,6 +299,7 @@ class ASYNCCUSTOMISATION_API UMeshMergeSubsystem : public UWorldSubsystem, publi
 
 public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 
 	// FTickableGameObject implementation Begin
 	virtual UWorld* GetTickableGameObjectWorld() const override final { return GetWorld(); }
@@ -104,13 +309,95 @@ public:
 	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UMeshMergeSubsystem, STATGROUP_Tickables);  }
 	// FTickableGameObject implementation End
 
-	static bool MergeMeshesWithSettings(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete);
+	static bool MergeMeshesWithSettings(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete,
+		const FMeshMergeRequestParams& RequestParams = FMeshMergeRequestParams());
+
+	// Drops queued and in-flight merges of the requester, their completion delegates are not executed
+	static void CancelMergeRequest(const UWorld* World, const UObject* Requester);
+
+	// Moves queued merge of the requester up to the priority, never down
+	static void RaiseMergePriority(const UWorld* World, const UObject* Requester, EMeshMergePriority Priority);
+
+	[[nodiscard]] int32 GetNumQueuedJobs() const { return QueuedJobs.Num(); }
+
+	// Caller starts showing a merged mesh, it is not recycled until every user released it
+	static void RetainMergedMesh(const UWorld* World, USkeletalMesh* MergedMesh);
+
+	// Hands back a merged mesh the caller retained and no longer shows. Once its last user is gone render resources are
+	// released right away and the object is reused by a later merge. Meshes still cached are left alone.
+	static void ReleaseMergedMesh(const UWorld* World, USkeletalMesh* MergedMesh);
+
+	// Merge result nobody retained, e.g. of a superseded or discarded request. Recycled unless cached or retained by someone.
+	static void DiscardMergedMesh(const UWorld* World, USkeletalMesh* MergedMesh);
+
+	// Emptied mesh object to create the next merged mesh in, nullptr if the pool is empty
+	static USkeletalMesh* AcquirePooledMesh(const UWorld* World);
+
+	[[nodiscard]] int32 GetNumPooledMeshes() const { return PooledMeshes.Num(); }
+
+	// Topology of the part set, compiled once and shared by every later merge of it. Part sets that can't be merged natively are cached
+	// as plans with bFailed set. nullptr only without a subsystem or with plan caching disabled.
+	static TSharedPtr<const FMeshMergePlan, ESPMode::ThreadSafe> FindOrCompileMergePlan(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	[[nodiscard]] int32 GetNumMergePlans() const { return MergePlans.Num(); }
 
 private:
 	static EMeshMergeMethod GetCurrentMergeMethod();
+
+	void EnqueueJob(FMeshMergeJob&& Job);
+
+	// Tags the request as the newest of its requester, the returned delegate drops the result once a newer request or a cancel came in
+	FOnMeshMergeCompleteDelegate TagRequest(const UObject* Requester, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete);
+
+	// Drops serials of destroyed requesters
+	void PruneRequestSerials();
+
+	// Starts recycling a merged mesh nothing uses any more
+	void RecycleMergedMesh(USkeletalMesh* MergedMesh);
+
+	// Moves released meshes to the pool once render thread is done with them and no merge reads their buffers
+	void UpdatePendingReleases();
+
+	// Runs queued jobs by priority until the frame budget is spent, at least one job per frame
+	void ProcessQueuedJobs(double BudgetSeconds);
+
+	static bool ExecuteMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete, const USkeletalMesh* PreviousMergedMesh = nullptr);
 	
-	static bool SyncMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete);
-	
-	// UPROPERTY()
-	// TMap<FSkeletalMeshArrayKey, USkeletalMesh*> CachedMeshes;
+	static bool SyncMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete, const USkeletalMesh* PreviousMergedMesh = nullptr);
+
+	// Hands out the mesh baked for this part set once it is loaded, false if the manifest has none
+	static bool LoadPrebakedMesh(const UWorld* World, const UMeshMergePrebakeManifest& Manifest, const FSkeletalMeshArrayKey& MergeKey,
+		const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>* OutMaterialMap, FOnMeshMergeCompleteDelegate& OnMeshMergeComplete);
+
+	// Creates merged mesh from the on-disk cache entry of this part set, nullptr on miss
+	static USkeletalMesh* LoadFromDiskCache(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Completion delegate is executed from Tick of the world's subsystem once the merged mesh is ready
+	static bool AsyncMerge(const UWorld* World, const TArray<FMeshToMergeData>& MeshesToMergeData, FOnMeshMergeCompleteDelegate&& OnMeshMergeComplete, const USkeletalMesh* PreviousMergedMesh = nullptr);
+
+	UPROPERTY()
+	TArray<TObjectPtr<UAsyncSkeletalMeshMerge>> ActiveAsyncMerges;
+
+	UPROPERTY()
+	TArray<FMeshMergeJob> QueuedJobs;
+
+	// Serial of the newest request of every requester with a merge queued or in flight
+	TMap<TObjectKey<UObject>, uint32> LatestRequestSerials;
+	uint32 NextRequestSerial = 0;
+
+	UPROPERTY()
+	TArray<FPendingMeshRelease> PendingReleases;
+
+	UPROPERTY()
+	TArray<TObjectPtr<USkeletalMesh>> PooledMeshes;
+
+	// Components of this world showing each merged mesh
+	TMap<TObjectKey<USkeletalMesh>, int32> MergedMeshUsers;
+
+	// Loaded with the world, merges never wait for it
+	UPROPERTY()
+	TObjectPtr<const UMeshMergePrebakeManifest> PrebakeManifest;
+
+	// Plans don't keep their meshes alive, stale ones are recompiled on use. Least recently used are dropped above the settings limit.
+	TMap<FSkeletalMeshArrayKey, FCachedMergePlan> MergePlans;
 };
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "ReferenceSkeleton.h"
+#include "Engine/SkeletalMesh.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+class UTexture2D;
+struct FStaticMeshLODResources;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMeshMerge, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("MeshMerge"), STATGROUP_MeshMerge, STATCAT_Advanced);
+
+// Triangles of one source section left out of the merge
+struct FMeshMergeCulledRange
+{
+	// Merged LOD
+	int32 LODIndex = 0;
+	int32 SectionIndex = 0;
+	int32 FirstTriangle = 0;
+	int32 NumTriangles = 0;
+};
+
+/**
+ * One source mesh prepared for merging.
+ * Filled on the game thread in phase 1, read-only for the worker in phase 2.
+ */
+struct FMeshMergeSource
+{
+	// Kept alive by the owner of the merge for the whole merge duration
+	const USkeletalMesh* Mesh = nullptr;
+
+	FGameplayTag SlotTag;
+
+	// Source material index -> merged material index
+	TArray<int32> MaterialRemap;
+
+	// Source ref skeleton bone index -> merged ref skeleton bone index
+	TArray<FBoneIndexType> BoneRemap;
+
+	// Render data of every LOD taking part in the merge
+	TArray<const FSkeletalMeshLODRenderData*> LODs;
+
+	// [LOD][Section] merged material index, LODMaterialMap already applied
+	TArray<TArray<int32>> SectionMaterials;
+
+	// Source material index -> atlas entry, INDEX_NONE if the material keeps its own texture
+	TArray<int32> MaterialAtlasEntries;
+
+	// [LOD][Section] atlas entry whose tile the section UVs are moved to
+	TArray<TArray<int32>> SectionAtlasEntries;
+
+	// Skin regions dropped from this part, bits as in FSkinFlagCombination::FlagMask
+	int32 CulledRegionMask = 0;
+
+	// Authored triangle ranges of the dropped regions
+	TArray<FMeshMergeCulledRange> CulledRanges;
+};
+
+// Static accessory skinned rigidly to one bone of the merged skeleton
+struct FMeshMergeRigidSource
+{
+	const UStaticMesh* Mesh = nullptr;
+
+	// [Merged LOD]
+	TArray<const FStaticMeshLODResources*, TInlineAllocator<4>> LODs;
+
+	// Merged bone the accessory follows
+	FBoneIndexType BoneIndex = 0;
+
+	// Mesh space to ref pose component space of the merged mesh
+	FMatrix44f MeshToComponent = FMatrix44f::Identity;
+
+	// Merged material index of every static material
+	TArray<int32> MaterialRemap;
+};
+
+// Texture of one part material packed into the atlas
+struct FMeshMergeAtlasEntry
+{
+	// Kept alive by materials of the merged parts
+	UMaterialInterface* Material = nullptr;
+	const UTexture2D* Texture = nullptr;
+
+	int32 MipIndex = 0;
+
+	// Texels, block aligned
+	FIntPoint Size = FIntPoint::ZeroValue;
+	FIntPoint Offset = FIntPoint::ZeroValue;
+
+	// Tile in atlas UV space
+	FBox2f UVRect = FBox2f(ForceInit);
+
+	// Tiles don't repeat, entries are only planned for parts keeping UV0 in 0-1
+	FVector2f RemapUV(const FVector2f& UV) const
+	{
+		return UVRect.Min + UV * UVRect.GetSize();
+	}
+};
+
+/**
+ * Which part textures share one atlas and where. Depends only on the part materials, so every merge of a part set plans the same atlas.
+ */
+struct FMeshMergeAtlasPlan
+{
+	TArray<FMeshMergeAtlasEntry> Entries;
+
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	EPixelFormat PixelFormat = PF_Unknown;
+
+	bool bSRGB = true;
+
+	// Atlas mips built from the entry mip chains
+	int32 NumMips = 1;
+
+	int32 FindEntry(const UMaterialInterface* Material) const
+	{
+		return Material ? Entries.IndexOfByPredicate([Material](const FMeshMergeAtlasEntry& Entry) { return Entry.Material == Material; }) : INDEX_NONE;
+	}
+
+	bool IsEmpty() const { return Entries.IsEmpty(); }
+};
+
+// Vertex and index range one part occupies in one merged LOD
+struct FMergedPartRange
+{
+	uint32 FirstVertex = 0;
+	uint32 NumVertices = 0;
+	uint32 FirstIndex = 0;
+	uint32 NumIndices = 0;
+};
+
+/**
+ * Where every part of a merged mesh lives in its buffers. Only kept for meshes with sections 1:1 to source sections,
+ * so a part range can be copied into the next merge as is.
+ */
+struct FMergedMeshLayout
+{
+	struct FPart
+	{
+		TWeakObjectPtr<const USkeletalMesh> Mesh;
+
+		FGameplayTag SlotTag;
+
+		// Same mesh with other regions culled has other geometry
+		int32 CulledRegionMask = 0;
+
+		// [Merged LOD]
+		TArray<FMergedPartRange> LODs;
+	};
+
+	// Source LOD of merged LOD 0
+	int32 FirstLODIndex = 0;
+
+	TArray<FPart> Parts;
+};
+
+/**
+ * Topology of one part set: merged ref skeleton, bone remaps, resident LOD range and section materials before skins.
+ * Nothing in it depends on materials, so merges that only change skins reuse it. Compiled on the game thread, read-only afterwards.
+ */
+struct FMeshMergePlan
+{
+	struct FSource
+	{
+		TWeakObjectPtr<const USkeletalMesh> Mesh;
+
+		// Source ref skeleton bone index -> merged ref skeleton bone index
+		TArray<FBoneIndexType> BoneRemap;
+
+		// [LOD][Section] source material index, LODMaterialMap already applied
+		TArray<TArray<int32>> SectionMaterials;
+	};
+
+	// Valid parts in merge order
+	TArray<FSource> Sources;
+
+	// Pruned when bone pruning is enabled
+	FReferenceSkeleton RefSkeleton;
+
+	// Base mesh settings of every merged LOD, without LODMaterialMap
+	TArray<FSkeletalMeshLODInfo> LODInfos;
+
+	int32 NumLODs = 0;
+
+	// Source LOD of merged LOD 0. Streaming another first LOD in or out makes the plan stale.
+	int32 FirstLODIndex = 0;
+
+	// Compile failed for these sources and resident LODs. Only Sources and the LOD range are set, merges fail without compiling again.
+	bool bFailed = false;
+};
+
+/**
+ * Phase 1 output. Everything the worker needs to build merged buffers without touching UObjects.
+ */
+struct FMeshMergeGatherData
+{
+	TArray<FMeshMergeSource> Sources;
+
+	// Baked accessories, their sections follow all source sections
+	TArray<FMeshMergeRigidSource> RigidSources;
+
+	FReferenceSkeleton RefSkeleton;
+
+	TArray<FSkeletalMaterial> Materials;
+
+	TArray<FSkeletalMeshLODInfo> LODInfos;
+
+	FBoxSphereBounds Bounds = FBoxSphereBounds(ForceInit);
+
+	int32 NumLODs = 0;
+
+	// Source LOD of merged LOD 0
+	int32 FirstLODIndex = 0;
+
+	// Keep CPU copies of the merged buffers after the render resources are created
+	bool bAllowCPUAccess = false;
+
+	// Sections sharing a merged material are merged into one while bone limit allows
+	bool bConsolidateSections = false;
+
+	int32 MaxBonesPerSection = MAX_int32;
+
+	// Triangles of every merged section are reordered for the post-transform vertex cache
+	bool bOptimizeVertexCache = false;
+
+	// Memory optimizer: UV channels past the highest one merged materials sample are not merged
+	uint32 MaxTexCoords = MAX_uint32;
+
+	// Memory optimizer: merged materials don't read vertex colors
+	bool bStripVertexColors = false;
+
+	// Memory optimizer: full precision UVs are halved when no UV moves further, 0 keeps source precision
+	float MaxHalfUVError = 0.f;
+
+	// Merged material index -> slot of the part that owns it
+	TMap<int32, FGameplayTag> MaterialSlotMap;
+
+	// Disk cache entry of this part set, empty if disk cache is not used
+	FString DiskCacheFingerprint;
+
+	// Part textures packed into one, rendered with one material instance at AtlasMaterialIndex
+	FMeshMergeAtlasPlan AtlasPlan;
+
+	int32 AtlasMaterialIndex = INDEX_NONE;
+
+	// Merged mesh being replaced. Ranges of parts it shares with this merge are copied from its buffers.
+	TSharedPtr<const FMergedMeshLayout, ESPMode::ThreadSafe> PreviousLayout;
+
+	// [Previous merged LOD] CPU accessible render data, kept alive by the owner of the merge
+	TArray<const FSkeletalMeshLODRenderData*> PreviousLODs;
+
+	// [Source LOD] Transient CPU copies Sources read instead of LODs without CPU access, see MeshMergeSourceScratch
+	TArray<TSharedPtr<const FSkeletalMeshLODRenderData, ESPMode::ThreadSafe>> ScratchLODs;
+};
+
+/**
+ * Phase 2 output. Render-ready LOD buffers, handed over to the merged mesh in phase 3.
+ */
+struct FMergedMeshBuildData
+{
+	TArray<TUniquePtr<FSkeletalMeshLODRenderData>> LODs;
+
+	// [Atlas mip] Texels in the atlas plan pixel format, empty without atlas
+	TArray<TArray64<uint8>> AtlasMips;
+
+	// Vertex buffer bytes the memory optimizer saved over all LODs
+	int64 NumSavedBytes = 0;
+
+	bool bSucceeded = false;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/MeshMerger/MeshMergeTypes.h"
+
+struct FMeshToMergeData;
+struct FRigidMeshToMergeData;
+struct FSkeletalMeshArrayKey;
+class UMaterialInterface;
+class USkeleton;
+class UStaticMesh;
+
+namespace MeshMergeUtilities
+{
+	// Render data keeps CPU copies of its vertex data only when the LOD allows CPU access
+	bool HasCPUAccess(const FSkeletalMeshLODRenderData& LODData);
+
+	// Every part shares one skeleton and bone weight precision, and its resident LODs are readable on CPU
+	bool CanMergeNatively(const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Native kernel is preferred over FSkeletalMeshMerge in settings
+	bool ShouldUseNativeMergeKernel();
+
+	// Same part set in any order produces the same merge. Base mesh stays first, it defines LOD settings of the merged mesh.
+	void NormalizeMergeOrder(TArray<FMeshToMergeData>& InOutMeshesToMergeData);
+
+	// Cache key of normalized part set
+	FSkeletalMeshArrayKey MakeMergeKey(const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Merge key by asset paths, stable across editor and cooked runs. Matches part sets to pre-baked meshes.
+	// Stream usage is left out, it is only derived in the editor; baked meshes keep every stream instead.
+	FString MakePrebakeKey(const FSkeletalMeshArrayKey& MergeKey);
+
+	// Settings that change what a merge of the same part set produces, pre-baked meshes of other settings are not used
+	uint32 MakeMergeSettingsHash();
+
+	// Section consolidation is enabled in settings
+	bool ShouldConsolidateMaterials();
+
+	// Atlasing is enabled in settings and has a parent material
+	bool ShouldAtlasMaterials();
+
+	// Bone pruning is enabled in settings
+	bool ShouldPruneBones();
+
+	// Vertex cache optimization of merged sections is enabled in settings
+	bool ShouldOptimizeVertexCache();
+
+	// Merged mesh memory optimizer is enabled in settings
+	bool ShouldOptimizeMeshMemory();
+
+	// Covered skin culling is enabled in settings
+	bool ShouldCullCoveredSkin();
+
+	// Skin regions culled from the part: covered ones that have authored triangles, 0 if culling is disabled
+	int32 GetCulledRegionMask(const FMeshToMergeData& Data);
+
+	// Accessory baking is enabled in settings
+	bool ShouldBakeRigidAccessories();
+
+	// Accessory baking is enabled and the mesh keeps CPU copies of its buffers
+	bool CanBakeRigidMesh(const UStaticMesh* StaticMesh);
+
+	// Baked accessories of all parts in part order
+	TArray<FRigidMeshToMergeData> CollectRigidMeshes(const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Sorted unique sockets kept by all parts
+	TArray<FName> CollectKeptSocketNames(const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Material the source material renders with, override first
+	UMaterialInterface* GetResolvedMaterial(const FMeshToMergeData& Data, int32 MaterialIndex);
+
+	// [Source][Material] merged material index, aligned with MeshesToMergeData. Returns number of merged materials.
+	// Sources are concatenated in order, with consolidation materials resolving to the same one share an index.
+	// Atlased materials all share the atlas material index. Atlas is planned here unless given.
+	int32 BuildMaterialRemap(const TArray<FMeshToMergeData>& MeshesToMergeData, TArray<TArray<int32>>& OutMaterialRemap,
+		int32* OutAtlasMaterialIndex = nullptr, const FMeshMergeAtlasPlan* AtlasPlan = nullptr);
+
+	// Material index in merged mesh -> slot of the part that owns it. Atlas material belongs to no slot, skins are baked into it.
+	void BuildMaterialSlotMap(const TArray<FMeshToMergeData>& MeshesToMergeData, TMap<int32, FGameplayTag>& OutMaterialMap);
+
+	// Key of the merge plan of a part set: its meshes and, with pruning, sockets whose bones are kept. Skins are not part of it.
+	FSkeletalMeshArrayKey MakeMergePlanKey(const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// Plan was compiled for these meshes and their resident LODs haven't changed since
+	bool IsMergePlanValid(const FMeshMergePlan& Plan, const TArray<FMeshToMergeData>& MeshesToMergeData);
+
+	// [Game thread] Validates sources, builds merged ref skeleton, bone remaps and LOD resolved section materials.
+	// On failure OutPlan is a failed plan of the sources, cached like any other so the error is logged once.
+	bool CompileMergePlan(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergePlan& OutPlan);
+
+	// [Phase 1, game thread] Maps materials and collects render data of the sources. Topology is taken from Plan, compiled on the spot without a valid one.
+	// Parts shared with PreviousMergedMesh are copied from it in phase 2, caller keeps it alive until then.
+	bool GatherMergeData(const TArray<FMeshToMergeData>& MeshesToMergeData, FMeshMergeGatherData& OutGatherData, const USkeletalMesh* PreviousMergedMesh = nullptr,
+		const FMeshMergePlan* Plan = nullptr);
+
+	// [Phase 1, game thread] Points source LODs without CPU access at transient copies read back from the GPU. Only merges that build buffers need it,
+	// disk cache lookups and hits read nothing but counts.
+	bool AcquireSourceCopies(FMeshMergeGatherData& InOutGatherData);
+
+	// [Phase 2, any thread] Builds vertex, index and skin weight buffers of one merged LOD
+	bool BuildMergedLOD(const FMeshMergeGatherData& GatherData, int32 LODIndex, FSkeletalMeshLODRenderData& OutLODData, int64* OutNumSavedBytes = nullptr);
+
+	// [Phase 2, any thread] Builds every merged LOD and the atlas, in parallel tasks when enabled in settings
+	void BuildMergedMeshData(const FMeshMergeGatherData& GatherData, FMergedMeshBuildData& OutBuildData);
+
+	// [Phase 3, game thread] Creates the transient USkeletalMesh owning the built LODs and initializes its render resources.
+	// Pooled mesh object is filled instead of a new one when given.
+	USkeletalMesh* CreateMergedMesh(const FMeshMergeGatherData& GatherData, FMergedMeshBuildData& BuildData, USkeleton* Skeleton, USkeletalMesh* PooledMesh = nullptr);
+
+	// All three phases on the calling game thread
+	USkeletalMesh* MergeImmediate(const TArray<FMeshToMergeData>& MeshesToMergeData, const USkeletalMesh* PreviousMergedMesh = nullptr, USkeletalMesh* PooledMesh = nullptr,
+		const FMeshMergePlan* Plan = nullptr);
+
+	// Merged mesh keeps its part layout, next merge can copy unchanged parts from it
+	bool CanMergeIncrementally(const USkeletalMesh* PreviousMergedMesh);
+}
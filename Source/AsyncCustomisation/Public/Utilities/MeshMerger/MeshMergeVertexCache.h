@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Triangle order of merged sections for the post-transform vertex cache. Parts come in with their own index order,
+ * reordering inside a section keeps its vertex and index ranges, so part layout stays valid.
+ */
+namespace MeshMergeVertexCache
+{
+	// FIFO cache size ACMR is measured against
+	constexpr int32 DefaultCacheSize = 16;
+
+	// Average vertex cache misses per triangle of a FIFO cache. 3 means no reuse, well ordered meshes get below 1.
+	float ComputeACMR(TConstArrayView<uint32> Indices, int32 CacheSize = DefaultCacheSize);
+
+	// [Any thread] Reorders triangles of one section with Forsyth's linear-speed algorithm. Indices reference [FirstVertex, FirstVertex + NumVertices).
+	void OptimizeTriangleOrder(TArrayView<uint32> Indices, uint32 FirstVertex, uint32 NumVertices);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Core/Data.h"
+#include "Engine/AssetUserData.h"
+#include "SkinCoverageUserData.generated.h"
+
+// Triangles of one skin section lying under clothing of a region
+USTRUCT(BlueprintType)
+struct FSkinCoverageRegion
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	ESkinVisibilityFlag Region = ESkinVisibilityFlag::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 LODIndex = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 SectionIndex = 0;
+
+	// Relative to the section
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 FirstTriangle = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 NumTriangles = 0;
+};
+
+/**
+ * Authored on a body skin mesh. Merge drops the triangles of regions covered by the equipped parts.
+ */
+UCLASS(BlueprintType)
+class ASYNCCUSTOMISATION_API USkinCoverageUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	static const USkinCoverageUserData* Find(const USkeletalMesh* SkinMesh)
+	{
+		return SkinMesh ? const_cast<USkeletalMesh*>(SkinMesh)->GetAssetUserData<USkinCoverageUserData>() : nullptr;
+	}
+
+	// Regions with authored triangles, bits as in FSkinFlagCombination::FlagMask
+	int32 GetRegionMask() const
+	{
+		FSkinFlagCombination RegionFlags;
+		for (const FSkinCoverageRegion& Region : Regions)
+		{
+			RegionFlags.AddFlag(Region.Region);
+		}
+		return RegionFlags.FlagMask;
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TArray<FSkinCoverageRegion> Regions;
+};
@@ -61,9 +61,18 @@ public:
 	
 	UFUNCTION(BlueprintPure, Category = "InventoryConversion", meta=(DisplayName="CloakMapConverter", CompactNodeTitle="CloakMapConverter"))
 	static FInventoryEquippedItemData ConvertEquippedMapCloak(const TMap<FGameplayTag, FInventoryEquippedItemData>& InMap);
+
+	// Customization states store item handles, Blueprint gets their slugs
+	UFUNCTION(BlueprintPure, Category = "Customization")
+	static TMap<FGameplayTag, FName> GetEquippedBodyPartSlugs(const FCustomizationContextData& State);
+
+	UFUNCTION(BlueprintPure, Category = "Customization")
+	static TMap<FGameplayTag, FName> GetEquippedMaterialSlugs(const FCustomizationContextData& State);
 	
 
 private:	
 	static FInventoryEquippedItemData GetItemFromEquippedMapByTagInternal(const TMap<FGameplayTag, FInventoryEquippedItemData>& InMap, const FGameplayTag& SlotTag);
 
+	static TMap<FGameplayTag, FName> GetSlugsInternal(const TMap<FGameplayTag, FCustomizationItemHandle>& InMap);
+
 };